@@ -0,0 +1,136 @@
+#include <chrono>
+#include <cstdlib>
+using namespace std;
+#include "batch.h"
+#include "functions.h"
+#include "notation.h"
+
+// taille des blocs de résultats écrits d'un coup
+static const size_t BATCH_OUTPUT_BLOCK = 1 << 16;
+
+// passe les blancs puis renvoie la fin du mot suivant
+static const char* nextToken(const char*& aText)
+{
+    while (*aText == ' ' || *aText == '\t' || *aText == '\r')
+        aText++;
+    const char* end = aText;
+    while (*end != '\0' && *end != ' ' && *end != '\t' && *end != '\r')
+        end++;
+    return end;
+}
+
+static BatchStatus endGame(BatchResult& aResult, BatchStatus aStatus, const char* aToken, const char* aEnd)
+{
+    aResult.itsStatus = aStatus;
+    aResult.itsDetail.assign(aToken, aEnd);
+    return aStatus;
+}
+
+BatchStatus playBatchGame(const string& aLine, Game& aGame, BatchResult& aResult)
+{
+    aResult.itsPlies = 0;
+    const char* text = aLine.c_str();
+    const char* end = nextToken(text);
+    char* sizeEnd;
+    long size = strtol(text, &sizeEnd, 10);
+    if (sizeEnd != end || (size != LITTLE && size != BIG))
+        return endGame(aResult, BATCH_INVALID, text, end);
+
+    // noms des joueurs
+    text = end;
+    end = nextToken(text);
+    if (text == end)
+        return endGame(aResult, BATCH_INVALID, text, end);
+    aGame.itsPlayer1.itsName.assign(text, end);
+    text = end;
+    end = nextToken(text);
+    if (text == end)
+        return endGame(aResult, BATCH_INVALID, text, end);
+    aGame.itsPlayer2.itsName.assign(text, end);
+
+    // plateau gardé d'une partie à l'autre tant que la taille ne change pas
+    if (aGame.itsBoard.itsCells != nullptr && aGame.itsBoard.itsSize != size)
+        deleteBoard(aGame.itsBoard);
+    if (aGame.itsBoard.itsCells == nullptr) {
+        aGame.itsBoard.itsSize = BoardSize(size);
+        if (!createBoard(aGame.itsBoard))
+            return endGame(aResult, BATCH_INVALID, text, text);
+    }
+    initializeBoard(aGame.itsBoard);
+    aGame.itsPlayer1.itsRole = ATTACK;
+    aGame.itsPlayer2.itsRole = DEFENSE;
+    aGame.itsCurrentPlayer = &aGame.itsPlayer1;
+
+    // mêmes règles que la boucle de itsGame
+    bool finished = false;
+    for (text = end, end = nextToken(text); text != end; text = end, end = nextToken(text)) {
+        Move move;
+        const char* moveEnd;
+        if (!parseMove(text, aGame.itsBoard, move, &moveEnd) || moveEnd != end)
+            return endGame(aResult, BATCH_INVALID, text, end);
+        if (finished || !isValidMovement(aGame, move))
+            return endGame(aResult, BATCH_ILLEGAL, text, end);
+        movePiece(aGame, move);
+        capturePieces(aGame, move);
+        switchCurrentPlayer(aGame);
+        aResult.itsPlies++;
+        finished = isGameFinished(aGame);
+    }
+
+    if (!finished) {
+        aResult.itsStatus = BATCH_UNFINISHED;
+        aResult.itsDetail = "-";
+        return BATCH_UNFINISHED;
+    }
+    const Player* winner = whoWon(aGame);
+    aResult.itsStatus = BATCH_FINISHED;
+    aResult.itsWinnerRole = winner->itsRole;
+    aResult.itsDetail = winner->itsName;
+    return BATCH_FINISHED;
+}
+
+void formatBatchResult(uint64_t aNumber, const BatchResult& aResult, string& aText)
+{
+    static const char* const STATUS[4] = {"victoire", "inachevee", "illegal", "invalide"};
+    aText += to_string(aNumber);
+    aText += ' ';
+    aText += STATUS[aResult.itsStatus];
+    aText += ' ';
+    aText += to_string(aResult.itsPlies);
+    aText += ' ';
+    aText += aResult.itsDetail;
+    if (aResult.itsStatus == BATCH_FINISHED)
+        aText += (aResult.itsWinnerRole == ATTACK) ? " attaque" : " defense";
+    aText += '\n';
+}
+
+void runBatch(istream& aInput, ostream& aOutput, BatchReport& aReport)
+{
+    auto start = chrono::steady_clock::now();
+    aReport = BatchReport();
+    Game game;
+    BatchResult result;
+    string line;
+    string output;
+    output.reserve(BATCH_OUTPUT_BLOCK + 256);
+
+    while (getline(aInput, line)) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == string::npos || line[first] == '#')
+            continue;
+        playBatchGame(line, game, result);
+        aReport.itsGames++;
+        aReport.itsCounts[result.itsStatus]++;
+        formatBatchResult(aReport.itsGames, result, output);
+        if (output.size() >= BATCH_OUTPUT_BLOCK) {
+            aOutput.write(output.data(), output.size());
+            output.clear();
+        }
+    }
+    aOutput.write(output.data(), output.size());
+    aOutput.flush();
+
+    if (game.itsBoard.itsCells != nullptr)
+        deleteBoard(game.itsBoard);
+    aReport.itsSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,93 @@
+/**
+ * @file batch.h
+ *
+ * @brief Non-interactive mode: replays a stream of games written as text, one result line per game.
+ *
+ * Each line of the input holds one game: the board size (11 or 13), the names of player 1 and
+ * player 2, then the moves in compact notation ("a4-c4"), all separated by spaces. Empty lines
+ * and lines starting with '#' are skipped. Every game starts from `initializeBoard` with player 1
+ * (the attacker) to move, and its moves go through the rule functions of `itsGame`
+ * (`isValidMovement`, `movePiece`, `capturePieces`, `switchCurrentPlayer`, `isGameFinished`,
+ * `whoWon`), without any prompt nor board display.
+ *
+ * Each game gives one line `<number> <result> <plies> <detail>`:
+ * - `victoire 41 alice attaque`: the game ended, won by the named player (with its role),
+ * - `inachevee 12 -`: the moves ran out before the end of the game,
+ * - `illegal 7 a4-a9`: the move after the 7 plies played is not legal (or comes after the end),
+ * - `invalide 0 14`: the size or a move cannot be read (the detail is the text read).
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <cstdint>
+#include <iostream>
+#include "typeDef.h"
+
+/**
+ * @enum BatchStatus
+ * @brief How a game of the stream ended.
+ */
+enum BatchStatus
+{
+    BATCH_FINISHED = 0,   /**< The game is over (`isGameFinished`). */
+    BATCH_UNFINISHED = 1, /**< All the moves were played and the game goes on. */
+    BATCH_ILLEGAL = 2,    /**< A move is refused by `isValidMovement`, or follows the end of the game. */
+    BATCH_INVALID = 3     /**< The line cannot be read. */
+};
+
+/**
+ * @struct BatchResult
+ * @brief Result of one game of the stream.
+ */
+struct BatchResult
+{
+    BatchStatus itsStatus = BATCH_INVALID; /**< How the game ended. */
+    int itsPlies = 0;                      /**< Moves played. */
+    PlayerRole itsWinnerRole = ATTACK;     /**< Role of the winner (`BATCH_FINISHED` only). */
+    string itsDetail;                      /**< Name of the winner, or text of the faulty token. */
+};
+
+/**
+ * @struct BatchReport
+ * @brief Totals of a stream of games.
+ */
+struct BatchReport
+{
+    uint64_t itsGames = 0;          /**< Games read. */
+    uint64_t itsCounts[4] = {};     /**< Games of each `BatchStatus`. */
+    double itsSeconds = 0;          /**< Wall time. */
+};
+
+/**
+ * @brief Plays the game written on one line.
+ *
+ * @param aLine The line (without its end of line).
+ * @param aGame The game; its board is reused when the size does not change (created or replaced otherwise).
+ * @param aResult Receives the result.
+ * @return The status of the game (also in `aResult`).
+ */
+BatchStatus playBatchGame(const string& aLine, Game& aGame, BatchResult& aResult);
+
+/**
+ * @brief Appends the result line of a game.
+ *
+ * @param aNumber Number of the game in the stream, from 1.
+ * @param aResult The result.
+ * @param aText Receives the line, ending with an end of line.
+ */
+void formatBatchResult(uint64_t aNumber, const BatchResult& aResult, string& aText);
+
+/**
+ * @brief Plays every game of a stream and writes one result line per game.
+ *
+ * @param aInput The games, one per line.
+ * @param aOutput Receives the result lines, written in blocks.
+ * @param aReport Receives the totals.
+ */
+void runBatch(istream& aInput, ostream& aOutput, BatchReport& aReport);
+
+#endif // BATCH_H
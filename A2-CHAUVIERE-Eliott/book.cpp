@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+#include "book.h"
+#include "functions.h"
+#include "movegen.h"
+#include "record.h"
+#include "symmetry.h"
+
+/**
+ * Clé d'agrégation : position canonique et coup dans le repère canonique.
+ */
+struct BookKey
+{
+    uint64_t itsKey;
+    uint32_t itsMove;
+
+    bool operator==(const BookKey& aOther) const
+    {
+        return itsKey == aOther.itsKey && itsMove == aOther.itsMove;
+    }
+};
+
+struct BookKeyHash
+{
+    size_t operator()(const BookKey& aKey) const
+    {
+        return size_t(aKey.itsKey ^ (uint64_t(aKey.itsMove) * 0x9E3779B97F4A7C15ULL));
+    }
+};
+
+struct BookCounts
+{
+    uint32_t itsGames = 0;
+    uint32_t itsWins = 0;
+    uint32_t itsLosses = 0;
+};
+
+static uint32_t encodeMove(const Move& aMove)
+{
+    return uint32_t(aMove.itsStartPosition.itsRow) << 24 | uint32_t(aMove.itsStartPosition.itsCol) << 16
+           | uint32_t(aMove.itsEndPosition.itsRow) << 8 | uint32_t(aMove.itsEndPosition.itsCol);
+}
+
+static bool samePacked(const PackedBoard& a, const PackedBoard& b)
+{
+    for (int r = 0; r < a.itsSize; ++r) {
+        if (a.itsSwords[r] != b.itsSwords[r] || a.itsShields[r] != b.itsShields[r] || a.itsKing[r] != b.itsKing[r])
+            return false;
+    }
+    return true;
+}
+
+// coup dans le repère canonique ; si la position est elle-même symétrique, les coups équivalents sont confondus
+static uint32_t getCanonicalMove(const PackedBoard& aPacked, const PackedBoard& aCanonical, const Move& aMove)
+{
+    uint32_t best = UINT32_MAX;
+    PackedBoard variant;
+    for (int t = 0; t < SYMMETRY_COUNT; ++t) {
+        transformPacked(aPacked, t, variant);
+        if (samePacked(variant, aCanonical))
+            best = min(best, encodeMove(transformMove(aMove, t, aPacked.itsSize)));
+    }
+    return best;
+}
+
+// ordre du livre : clé, puis coups les plus joués d'abord
+static bool entryLess(const BookEntry& a, const BookEntry& b)
+{
+    if (a.itsKey != b.itsKey)
+        return a.itsKey < b.itsKey;
+    if (a.itsGames != b.itsGames)
+        return a.itsGames > b.itsGames;
+    return memcmp(a.itsMove, b.itsMove, 4) < 0;
+}
+
+bool buildOpeningBook(const string& aArchivePath, const string& aBookPath, int aPlies, int aMinGames)
+{
+    RecordReader reader;
+    if (!openRecordReader(reader, aArchivePath))
+        return false;
+
+    unordered_map<BookKey, BookCounts, BookKeyHash> counts;
+    vector<pair<BookKey, PlayerRole>> played; // coups de la partie en cours, en attendant son résultat
+    Game game;
+    bool valid = true;
+
+    while (valid && reader.itsStream.peek() != EOF) {
+        if (!readRecordHeader(reader, game)) {
+            valid = false;
+            break;
+        }
+        played.clear();
+        RecordStatus status;
+        while (true) {
+            PackedBoard packed;
+            PackedBoard canonical;
+            packPosition(game, packed);
+            PlayerRole side = game.itsCurrentPlayer->itsRole;
+            Move move;
+            status = replayRecordMove(reader, game, move);
+            if (status != RECORD_MOVE)
+                break;
+            if (int(played.size()) < aPlies) {
+                canonicalizePacked(packed, canonical);
+                played.push_back({{hashPacked(canonical), getCanonicalMove(packed, canonical, move)}, side});
+            }
+        }
+        if (status == RECORD_ERROR) {
+            valid = false;
+            break;
+        }
+
+        for (const pair<BookKey, PlayerRole>& entry : played) {
+            BookCounts& count = counts[entry.first];
+            count.itsGames++;
+            // le joueur 1 attaque dans les enregistrements
+            RecordResult winner = (entry.second == ATTACK) ? RECORD_PLAYER1 : RECORD_PLAYER2;
+            if (reader.itsResult == winner)
+                count.itsWins++;
+            else if (reader.itsResult != RECORD_UNFINISHED)
+                count.itsLosses++;
+        }
+    }
+    closeRecordReader(reader);
+    deleteBoard(game.itsBoard);
+    if (!valid)
+        return false;
+
+    vector<BookEntry> entries;
+    entries.reserve(counts.size());
+    for (const pair<const BookKey, BookCounts>& count : counts) {
+        if (count.second.itsGames < uint32_t(aMinGames))
+            continue;
+        uint32_t move = count.first.itsMove;
+        entries.push_back({count.first.itsKey,
+                           {uint8_t(move >> 24), uint8_t(move >> 16), uint8_t(move >> 8), uint8_t(move)},
+                           count.second.itsGames, count.second.itsWins, count.second.itsLosses});
+    }
+    sort(entries.begin(), entries.end(), entryLess);
+
+    ofstream out(aBookPath, ios::binary | ios::trunc);
+    uint64_t header[2] = {BOOK_MAGIC, entries.size()};
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries.data()), streamsize(entries.size() * sizeof(BookEntry)));
+    return bool(out);
+}
+
+bool openOpeningBook(OpeningBook& aBook, const string& aPath)
+{
+    if (!openMappedFile(aBook.itsFile, aPath))
+        return false;
+    const uint64_t* header = reinterpret_cast<const uint64_t*>(aBook.itsFile.itsData);
+    if (aBook.itsFile.itsSize < 2 * sizeof(uint64_t) || header[0] != BOOK_MAGIC
+        || aBook.itsFile.itsSize != 2 * sizeof(uint64_t) + header[1] * sizeof(BookEntry)) {
+        closeMappedFile(aBook.itsFile);
+        return false;
+    }
+    aBook.itsEntries = reinterpret_cast<const BookEntry*>(header + 2);
+    aBook.itsCount = header[1];
+    return true;
+}
+
+void closeOpeningBook(OpeningBook& aBook)
+{
+    closeMappedFile(aBook.itsFile);
+    aBook.itsEntries = nullptr;
+    aBook.itsCount = 0;
+}
+
+int probeOpeningBook(const OpeningBook& aBook, const Game& aGame, BookMove* aMoves)
+{
+    if (aBook.itsCount == 0)
+        return 0;
+    int transform;
+    uint64_t key = getCanonicalKey(aGame, &transform);
+    int inverse = getInverseTransform(transform);
+
+    const BookEntry* end = aBook.itsEntries + aBook.itsCount;
+    const BookEntry* entry = lower_bound(aBook.itsEntries, end, key,
+                                         [](const BookEntry& aEntry, uint64_t aKey) { return aEntry.itsKey < aKey; });
+    int count = 0;
+    for (; entry != end && entry->itsKey == key && count < BOOK_MAX_MOVES; ++entry) {
+        Move canonical = {{entry->itsMove[0], entry->itsMove[1]}, {entry->itsMove[2], entry->itsMove[3]}};
+        Move move = transformMove(canonical, inverse, aGame.itsBoard.itsSize);
+        if (getMoveIndex(aGame, move) == -1)
+            continue; // collision de clés
+        uint32_t unfinished = entry->itsGames - entry->itsWins - entry->itsLosses;
+        aMoves[count++] = {move, 2 * entry->itsWins + unfinished, entry->itsGames, entry->itsWins, entry->itsLosses};
+    }
+    return count;
+}
+
+bool pickBookMove(const OpeningBook& aBook, const Game& aGame, Move& aMove)
+{
+    BookMove moves[BOOK_MAX_MOVES];
+    int count = probeOpeningBook(aBook, aGame, moves);
+    uint64_t total = 0;
+    for (int i = 0; i < count; ++i)
+        total += moves[i].itsWeight;
+    if (total == 0)
+        return false; // position absente, ou coups qui n'ont fait que perdre
+
+    uint64_t pick = (uint64_t(rand()) * (uint64_t(RAND_MAX) + 1) + uint64_t(rand())) % total;
+    for (int i = 0; i < count; ++i) {
+        if (pick < moves[i].itsWeight) {
+            aMove = moves[i].itsMove;
+            return true;
+        }
+        pick -= moves[i].itsWeight;
+    }
+    return false;
+}
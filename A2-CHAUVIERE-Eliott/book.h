@@ -0,0 +1,129 @@
+/**
+ * @file book.h
+ *
+ * @brief Opening book built from a game record archive.
+ *
+ * The builder replays the first plies of every game of an archive and counts, for each position,
+ * how often each move was played and how the game ended. Positions are keyed by their canonical
+ * key (`getCanonicalKey`) and moves are stored in the frame of the canonical position, so the 8
+ * symmetric variants of a position (and of a move, when the position is itself symmetric, as the
+ * starting position is) share one entry.
+ *
+ * The book file is a header (`BOOK_MAGIC` and the number of entries) followed by the `BookEntry`
+ * table sorted by key, then by decreasing number of games. It is read through a memory mapping
+ * and searched in place, so a lookup costs a binary search and never reads the archive.
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef BOOK_H
+#define BOOK_H
+
+#include <cstdint>
+#include "typeDef.h"
+#include "mappedfile.h"
+
+/**
+ * @brief First 8 bytes of a book file.
+ */
+const uint64_t BOOK_MAGIC = 0x314B4F4254414648ULL; // "HFATBOK1"
+
+/**
+ * @brief Default number of plies of each game added to the book.
+ */
+const int BOOK_DEFAULT_PLIES = 16;
+
+/**
+ * @brief Largest number of moves returned for one position.
+ */
+const int BOOK_MAX_MOVES = 32;
+
+/**
+ * @struct BookEntry
+ * @brief One move of one position, in the frame of the canonical position.
+ */
+struct BookEntry
+{
+    uint64_t itsKey;       /**< Canonical key of the position. */
+    uint8_t itsMove[4];    /**< Start row, start column, end row, end column. */
+    uint32_t itsGames;     /**< Number of games where the move was played. */
+    uint32_t itsWins;      /**< Games won by the side that played the move. */
+    uint32_t itsLosses;    /**< Games lost by the side that played the move (the others are unfinished). */
+};
+
+/**
+ * @struct BookMove
+ * @brief A move proposed by the book, in the frame of the probed position.
+ */
+struct BookMove
+{
+    Move itsMove;          /**< The move, legal in the probed position. */
+    uint32_t itsWeight;    /**< Weight of the move: 2 per win and 1 per unfinished game. */
+    uint32_t itsGames;     /**< Number of games where the move was played. */
+    uint32_t itsWins;      /**< Games won by the side that played the move. */
+    uint32_t itsLosses;    /**< Games lost by the side that played the move. */
+};
+
+/**
+ * @struct OpeningBook
+ * @brief A book file mapped in memory.
+ */
+struct OpeningBook
+{
+    MappedFile itsFile;                    /**< The mapped file. */
+    const BookEntry* itsEntries = nullptr; /**< The sorted table. */
+    uint64_t itsCount = 0;                 /**< Number of entries of the table. */
+};
+
+/**
+ * @brief Builds an opening book from a record archive.
+ *
+ * @param aArchivePath The record archive.
+ * @param aBookPath The book file to write.
+ * @param aPlies Number of plies of each game added to the book.
+ * @param aMinGames Moves played in fewer games are left out of the book.
+ * @return `true` if the book was written, `false` if a file could not be opened or the archive is corrupted.
+ */
+bool buildOpeningBook(const string& aArchivePath, const string& aBookPath, int aPlies = BOOK_DEFAULT_PLIES, int aMinGames = 1);
+
+/**
+ * @brief Maps a book file in memory.
+ *
+ * @param aBook The book to open.
+ * @param aPath The path of the book file.
+ * @return `true` if the file is a valid book, `false` otherwise.
+ */
+bool openOpeningBook(OpeningBook& aBook, const string& aPath);
+
+/**
+ * @brief Unmaps a book file.
+ *
+ * @param aBook The book to close.
+ */
+void closeOpeningBook(OpeningBook& aBook);
+
+/**
+ * @brief Lists the book moves of a position.
+ *
+ * Moves are transformed back into the frame of `aGame` and checked with `getMoveIndex`, so a
+ * key collision can never return an illegal move.
+ *
+ * @param aBook The open book.
+ * @param aGame The position.
+ * @param aMoves An array of at least `BOOK_MAX_MOVES` moves receiving the list, most played first.
+ * @return The number of moves found (0 if the position is not in the book).
+ */
+int probeOpeningBook(const OpeningBook& aBook, const Game& aGame, BookMove* aMoves);
+
+/**
+ * @brief Picks a book move at random, in proportion to the weights of the moves.
+ *
+ * @param aBook The open book.
+ * @param aGame The position.
+ * @param aMove Receives the move.
+ * @return `false` if the position is not in the book.
+ */
+bool pickBookMove(const OpeningBook& aBook, const Game& aGame, Move& aMove);
+
+#endif // BOOK_H
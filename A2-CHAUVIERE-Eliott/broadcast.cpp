@@ -0,0 +1,108 @@
+#include <cstdlib>
+#include <sstream>
+using namespace std;
+#include "broadcast.h"
+#include "functions.h"
+#include "notation.h"
+
+static void onMove(void*, PieceType, const Position&, const Position&)
+{
+}
+
+static void onRemove(void* aContext, PieceType, const Position& aPos)
+{
+    BroadcastChannel& channel = *static_cast<BroadcastChannel*>(aContext);
+    if (channel.itsCaptureCount < 8)
+        channel.itsCaptured[channel.itsCaptureCount++] = aPos;
+}
+
+static void onPlace(void*, PieceType, const Position&)
+{
+}
+
+BroadcastFrame encodeKeyframe(int aPly, const Game& aGame)
+{
+    char text[POSITION_STRING_SIZE];
+    formatPosition(aGame, text, POSITION_STRING_SIZE);
+    return make_shared<const string>("key " + to_string(aPly) + " " + text + "\n");
+}
+
+void attachBroadcast(BroadcastChannel& aChannel, Game& aGame)
+{
+    aChannel.itsHooks.itsOnMove = onMove;
+    aChannel.itsHooks.itsOnRemove = onRemove;
+    aChannel.itsHooks.itsOnPlace = onPlace;
+    aChannel.itsHooks.itsContext = &aChannel;
+    aGame.itsHooks = &aChannel.itsHooks;
+    aChannel.itsFrames.assign(1, encodeKeyframe(aChannel.itsPly, aGame));
+    aChannel.itsCaptureCount = 0;
+}
+
+void detachBroadcast(BroadcastChannel& aChannel, Game& aGame)
+{
+    if (aGame.itsHooks == &aChannel.itsHooks)
+        aGame.itsHooks = nullptr;
+}
+
+BroadcastFrame publishMove(BroadcastChannel& aChannel, const Game& aGame, const Move& aMove)
+{
+    char text[MOVE_STRING_SIZE];
+    formatMove(aMove, text, MOVE_STRING_SIZE);
+    string line = "ply " + to_string(++aChannel.itsPly) + " " + text;
+    if (aChannel.itsCaptureCount > 0) {
+        line += " x";
+        for (int i = 0; i < aChannel.itsCaptureCount; ++i) {
+            line += ' ';
+            line += char('a' + aChannel.itsCaptured[i].itsRow);
+            line += to_string(aChannel.itsCaptured[i].itsCol + 1);
+        }
+    }
+    line += '\n';
+    aChannel.itsCaptureCount = 0;
+
+    // un seul encodage, partagé par tous les spectateurs
+    BroadcastFrame frame = make_shared<const string>(move(line));
+    if (aChannel.itsPly % BROADCAST_KEYFRAME_PLIES == 0)
+        aChannel.itsFrames.assign(1, encodeKeyframe(aChannel.itsPly, aGame));
+    else
+        aChannel.itsFrames.push_back(frame);
+    return frame;
+}
+
+const vector<BroadcastFrame>& getCatchUpFrames(const BroadcastChannel& aChannel)
+{
+    return aChannel.itsFrames;
+}
+
+bool applyFrame(const string& aFrame, Game& aGame, int& aPly)
+{
+    istringstream words(aFrame);
+    string kind;
+    int ply;
+    if (!(words >> kind >> ply))
+        return false;
+    if (kind == "key") {
+        string position;
+        getline(words >> ws, position);
+        if (!parsePosition(position.c_str(), aGame))
+            return false;
+        aPly = ply;
+        return true;
+    }
+
+    string text;
+    Move move;
+    if (kind != "ply" || aGame.itsBoard.itsCells == nullptr || !(words >> text) || !parseMove(text.c_str(), aGame.itsBoard, move))
+        return false;
+    movePiece(aGame, move);
+    if (words >> text && text == "x")
+        while (words >> text) {
+            Position cell = {text[0] - 'a', atoi(text.c_str() + 1) - 1};
+            if (!isValidPosition(cell, aGame.itsBoard))
+                return false;
+            aGame.itsBoard.itsCells[cell.itsRow][cell.itsCol].itsPieceType = NONE;
+        }
+    switchCurrentPlayer(aGame);
+    aPly = ply;
+    return true;
+}
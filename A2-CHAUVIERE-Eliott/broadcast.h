@@ -0,0 +1,108 @@
+/**
+ * @file broadcast.h
+ *
+ * @brief Broadcast of a game to its spectators: each ply is encoded once into an immutable
+ *        frame shared by every spectator.
+ *
+ * A frame is a line of text held by a `shared_ptr<const string>`: the sender of each spectator
+ * keeps a pointer to it until it is written, so a ply costs one encoding and one allocation
+ * whatever the number of spectators. Frames:
+ * - `ply <n> <move> [x <cell> ...]`: ply `n` of the game, with the cells emptied by `capturePieces`
+ *   (e.g. `ply 12 a4-c4 x b4 c5`),
+ * - `key <n> <position string>`: the position after ply `n` (see `formatPosition`).
+ *
+ * A keyframe is made every `BROADCAST_KEYFRAME_PLIES` plies and replaces the history: a spectator
+ * joining late gets the last keyframe and the plies after it (`getCatchUpFrames`), at most
+ * `BROADCAST_KEYFRAME_PLIES` frames, instead of the whole game.
+ *
+ * The captured cells are collected through the hooks of the game (`attachBroadcast`).
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef BROADCAST_H
+#define BROADCAST_H
+
+#include <memory>
+#include <vector>
+#include "typeDef.h"
+
+/**
+ * @brief Plies between two keyframes.
+ */
+const int BROADCAST_KEYFRAME_PLIES = 16;
+
+/**
+ * @brief A frame sent to the spectators (one line, ending with an end of line).
+ */
+typedef shared_ptr<const string> BroadcastFrame;
+
+/**
+ * @struct BroadcastChannel
+ * @brief Frames of a game.
+ */
+struct BroadcastChannel
+{
+    vector<BroadcastFrame> itsFrames; /**< Last keyframe, then the plies played since. */
+    int itsPly = 0;                   /**< Plies published. */
+    Position itsCaptured[8];          /**< Cells captured by the ply being played. */
+    int itsCaptureCount = 0;          /**< Number of cells in `itsCaptured`. */
+    GameHooks itsHooks;               /**< Hooks installed on the game. */
+};
+
+/**
+ * @brief Starts the frames of a game from its current position (a keyframe) and watches its captures.
+ *
+ * @param aChannel The channel.
+ * @param aGame The game; its hooks are replaced by those of the channel until `detachBroadcast`.
+ */
+void attachBroadcast(BroadcastChannel& aChannel, Game& aGame);
+
+/**
+ * @brief Stops watching the captures of a game.
+ *
+ * @param aChannel The channel.
+ * @param aGame The game.
+ */
+void detachBroadcast(BroadcastChannel& aChannel, Game& aGame);
+
+/**
+ * @brief Encodes a ply that was just played (`movePiece`, `capturePieces` then `switchCurrentPlayer`)
+ *        and adds it to the frames.
+ *
+ * @param aChannel The channel.
+ * @param aGame The game, after the ply (the keyframes give the player to move).
+ * @param aMove The move of the ply.
+ * @return The frame of the ply (followed in `itsFrames` by a new keyframe when one is due).
+ */
+BroadcastFrame publishMove(BroadcastChannel& aChannel, const Game& aGame, const Move& aMove);
+
+/**
+ * @brief Encodes a keyframe of a game.
+ *
+ * @param aPly The plies played.
+ * @param aGame The game.
+ * @return The frame.
+ */
+BroadcastFrame encodeKeyframe(int aPly, const Game& aGame);
+
+/**
+ * @brief Frames that bring a new spectator to the current position.
+ *
+ * @param aChannel The channel.
+ * @return The last keyframe and the plies after it.
+ */
+const vector<BroadcastFrame>& getCatchUpFrames(const BroadcastChannel& aChannel);
+
+/**
+ * @brief Plays a frame on a spectator's copy of the game.
+ *
+ * @param aFrame The text of the frame (with or without its end of line).
+ * @param aGame The copy; a keyframe replaces its position, a ply moves the piece and removes the captured ones.
+ * @param aPly Receives the number of plies after the frame.
+ * @return `false` if the frame cannot be read.
+ */
+bool applyFrame(const string& aFrame, Game& aGame, int& aPly);
+
+#endif // BROADCAST_H
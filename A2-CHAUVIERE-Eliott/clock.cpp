@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+using namespace std;
+#include "clock.h"
+
+int64_t getClockTime()
+{
+    return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// lit un nombre de secondes positif ou nul ; renvoie false si rien n'est lu
+static bool readSeconds(const char*& aText, int64_t& aTime)
+{
+    char* end;
+    double seconds = strtod(aText, &end);
+    if (end == aText || seconds < 0)
+        return false;
+    aText = end;
+    aTime = int64_t(seconds * CLOCK_SECOND);
+    return true;
+}
+
+bool parseTimeControl(const string& aText, TimeControl& aControl)
+{
+    TimeControl control;
+    const char* text = aText.c_str();
+    if (!readSeconds(text, control.itsMainTime))
+        return false;
+    if (*text == '\0' && control.itsMainTime == 0) {
+        aControl = control; // sans pendule
+        return true;
+    }
+    if (*text == '+') {
+        text++;
+        control.itsMode = CLOCK_FISCHER;
+        if (!readSeconds(text, control.itsIncrement) || *text != '\0' || control.itsMainTime == 0)
+            return false;
+    }
+    else if (*text == '/') {
+        text++;
+        control.itsMode = CLOCK_BYOYOMI;
+        if (!readSeconds(text, control.itsPeriod) || (*text != 'x' && *text != 'X') || control.itsPeriod == 0)
+            return false;
+        char* end;
+        long periods = strtol(text + 1, &end, 10);
+        if (end == text + 1 || *end != '\0' || periods < 1 || periods > 1000)
+            return false;
+        control.itsPeriods = int(periods);
+    }
+    else
+        return false;
+    aControl = control;
+    return true;
+}
+
+string formatClockTime(int64_t aTime)
+{
+    int64_t tenths = max<int64_t>(0, aTime) / (CLOCK_SECOND / 10);
+    char text[32];
+    snprintf(text, sizeof(text), "%lld:%02d.%d", (long long)(tenths / 600), int(tenths / 10 % 60), int(tenths % 10));
+    return text;
+}
+
+void initializeClock(GameClock& aClock, const TimeControl& aControl)
+{
+    aClock.itsControl = aControl;
+    for (int role = 0; role < 2; ++role) {
+        aClock.itsMainTime[role] = aControl.itsMainTime;
+        aClock.itsPeriods[role] = aControl.itsPeriods;
+        aClock.itsFlagged[role] = false;
+    }
+    aClock.itsRunning = -1;
+    aClock.itsStarted = 0;
+}
+
+void startClock(GameClock& aClock, PlayerRole aRole, int64_t aNow)
+{
+    aClock.itsRunning = aRole;
+    aClock.itsStarted = aNow;
+}
+
+bool stopClock(GameClock& aClock, int64_t aNow)
+{
+    int role = aClock.itsRunning;
+    if (role < 0)
+        return true;
+    aClock.itsRunning = -1;
+    int64_t spent = max<int64_t>(0, aNow - aClock.itsStarted);
+    const TimeControl& control = aClock.itsControl;
+    int64_t& main = aClock.itsMainTime[role];
+
+    if (control.itsMode == CLOCK_FISCHER) {
+        main -= spent;
+        if (main < 0) {
+            main = 0;
+            aClock.itsFlagged[role] = true;
+        }
+        else
+            main += control.itsIncrement;
+    }
+    else if (control.itsMode == CLOCK_BYOYOMI) {
+        if (spent <= main)
+            main -= spent;
+        else {
+            // chaque période entièrement consommée est perdue
+            int64_t lost = (spent - main) / control.itsPeriod;
+            main = 0;
+            if (lost >= aClock.itsPeriods[role]) {
+                aClock.itsPeriods[role] = 0;
+                aClock.itsFlagged[role] = true;
+            }
+            else
+                aClock.itsPeriods[role] -= int(lost);
+        }
+    }
+    return !aClock.itsFlagged[role];
+}
+
+int64_t getTimeToFlag(const GameClock& aClock, PlayerRole aRole, int64_t aNow)
+{
+    const TimeControl& control = aClock.itsControl;
+    if (control.itsMode == CLOCK_NONE)
+        return INT64_MAX;
+    if (aClock.itsFlagged[aRole])
+        return 0;
+    int64_t spent = (aClock.itsRunning == aRole) ? max<int64_t>(0, aNow - aClock.itsStarted) : 0;
+    int64_t left = aClock.itsMainTime[aRole];
+    if (control.itsMode == CLOCK_BYOYOMI)
+        left += aClock.itsPeriods[aRole] * control.itsPeriod;
+    return max<int64_t>(0, left - spent);
+}
+
+MoveBudget allocateTime(const GameClock& aClock, PlayerRole aRole, int aLegalMoves, int aPly)
+{
+    MoveBudget budget;
+    const TimeControl& control = aClock.itsControl;
+    if (control.itsMode == CLOCK_NONE) {
+        budget.itsSoft = budget.itsHard = INT64_MAX;
+        return budget;
+    }
+
+    int64_t main = aClock.itsMainTime[aRole];
+    int movesToGo = max(12, 40 - aPly / 6); // coups restant à jouer, estimés
+    int64_t base;
+    int64_t limit; // temps au-delà duquel la partie (ou une période) serait perdue
+    if (control.itsMode == CLOCK_FISCHER) {
+        base = main / movesToGo + control.itsIncrement * 3 / 4;
+        limit = min(main - CLOCK_OVERHEAD, main / 3 + control.itsIncrement);
+    }
+    else if (main > 0) {
+        base = main / movesToGo + control.itsPeriod / 2;
+        limit = main + control.itsPeriod - CLOCK_OVERHEAD;
+    }
+    else {
+        base = control.itsPeriod / 2;
+        limit = control.itsPeriod - CLOCK_OVERHEAD;
+    }
+
+    // plus de coups légaux, position plus ouverte : plus de temps
+    double complexity = 0.75 + 0.5 * min(max(aLegalMoves, 0), 150) / 150.0;
+    limit = max<int64_t>(0, limit);
+    budget.itsSoft = min(limit, int64_t(double(base) * complexity));
+    budget.itsHard = min(limit, budget.itsSoft * 4);
+    return budget;
+}
+
+bool isSoftDeadlineReached(const MoveBudget& aBudget, int64_t aElapsed, int aStability)
+{
+    static const double SCALES[4] = {1.5, 1.0, 0.8, 0.6};
+    double scale = SCALES[min(max(aStability, 0), 3)];
+    int64_t soft = (aBudget.itsSoft == INT64_MAX) ? INT64_MAX : min(aBudget.itsHard, int64_t(double(aBudget.itsSoft) * scale));
+    return aElapsed >= soft;
+}
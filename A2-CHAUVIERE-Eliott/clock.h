@@ -0,0 +1,175 @@
+/**
+ * @file clock.h
+ *
+ * @brief Game clocks (Fischer increment or byo-yomi) and time allocation per move.
+ *
+ * Times are counted in microseconds on the monotonic clock (`steady_clock`), so changes of the
+ * system time never touch a running game. A clock is a plain structure without thread or timer:
+ * a server keeps one per game, punches it after each move (`stopClock`) and can ask at any time
+ * how long the player to move has before losing (`getTimeToFlag`).
+ *
+ * `allocateTime` gives a bot two deadlines for its move: the soft one, checked between two
+ * iterations of the search and scaled by the stability of the best move, and the hard one,
+ * after which the search must be stopped.
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <cstdint>
+#include "typeDef.h"
+
+/**
+ * @brief Microseconds in one second.
+ */
+const int64_t CLOCK_SECOND = 1000000;
+
+/**
+ * @brief Time kept for the delay between the end of the search and the move reaching the clock.
+ */
+const int64_t CLOCK_OVERHEAD = 30000;
+
+/**
+ * @enum ClockMode
+ * @brief Kind of time control.
+ */
+enum ClockMode
+{
+    CLOCK_NONE,     /**< No clock. */
+    CLOCK_FISCHER,  /**< Main time, plus an increment after each move. */
+    CLOCK_BYOYOMI   /**< Main time, then periods: a move made within a period keeps it, a period exceeded is lost. */
+};
+
+/**
+ * @struct TimeControl
+ * @brief Settings of the clocks of a game.
+ */
+struct TimeControl
+{
+    ClockMode itsMode = CLOCK_NONE; /**< Kind of time control. */
+    int64_t itsMainTime = 0;        /**< Main time of each player. */
+    int64_t itsIncrement = 0;       /**< Added after each move (Fischer). */
+    int64_t itsPeriod = 0;          /**< Length of a period (byo-yomi). */
+    int itsPeriods = 0;             /**< Number of periods (byo-yomi). */
+};
+
+/**
+ * @struct GameClock
+ * @brief Clocks of both players of a game, indexed by `PlayerRole`.
+ */
+struct GameClock
+{
+    TimeControl itsControl;              /**< The time control. */
+    int64_t itsMainTime[2] = {0, 0};     /**< Main time left. */
+    int itsPeriods[2] = {0, 0};          /**< Periods left (byo-yomi). */
+    bool itsFlagged[2] = {false, false}; /**< The player lost on time. */
+    int itsRunning = -1;                 /**< Role whose clock runs, or -1. */
+    int64_t itsStarted = 0;              /**< Time the running clock was started (`getClockTime`). */
+};
+
+/**
+ * @struct MoveBudget
+ * @brief Time a bot may spend on a move, counted from the start of its search.
+ */
+struct MoveBudget
+{
+    int64_t itsSoft = 0; /**< No new iteration is started after it (before the stability scaling). */
+    int64_t itsHard = 0; /**< The search is stopped at it. */
+};
+
+/**
+ * @brief Returns the time of the monotonic clock.
+ *
+ * @return Microseconds since an arbitrary fixed point.
+ */
+int64_t getClockTime();
+
+/**
+ * @brief Reads a time control in seconds: "300+5" (Fischer: main time + increment),
+ *        "600/30x5" (byo-yomi: main time / period x periods) or "0" (no clock).
+ *
+ * @param aText The text to read.
+ * @param aControl Receives the time control.
+ * @return `true` if the text is a valid time control.
+ */
+bool parseTimeControl(const string& aText, TimeControl& aControl);
+
+/**
+ * @brief Writes a time in minutes and seconds, e.g. "4:07.3".
+ *
+ * @param aTime The time (negative times are written as 0).
+ * @return The text.
+ */
+string formatClockTime(int64_t aTime);
+
+/**
+ * @brief Sets both clocks to the start of a game; no clock runs.
+ *
+ * @param aClock The clocks.
+ * @param aControl The time control.
+ */
+void initializeClock(GameClock& aClock, const TimeControl& aControl);
+
+/**
+ * @brief Starts the clock of a player.
+ *
+ * @param aClock The clocks.
+ * @param aRole The player to move.
+ * @param aNow The current time (`getClockTime`).
+ */
+void startClock(GameClock& aClock, PlayerRole aRole, int64_t aNow);
+
+/**
+ * @brief Stops the running clock after a move and charges the time spent.
+ *
+ * With Fischer the increment is added; with byo-yomi the main time is used first, then each
+ * period entirely spent on the move is lost.
+ *
+ * @param aClock The clocks.
+ * @param aNow The current time (`getClockTime`).
+ * @return `false` if the player lost on time.
+ */
+bool stopClock(GameClock& aClock, int64_t aNow);
+
+/**
+ * @brief Returns how long a player can still think on the current move before losing on time.
+ *
+ * @param aClock The clocks.
+ * @param aRole The player.
+ * @param aNow The current time (`getClockTime`).
+ * @return The time left (0 if the player lost; `INT64_MAX` without clock).
+ */
+int64_t getTimeToFlag(const GameClock& aClock, PlayerRole aRole, int64_t aNow);
+
+/**
+ * @brief Decides the deadlines of a move.
+ *
+ * The base share is the main time divided by the moves expected until the end of the game,
+ * plus most of the increment or of a period; it is scaled by the number of legal moves (a wide
+ * position gets more time) and the hard deadline always leaves `CLOCK_OVERHEAD` before the flag.
+ *
+ * @param aClock The clocks.
+ * @param aRole The player to move.
+ * @param aLegalMoves Number of legal moves of the position.
+ * @param aPly Number of plies played in the game.
+ * @return The deadlines, counted from the start of the move (both `INT64_MAX` without clock).
+ */
+MoveBudget allocateTime(const GameClock& aClock, PlayerRole aRole, int aLegalMoves, int aPly);
+
+/**
+ * @brief Tells whether a search should stop before starting a new iteration.
+ *
+ * The soft deadline is stretched when the best move has just changed and shortened when it
+ * stayed the same over several iterations; it never exceeds the hard deadline.
+ *
+ * @param aBudget The deadlines of the move.
+ * @param aElapsed Time spent on the move.
+ * @param aStability Number of iterations in a row with the same best move (0 if it has just changed).
+ * @return `true` if no new iteration should be started.
+ */
+bool isSoftDeadlineReached(const MoveBudget& aBudget, int64_t aElapsed, int aStability);
+
+#endif // CLOCK_H
@@ -0,0 +1,282 @@
+#include <cstdlib>
+#include <sstream>
+using namespace std;
+#include "engine.h"
+#include "clock.h"
+#include "functions.h"
+#include "movegen.h"
+#include "notation.h"
+#include "symmetry.h"
+
+// écrit une ligne entière, quel que soit le fil qui répond
+static void writeLine(Engine& aEngine, const string& aLine)
+{
+    lock_guard<mutex> lock(aEngine.itsOutputLock);
+    *aEngine.itsOutput << aLine << endl;
+}
+
+static void stopSearch(Engine& aEngine)
+{
+    aEngine.itsStop = true;
+    waitEngine(aEngine);
+}
+
+void waitEngine(Engine& aEngine)
+{
+    if (aEngine.itsSearch.joinable())
+        aEngine.itsSearch.join();
+}
+
+static void resetGame(Engine& aEngine, BoardSize aSize)
+{
+    Game& game = aEngine.itsGame;
+    if (game.itsBoard.itsCells != nullptr && game.itsBoard.itsSize != aSize)
+        deleteBoard(game.itsBoard);
+    if (game.itsBoard.itsCells == nullptr) {
+        game.itsBoard.itsSize = aSize;
+        createBoard(game.itsBoard);
+    }
+    initializeBoard(game.itsBoard);
+    game.itsPlayer1.itsRole = ATTACK;
+    game.itsPlayer2.itsRole = DEFENSE;
+    game.itsCurrentPlayer = &game.itsPlayer1;
+    aEngine.itsPly = 0;
+}
+
+void initializeEngine(Engine& aEngine, ostream& aOutput)
+{
+    aEngine.itsOutput = &aOutput;
+    resetGame(aEngine, LITTLE);
+    createTranspositionTable(aEngine.itsTable, AnalysisConfig().itsHashBits);
+}
+
+void releaseEngine(Engine& aEngine)
+{
+    stopSearch(aEngine);
+    if (aEngine.itsGame.itsBoard.itsCells != nullptr)
+        deleteBoard(aEngine.itsGame.itsBoard);
+    aEngine.itsTable = TranspositionTable();
+}
+
+// joue les coups suivants avec les règles de itsGame ; s'arrête au premier coup refusé
+static bool playMoves(Engine& aEngine, istream& aWords)
+{
+    Game& game = aEngine.itsGame;
+    string word;
+    while (aWords >> word) {
+        Move move;
+        const char* end;
+        if (!parseMove(word.c_str(), game.itsBoard, move, &end) || *end != '\0' || isGameFinished(game)
+            || !isValidMovement(game, move)) {
+            writeLine(aEngine, "info string illegal move " + word);
+            return false;
+        }
+        movePiece(game, move);
+        capturePieces(game, move);
+        switchCurrentPlayer(game);
+        aEngine.itsPly++;
+    }
+    return true;
+}
+
+static void setPosition(Engine& aEngine, const char* aText)
+{
+    while (*aText == ' ' || *aText == '\t')
+        aText++;
+    istringstream words(aText);
+    string word;
+    words >> word;
+    if (word == "startpos")
+        resetGame(aEngine, aEngine.itsGame.itsBoard.itsSize);
+    else {
+        // position lue à part, pour garder l'ancienne si le texte est invalide
+        Game game;
+        const char* end;
+        if (!parsePosition(aText, game, &end)) {
+            if (game.itsBoard.itsCells != nullptr)
+                deleteBoard(game.itsBoard);
+            writeLine(aEngine, "info string invalid position");
+            return;
+        }
+        deleteBoard(aEngine.itsGame.itsBoard);
+        aEngine.itsGame.itsBoard = game.itsBoard;
+        aEngine.itsGame.itsPlayer1.itsRole = ATTACK;
+        aEngine.itsGame.itsPlayer2.itsRole = DEFENSE;
+        aEngine.itsGame.itsCurrentPlayer = (game.itsCurrentPlayer->itsRole == ATTACK) ? &aEngine.itsGame.itsPlayer1
+                                                                                      : &aEngine.itsGame.itsPlayer2;
+        aEngine.itsPly = 0;
+        words.clear();
+        words.str(end);
+    }
+    if (words >> word) {
+        if (word == "moves")
+            playMoves(aEngine, words);
+        else
+            writeLine(aEngine, "info string unexpected " + word);
+    }
+}
+
+static string formatEngineInfo(const AnalysisInfo& aInfo)
+{
+    const AnalysisLine& line = aInfo.itsLines[0];
+    ostringstream out;
+    out << "info depth " << aInfo.itsDepth << " score ";
+    int distance = getWinDistance(line.itsScore);
+    if (distance != 0)
+        out << "win " << distance;
+    else
+        out << line.itsScore;
+    out << " nodes " << aInfo.itsNodes << " time " << int64_t(aInfo.itsSeconds * 1000)
+        << " nps " << uint64_t((aInfo.itsSeconds > 0) ? double(aInfo.itsNodes) / aInfo.itsSeconds : 0) << " pv";
+    for (const Move& move : line.itsPv) {
+        char text[MOVE_STRING_SIZE];
+        formatMove(move, text, MOVE_STRING_SIZE);
+        out << " " << text;
+    }
+    return out.str();
+}
+
+static void startSearch(Engine& aEngine, istream& aWords)
+{
+    AnalysisConfig config;
+    config.itsLines = 1;
+    config.itsMaxDepth = SEARCH_MAX_PLY - 1;
+    config.itsTable = &aEngine.itsTable;
+    int64_t moveTime = -1;
+    int64_t times[2] = {-1, -1};
+    int64_t increments[2] = {0, 0};
+    bool infinite = false;
+    string word;
+    long long value;
+    while (aWords >> word) {
+        if (word == "infinite") {
+            infinite = true;
+            continue;
+        }
+        if (!(aWords >> value) || value < 0) {
+            writeLine(aEngine, "info string invalid value for " + word);
+            return;
+        }
+        if (word == "depth")
+            config.itsMaxDepth = int(min<long long>(max<long long>(value, 1), SEARCH_MAX_PLY - 1));
+        else if (word == "nodes")
+            config.itsMaxNodes = uint64_t(value);
+        else if (word == "movetime")
+            moveTime = value * 1000;
+        else if (word == "atime" || word == "dtime")
+            times[word[0] == 'a' ? ATTACK : DEFENSE] = value * 1000;
+        else if (word == "ainc" || word == "dinc")
+            increments[word[0] == 'a' ? ATTACK : DEFENSE] = value * 1000;
+        else {
+            writeLine(aEngine, "info string unknown limit " + word);
+            return;
+        }
+    }
+
+    // délais du coup : temps fixe, ou part de la pendule du joueur au trait
+    const Game& game = aEngine.itsGame;
+    PlayerRole role = game.itsCurrentPlayer->itsRole;
+    MoveBudget budget = {INT64_MAX, INT64_MAX};
+    if (moveTime >= 0)
+        budget.itsSoft = budget.itsHard = moveTime;
+    else if (times[role] >= 0) {
+        TimeControl control;
+        control.itsMode = CLOCK_FISCHER;
+        control.itsMainTime = times[role];
+        control.itsIncrement = increments[role];
+        GameClock clock;
+        initializeClock(clock, control);
+        Move moves[MAX_MOVES];
+        budget = allocateTime(clock, role, generateMoves(game, moves), aEngine.itsPly);
+    }
+    if (infinite)
+        budget.itsSoft = budget.itsHard = INT64_MAX;
+    aEngine.itsInfinite = infinite || (budget.itsHard == INT64_MAX && config.itsMaxNodes == 0
+                                       && config.itsMaxDepth == SEARCH_MAX_PLY - 1);
+
+    stopSearch(aEngine);
+    aEngine.itsStop = false;
+    aEngine.itsSearching = true;
+    PackedBoard packed;
+    packPosition(game, packed);
+    aEngine.itsSearch = thread([&aEngine, packed, config, budget]() {
+        Game game;
+        unpackPosition(packed, game);
+        Move move;
+        char text[MOVE_STRING_SIZE] = "none";
+        if (searchMove(game, budget, config, move, nullptr,
+                       [&aEngine](const AnalysisInfo& aIteration) { writeLine(aEngine, formatEngineInfo(aIteration)); },
+                       &aEngine.itsStop))
+            formatMove(move, text, MOVE_STRING_SIZE);
+        writeLine(aEngine, string("bestmove ") + text);
+        deleteBoard(game.itsBoard);
+        aEngine.itsSearching = false;
+    });
+}
+
+bool handleEngineCommand(Engine& aEngine, const string& aLine)
+{
+    istringstream words(aLine);
+    string command;
+    if (!(words >> command))
+        return true;
+
+    if (command == "hnef") {
+        writeLine(aEngine, "id name Hnefatafl");
+        writeLine(aEngine, "id author E. CHAUVIERE");
+        writeLine(aEngine, "hnefok");
+    }
+    else if (command == "isready")
+        writeLine(aEngine, "readyok");
+    else if (command == "newgame") {
+        string sizeText = "11";
+        words >> sizeText;
+        int size = atoi(sizeText.c_str());
+        if (size != LITTLE && size != BIG) {
+            writeLine(aEngine, "info string invalid size");
+            return true;
+        }
+        stopSearch(aEngine);
+        resetGame(aEngine, BoardSize(size));
+        clearTranspositionTable(aEngine.itsTable);
+    }
+    else if (command == "position") {
+        stopSearch(aEngine);
+        streamoff offset = words.tellg();
+        setPosition(aEngine, aLine.c_str() + ((offset < 0) ? aLine.size() : size_t(offset)));
+    }
+    else if (command == "moves") {
+        stopSearch(aEngine);
+        playMoves(aEngine, words);
+    }
+    else if (command == "go")
+        startSearch(aEngine, words);
+    else if (command == "stop")
+        stopSearch(aEngine);
+    else if (command == "print") {
+        char text[POSITION_STRING_SIZE];
+        formatPosition(aEngine.itsGame, text, POSITION_STRING_SIZE);
+        writeLine(aEngine, string("position ") + text);
+    }
+    else if (command == "quit") {
+        stopSearch(aEngine);
+        return false;
+    }
+    else
+        writeLine(aEngine, "info string unknown command " + command);
+    return true;
+}
+
+void runEngine(istream& aInput, ostream& aOutput)
+{
+    Engine engine;
+    initializeEngine(engine, aOutput);
+    string line;
+    bool running = true;
+    while (running && getline(aInput, line))
+        running = handleEngineCommand(engine, line);
+    // fin de l'entrée : une recherche bornée va jusqu'à son terme
+    if (running && !engine.itsInfinite)
+        waitEngine(engine);
+    releaseEngine(engine);
+}
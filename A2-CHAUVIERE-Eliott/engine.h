@@ -0,0 +1,95 @@
+/**
+ * @file engine.h
+ *
+ * @brief Line-based engine protocol on the standard input and output, for graphical interfaces
+ *        and match managers.
+ *
+ * Commands (one per line, words separated by spaces):
+ * - `hnef`: the engine answers `id name ...`, `id author ...` and `hnefok`,
+ * - `isready`: answers `readyok`, even while a search runs,
+ * - `newgame [11|13]`: starting position of a new game (11x11 by default), the transposition table is emptied,
+ * - `position startpos [moves m1 m2 ...]` or `position <position string> [moves m1 m2 ...]` (see `parsePosition`),
+ * - `moves m1 m2 ...`: plays moves on the current position,
+ * - `go [depth n] [nodes n] [movetime ms] [atime ms] [dtime ms] [ainc ms] [dinc ms] [infinite]`: starts a
+ *   search; `atime`/`dtime` are the clocks of the attacker and the defender and `ainc`/`dinc` their increments,
+ * - `stop`: stops the search, which answers at once with its best move,
+ * - `print`: writes the current position,
+ * - `quit`: stops the search and leaves.
+ *
+ * Moves are written in compact notation ("a4-c4") and go through the rule functions of `itsGame`.
+ * The search runs on its own thread while the commands are still read: every completed depth gives
+ * `info depth d score s nodes n time ms nps n pv m1 m2 ...` (`score win n` for a forced win in n plies,
+ * negative for a loss) and the end of the search gives `bestmove m` (`bestmove none` if the game is over).
+ * Errors are reported as `info string ...` and the faulty command is ignored.
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include "typeDef.h"
+#include "search.h"
+
+/**
+ * @struct Engine
+ * @brief State of the protocol: current position, search thread and output.
+ */
+struct Engine
+{
+    Game itsGame;                   /**< The current position. */
+    int itsPly = 0;                 /**< Moves played since the start of the game (for the time allocation). */
+    TranspositionTable itsTable;    /**< Kept between the searches of a game. */
+    thread itsSearch;               /**< The search thread, if a search was started. */
+    atomic<bool> itsStop{false};    /**< Set to stop the search. */
+    atomic<bool> itsSearching{false}; /**< `true` while the search thread runs. */
+    bool itsInfinite = false;       /**< The search has no limit and only ends on `stop`. */
+    ostream* itsOutput = nullptr;   /**< Where the answers are written. */
+    mutex itsOutputLock;            /**< Keeps the lines of both threads whole. */
+};
+
+/**
+ * @brief Prepares an engine on the 11x11 starting position.
+ *
+ * @param aEngine The engine.
+ * @param aOutput Where the answers are written.
+ */
+void initializeEngine(Engine& aEngine, ostream& aOutput);
+
+/**
+ * @brief Stops the search of an engine and frees its board and table.
+ *
+ * @param aEngine The engine.
+ */
+void releaseEngine(Engine& aEngine);
+
+/**
+ * @brief Carries out one command.
+ *
+ * @param aEngine The engine.
+ * @param aLine The command line.
+ * @return `false` for `quit`, `true` otherwise.
+ */
+bool handleEngineCommand(Engine& aEngine, const string& aLine);
+
+/**
+ * @brief Waits until the search of an engine reaches its end (its limits or `stop`).
+ *
+ * @param aEngine The engine.
+ */
+void waitEngine(Engine& aEngine);
+
+/**
+ * @brief Reads commands until `quit` or the end of the input.
+ *
+ * @param aInput The commands.
+ * @param aOutput Where the answers are written.
+ */
+void runEngine(istream& aInput, ostream& aOutput);
+
+#endif // ENGINE_H
@@ -0,0 +1,284 @@
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+using namespace std;
+#include "evaluation.h"
+
+// haut, bas, gauche, droite
+static const int DIR_ROW[4] = {-1, 1, 0, 0};
+static const int DIR_COL[4] = {0, 0, -1, 1};
+
+const EvalWeights DEFAULT_EVAL_WEIGHTS = {{
+    100,                    // EVAL_SWORDS
+    -150,                   // EVAL_SHIELDS
+    0, 0, 0, 0, 0, 0, 0,    // EVAL_SWORD_RING
+    0, 0, 0, 0, 0, 0, 0,    // EVAL_SHIELD_RING
+    15,                     // EVAL_KING_CORNER_DISTANCE
+    -400,                   // EVAL_KING_ROUTES_1
+    -60,                    // EVAL_KING_ROUTES_2
+    40,                     // EVAL_KING_HOSTILE_SIDES
+    10,                     // EVAL_SWORDS_NEAR_KING
+    -30,                    // EVAL_THREATENED_SWORDS
+    40,                     // EVAL_THREATENED_SHIELDS
+    2,                      // EVAL_ATTACK_MOBILITY
+    -2,                     // EVAL_DEFENSE_MOBILITY
+    -5,                     // EVAL_KING_MOBILITY
+    10                      // EVAL_ATTACK_TO_MOVE
+}};
+
+// anneau d'une case : distance au château en nombre de lignes ou de colonnes
+static int getRing(const Evaluator& aEvaluator, const Position& aPos)
+{
+    return max(abs(aPos.itsRow - aEvaluator.itsCenter), abs(aPos.itsCol - aEvaluator.itsCenter));
+}
+
+// ajoute (aDelta = 1) ou retire (aDelta = -1) une pièce des termes incrémentaux
+static void updatePiece(Evaluator& aEvaluator, PieceType aPiece, const Position& aPos, int aDelta)
+{
+    switch (aPiece) {
+    case SWORD:
+        aEvaluator.itsFeatures[EVAL_SWORDS] += aDelta;
+        aEvaluator.itsFeatures[EVAL_SWORD_RING + getRing(aEvaluator, aPos)] += aDelta;
+        break;
+    case SHIELD:
+        aEvaluator.itsFeatures[EVAL_SHIELDS] += aDelta;
+        aEvaluator.itsFeatures[EVAL_SHIELD_RING + getRing(aEvaluator, aPos)] += aDelta;
+        break;
+    case KING:
+        if (aDelta > 0)
+            aEvaluator.itsKing = aPos;
+        break;
+    default:
+        break;
+    }
+}
+
+static void onMove(void* aContext, PieceType aPiece, const Position& aFrom, const Position& aTo)
+{
+    Evaluator& evaluator = *static_cast<Evaluator*>(aContext);
+    updatePiece(evaluator, aPiece, aFrom, -1);
+    updatePiece(evaluator, aPiece, aTo, 1);
+}
+
+static void onRemove(void* aContext, PieceType aPiece, const Position& aPos)
+{
+    updatePiece(*static_cast<Evaluator*>(aContext), aPiece, aPos, -1);
+}
+
+static void onPlace(void* aContext, PieceType aPiece, const Position& aPos)
+{
+    updatePiece(*static_cast<Evaluator*>(aContext), aPiece, aPos, 1);
+}
+
+// calcul complet des termes incrémentaux
+static void scanPieces(Evaluator& aEvaluator, const Game& aGame)
+{
+    const Board& aBoard = aGame.itsBoard;
+    fill(aEvaluator.itsFeatures, aEvaluator.itsFeatures + EVAL_FEATURE_COUNT, 0);
+    aEvaluator.itsCenter = aBoard.itsSize / 2;
+    aEvaluator.itsKing = {-1, -1};
+    for (int i = 0; i < aBoard.itsSize; ++i)
+        for (int j = 0; j < aBoard.itsSize; ++j)
+            updatePiece(aEvaluator, aBoard.itsCells[i][j].itsPieceType, {i, j}, 1);
+}
+
+void attachEvaluator(Evaluator& aEvaluator, Game& aGame)
+{
+    scanPieces(aEvaluator, aGame);
+    aEvaluator.itsHooks.itsOnMove = onMove;
+    aEvaluator.itsHooks.itsOnRemove = onRemove;
+    aEvaluator.itsHooks.itsOnPlace = onPlace;
+    aEvaluator.itsHooks.itsContext = &aEvaluator;
+    aGame.itsHooks = &aEvaluator.itsHooks;
+}
+
+void detachEvaluator(Evaluator& aEvaluator, Game& aGame)
+{
+    if (aGame.itsHooks == &aEvaluator.itsHooks)
+        aGame.itsHooks = nullptr;
+}
+
+static bool isInside(const Board& aBoard, int aRow, int aCol)
+{
+    return aRow >= 0 && aRow < aBoard.itsSize && aCol >= 0 && aCol < aBoard.itsSize;
+}
+
+// nombre de coups d'une pièce (mêmes règles que generateMoves)
+static int countMoves(const Board& aBoard, int aRow, int aCol, bool aKing)
+{
+    int count = 0;
+    for (int d = 0; d < 4; ++d) {
+        int row = aRow + DIR_ROW[d];
+        int col = aCol + DIR_COL[d];
+        while (isInside(aBoard, row, col) && aBoard.itsCells[row][col].itsPieceType == NONE
+               && (aKing || aBoard.itsCells[row][col].itsCellType == NORMAL)) {
+            count++;
+            row += DIR_ROW[d];
+            col += DIR_COL[d];
+        }
+    }
+    return count;
+}
+
+// forteresses atteintes par le roi en glissant depuis une case (un bit par coin)
+static int getReachedCorners(const Board& aBoard, int aRow, int aCol)
+{
+    int corners = 0;
+    for (int d = 0; d < 4; ++d) {
+        int row = aRow + DIR_ROW[d];
+        int col = aCol + DIR_COL[d];
+        while (isInside(aBoard, row, col) && aBoard.itsCells[row][col].itsPieceType == NONE) {
+            if (aBoard.itsCells[row][col].itsCellType == FORTRESS)
+                corners |= 1 << ((row != 0) * 2 + (col != 0));
+            row += DIR_ROW[d];
+            col += DIR_COL[d];
+        }
+    }
+    return corners;
+}
+
+// une case vide peut-elle être atteinte en un coup par une pièce qui prend ?
+static bool isReachableBy(const Board& aBoard, int aRow, int aCol, bool aAttack)
+{
+    for (int d = 0; d < 4; ++d) {
+        int row = aRow + DIR_ROW[d];
+        int col = aCol + DIR_COL[d];
+        while (isInside(aBoard, row, col) && aBoard.itsCells[row][col].itsPieceType == NONE
+               && aBoard.itsCells[row][col].itsCellType == NORMAL) {
+            row += DIR_ROW[d];
+            col += DIR_COL[d];
+        }
+        if (!isInside(aBoard, row, col))
+            continue;
+        PieceType piece = aBoard.itsCells[row][col].itsPieceType;
+        if (aAttack ? piece == SWORD : (piece == SHIELD || piece == KING))
+            return true;
+    }
+    return false;
+}
+
+// case hostile pour une pièce prise par l'attaque (bouclier) ou par la défense (épée), comme dans capturePieces
+static bool isHostile(const Cell& aCell, bool aByAttack)
+{
+    if (aByAttack)
+        return aCell.itsPieceType == SWORD || aCell.itsCellType == FORTRESS
+               || (aCell.itsCellType == CASTLE && aCell.itsPieceType == NONE);
+    return aCell.itsPieceType == SHIELD || aCell.itsPieceType == KING || aCell.itsCellType != NORMAL;
+}
+
+// la pièce peut-elle être prise au prochain coup adverse ?
+static bool isThreatened(const Board& aBoard, int aRow, int aCol, bool aByAttack)
+{
+    for (int d = 0; d < 4; ++d) {
+        int hostileRow = aRow - DIR_ROW[d];
+        int hostileCol = aCol - DIR_COL[d];
+        int emptyRow = aRow + DIR_ROW[d];
+        int emptyCol = aCol + DIR_COL[d];
+        if (!isInside(aBoard, hostileRow, hostileCol) || !isInside(aBoard, emptyRow, emptyCol))
+            continue;
+        const Cell& empty = aBoard.itsCells[emptyRow][emptyCol];
+        if (isHostile(aBoard.itsCells[hostileRow][hostileCol], aByAttack) && empty.itsPieceType == NONE
+            && empty.itsCellType == NORMAL && isReachableBy(aBoard, emptyRow, emptyCol, aByAttack))
+            return true;
+    }
+    return false;
+}
+
+void computeFeatures(const Evaluator& aEvaluator, const Game& aGame, int* aFeatures)
+{
+    const Board& aBoard = aGame.itsBoard;
+    copy(aEvaluator.itsFeatures, aEvaluator.itsFeatures + EVAL_FEATURE_COUNT, aFeatures);
+    aFeatures[EVAL_ATTACK_TO_MOVE] = (aGame.itsCurrentPlayer->itsRole == ATTACK) ? 1 : 0;
+
+    // pièces : menaces et mobilité
+    for (int i = 0; i < aBoard.itsSize; ++i) {
+        for (int j = 0; j < aBoard.itsSize; ++j) {
+            PieceType piece = aBoard.itsCells[i][j].itsPieceType;
+            if (piece == SWORD) {
+                aFeatures[EVAL_ATTACK_MOBILITY] += countMoves(aBoard, i, j, false);
+                aFeatures[EVAL_THREATENED_SWORDS] += isThreatened(aBoard, i, j, false);
+            }
+            else if (piece == SHIELD) {
+                aFeatures[EVAL_DEFENSE_MOBILITY] += countMoves(aBoard, i, j, false);
+                aFeatures[EVAL_THREATENED_SHIELDS] += isThreatened(aBoard, i, j, true);
+            }
+        }
+    }
+
+    int row = aEvaluator.itsKing.itsRow;
+    int col = aEvaluator.itsKing.itsCol;
+    if (row < 0)
+        return;
+    int last = aBoard.itsSize - 1;
+    aFeatures[EVAL_KING_MOBILITY] = countMoves(aBoard, row, col, true);
+    aFeatures[EVAL_KING_CORNER_DISTANCE] = min(row, last - row) + min(col, last - col);
+
+    // chemins vers les forteresses en un et deux coups
+    int oneMove = getReachedCorners(aBoard, row, col);
+    int twoMoves = 0;
+    for (int d = 0; d < 4; ++d) {
+        int r = row + DIR_ROW[d];
+        int c = col + DIR_COL[d];
+        while (isInside(aBoard, r, c) && aBoard.itsCells[r][c].itsPieceType == NONE) {
+            twoMoves |= getReachedCorners(aBoard, r, c);
+            r += DIR_ROW[d];
+            c += DIR_COL[d];
+        }
+    }
+    aFeatures[EVAL_KING_ROUTES_1] = __builtin_popcount(oneMove);
+    aFeatures[EVAL_KING_ROUTES_2] = __builtin_popcount(twoMoves & ~oneMove);
+
+    // encerclement du roi (mêmes côtés que isKingCaptured)
+    for (int d = 0; d < 4; ++d) {
+        int r = row + DIR_ROW[d];
+        int c = col + DIR_COL[d];
+        if (!isInside(aBoard, r, c) || aBoard.itsCells[r][c].itsPieceType == SWORD || aBoard.itsCells[r][c].itsCellType != NORMAL)
+            aFeatures[EVAL_KING_HOSTILE_SIDES]++;
+    }
+    for (int r = max(0, row - 2); r <= min(last, row + 2); ++r)
+        for (int c = max(0, col - 2); c <= min(last, col + 2); ++c)
+            aFeatures[EVAL_SWORDS_NEAR_KING] += (aBoard.itsCells[r][c].itsPieceType == SWORD);
+}
+
+// score pour le joueur qui a le trait
+static int scoreFeatures(const Game& aGame, const int* aFeatures, const EvalWeights& aWeights)
+{
+    int score = 0;
+    for (int f = 0; f < EVAL_FEATURE_COUNT; ++f)
+        score += aWeights.itsValues[f] * aFeatures[f];
+    return (aGame.itsCurrentPlayer->itsRole == ATTACK) ? score : -score;
+}
+
+int evaluate(const Evaluator& aEvaluator, const Game& aGame, const EvalWeights& aWeights)
+{
+    int features[EVAL_FEATURE_COUNT];
+    computeFeatures(aEvaluator, aGame, features);
+    return scoreFeatures(aGame, features, aWeights);
+}
+
+int evaluatePosition(const Game& aGame, const EvalWeights& aWeights)
+{
+    Evaluator evaluator;
+    scanPieces(evaluator, aGame);
+    return evaluate(evaluator, aGame, aWeights);
+}
+
+bool loadEvalWeights(EvalWeights& aWeights, const string& aPath)
+{
+    ifstream in(aPath);
+    EvalWeights weights;
+    for (int f = 0; f < EVAL_FEATURE_COUNT; ++f) {
+        if (!(in >> weights.itsValues[f]))
+            return false;
+    }
+    aWeights = weights;
+    return true;
+}
+
+bool saveEvalWeights(const EvalWeights& aWeights, const string& aPath)
+{
+    ofstream out(aPath, ios::trunc);
+    for (int f = 0; f < EVAL_FEATURE_COUNT; ++f)
+        out << aWeights.itsValues[f] << "\n";
+    return bool(out);
+}
@@ -0,0 +1,144 @@
+/**
+ * @file evaluation.h
+ *
+ * @brief Hand-crafted evaluation of a position.
+ *
+ * The score is a weighted sum of features (material, piece placement, king distance and open
+ * lines to the fortresses, encirclement of the king, pieces that can be captured at the next
+ * move, mobility). It is linear in the weights so they can be tuned from game records.
+ *
+ * Features that only depend on the cells of the pieces (material and rings around the castle)
+ * are kept up to date by the `GameHooks` of the game: `movePiece`, `capturePieces` and
+ * `unmakeMove` report the moved and captured cells, so they never rescan the board.
+ * The other features depend on the lines around the pieces and are computed when evaluating.
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+#include "typeDef.h"
+
+/**
+ * @brief Number of square rings around the castle (7 on the 13x13 board, the castle being ring 0).
+ */
+const int EVAL_RINGS = 7;
+
+/**
+ * @enum EvalFeature
+ * @brief Features of a position, counted from the point of view of the attacker.
+ */
+enum EvalFeature
+{
+    EVAL_SWORDS,                                        /**< Number of swords. */
+    EVAL_SHIELDS,                                       /**< Number of shields. */
+    EVAL_SWORD_RING,                                    /**< Swords on each ring (`EVAL_RINGS` features). */
+    EVAL_SHIELD_RING = EVAL_SWORD_RING + EVAL_RINGS,    /**< Shields on each ring (`EVAL_RINGS` features). */
+    EVAL_KING_CORNER_DISTANCE = EVAL_SHIELD_RING + EVAL_RINGS, /**< Distance from the king to the nearest fortress. */
+    EVAL_KING_ROUTES_1,                                 /**< Fortresses the king reaches in one move. */
+    EVAL_KING_ROUTES_2,                                 /**< Other fortresses the king reaches in two moves. */
+    EVAL_KING_HOSTILE_SIDES,                            /**< Sides of the king closed by a sword, a special cell or the edge. */
+    EVAL_SWORDS_NEAR_KING,                              /**< Swords at most 2 cells away from the king. */
+    EVAL_THREATENED_SWORDS,                             /**< Swords the defense can capture at its next move. */
+    EVAL_THREATENED_SHIELDS,                            /**< Shields the attack can capture at its next move. */
+    EVAL_ATTACK_MOBILITY,                               /**< Moves of the swords. */
+    EVAL_DEFENSE_MOBILITY,                              /**< Moves of the shields. */
+    EVAL_KING_MOBILITY,                                 /**< Moves of the king. */
+    EVAL_ATTACK_TO_MOVE,                                /**< 1 if the attack is to move. */
+    EVAL_FEATURE_COUNT                                  /**< Number of features. */
+};
+
+/**
+ * @struct EvalWeights
+ * @brief Weight of each feature; a positive weight favours the attack.
+ */
+struct EvalWeights
+{
+    int itsValues[EVAL_FEATURE_COUNT]; /**< Weights, indexed by `EvalFeature`. */
+};
+
+/**
+ * @brief Hand-chosen weights (a sword is worth 100).
+ */
+extern const EvalWeights DEFAULT_EVAL_WEIGHTS;
+
+/**
+ * @struct Evaluator
+ * @brief Incremental features of a game.
+ *
+ * Once attached, the evaluator is referenced by the game (`itsHooks`), so it must not be
+ * moved or destroyed before `detachEvaluator`.
+ */
+struct Evaluator
+{
+    int itsFeatures[EVAL_FEATURE_COUNT] = {}; /**< Incremental features (the others stay 0). */
+    Position itsKing = {-1, -1};              /**< Cell of the king. */
+    int itsCenter = 0;                        /**< Row and column of the castle. */
+    GameHooks itsHooks;                       /**< Hooks installed in the game. */
+};
+
+/**
+ * @brief Computes the incremental features of a game and installs the hooks that keep them up to date.
+ *
+ * @param aEvaluator The evaluator.
+ * @param aGame The game (its board must exist).
+ */
+void attachEvaluator(Evaluator& aEvaluator, Game& aGame);
+
+/**
+ * @brief Removes the hooks of an evaluator from a game.
+ *
+ * @param aEvaluator The evaluator.
+ * @param aGame The game.
+ */
+void detachEvaluator(Evaluator& aEvaluator, Game& aGame);
+
+/**
+ * @brief Computes every feature of a position.
+ *
+ * @param aEvaluator The evaluator attached to the game.
+ * @param aGame The game.
+ * @param aFeatures An array of `EVAL_FEATURE_COUNT` values receiving the features.
+ */
+void computeFeatures(const Evaluator& aEvaluator, const Game& aGame, int* aFeatures);
+
+/**
+ * @brief Evaluates a position.
+ *
+ * @param aEvaluator The evaluator attached to the game.
+ * @param aGame The game.
+ * @param aWeights The weights of the features.
+ * @return The score for the player to move (positive if the position favours them).
+ */
+int evaluate(const Evaluator& aEvaluator, const Game& aGame, const EvalWeights& aWeights = DEFAULT_EVAL_WEIGHTS);
+
+/**
+ * @brief Evaluates a position from scratch, without hooks.
+ *
+ * @param aGame The game.
+ * @param aWeights The weights of the features.
+ * @return The score for the player to move.
+ */
+int evaluatePosition(const Game& aGame, const EvalWeights& aWeights = DEFAULT_EVAL_WEIGHTS);
+
+/**
+ * @brief Reads weights written by `saveEvalWeights`.
+ *
+ * @param aWeights Receives the weights.
+ * @param aPath The path of the weight file.
+ * @return `false` if the file cannot be read or does not hold `EVAL_FEATURE_COUNT` weights.
+ */
+bool loadEvalWeights(EvalWeights& aWeights, const string& aPath);
+
+/**
+ * @brief Writes weights to a text file, one per line in the order of `EvalFeature`.
+ *
+ * @param aWeights The weights.
+ * @param aPath The path of the weight file.
+ * @return `true` if the file was written.
+ */
+bool saveEvalWeights(const EvalWeights& aWeights, const string& aPath);
+
+#endif // EVALUATION_H
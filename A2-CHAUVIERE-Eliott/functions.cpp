@@ -1,16 +1,16 @@
 #include <iostream>
 #include <cctype>
 #include <cstdlib>
-#include <windows.h>
 using namespace std;
 #include "functions.h"
+#include "render.h"
 
 extern int defaultColor;
 
-void color(int txtColor,int bgColor) // fonction d'affichage de couleurs
+void color(int txtColor,int bgColor) // fonction d'affichage de couleurs (sequences ANSI)
 {
-    HANDLE H=GetStdHandle(STD_OUTPUT_HANDLE);
-    SetConsoleTextAttribute(H,bgColor*16+txtColor);
+    enableAnsiOutput();
+    cout<<getAnsiColor(txtColor,bgColor);
 }
 
 void clearConsole();
@@ -53,7 +53,7 @@ bool chooseSizeBoard(BoardSize& aBoardSize){
 
 bool createBoard(Board& aBoard){
     try {
-        aBoard.itsCells = new Cell*[aBoard.itsSize];
+        aBoard.itsCells = new Cell*[aBoard.itsSize]();
         for (int i = 0; i < aBoard.itsSize; ++i) {
             aBoard.itsCells[i] = new Cell[aBoard.itsSize];
         }
@@ -65,72 +65,22 @@ bool createBoard(Board& aBoard){
 
 }
 
-void deleteBoard(Board& aBoard){}
-
-void displayBoard(const Board& aBoard)
-{
-    char letter='A';
-    int number=1;
-    char piece;
-    cout<<endl<<"    ";
-    for (int i = 0; i < aBoard.itsSize; ++i) { //première ligne avec nombres
-        if (number<10) cout<<"  "<<number++<<" ";
-        else cout<<" "<<number++<<" ";
-    }cout<<" ";
-
+void deleteBoard(Board& aBoard){
+    if (aBoard.itsCells == nullptr) //plateau déjà libéré
+        return;
     for (int i = 0; i < aBoard.itsSize; ++i) {
-
-        cout<<endl<<"    +";
-        for (int j = 0; j < aBoard.itsSize; ++j) { //lignes de delimitation
-            cout<<"---+";
-        }
-
-        cout<<endl<<"  "<<letter++<<" "; //début avec lettre
-        for (int j = 0; j < aBoard.itsSize; ++j) { //lignes avec valeurs
-            cout<<"| ";
-            switch (aBoard.itsCells[i][j].itsPieceType) {
-            case NONE:
-                switch (aBoard.itsCells[i][j].itsCellType) {
-                case NORMAL:
-                    piece=' ';
-                    break;
-                case FORTRESS:
-                    color(8,0);
-                    piece='#';
-                    break;
-                case CASTLE:
-                    color(7,0);
-                    piece='^';
-                    break;
-                default:
-                    break;// ░▒▓  °±²
-                }
-                break;
-            case SHIELD:
-                color(9,0);
-                piece='U';
-                break;
-            case SWORD:
-                color(12,0);
-                piece='X';
-                break;
-            case KING:
-                color(4,0);
-                piece='K';
-                break;
-            default:
-                break;
-            }
-            cout<< piece <<" ";
-            color(defaultColor,0);
-        }cout<<"|";
+        delete[] aBoard.itsCells[i];
     }
+    delete[] aBoard.itsCells;
+    aBoard.itsCells = nullptr;
+}
 
-    cout<<endl<<"    +";
-    for (int i = 0; i < aBoard.itsSize; ++i) { //dernière ligne
-        cout<<"---+";
-    }
-    cout<<endl;
+void displayBoard(const Board& aBoard)
+{
+    BoardRenderer renderer;  //image composee en memoire puis ecrite d'un coup
+    composeFrame(renderer,aBoard,false);
+    cout<<flush;
+    flushFrame(renderer);
 }
 
 void initializeBoard(Board& aBoard){
@@ -357,6 +307,17 @@ void movePiece(Game& aGame, const Move& aMove)
 {
     aGame.itsBoard.itsCells[aMove.itsEndPosition.itsRow][aMove.itsEndPosition.itsCol].itsPieceType = aGame.itsBoard.itsCells[aMove.itsStartPosition.itsRow][aMove.itsStartPosition.itsCol].itsPieceType;
     aGame.itsBoard.itsCells[aMove.itsStartPosition.itsRow][aMove.itsStartPosition.itsCol].itsPieceType = NONE;
+    if (aGame.itsHooks != nullptr)
+        aGame.itsHooks->itsOnMove(aGame.itsHooks->itsContext, aGame.itsBoard.itsCells[aMove.itsEndPosition.itsRow][aMove.itsEndPosition.itsCol].itsPieceType, aMove.itsStartPosition, aMove.itsEndPosition);
+}
+
+// retire une pièce prise et prévient les observateurs du plateau
+static void removeCapturedPiece(Game& aGame, const Position& aPos)
+{
+    PieceType piece = aGame.itsBoard.itsCells[aPos.itsRow][aPos.itsCol].itsPieceType;
+    aGame.itsBoard.itsCells[aPos.itsRow][aPos.itsCol].itsPieceType = NONE;
+    if (aGame.itsHooks != nullptr)
+        aGame.itsHooks->itsOnRemove(aGame.itsHooks->itsContext, piece, aPos);
 }
 
 void capturePieces(Game& aGame, const Move& aMove)   // PLACE THE KING EVERYWHERE AND DUPLICATE FOR THE DEFENSOR
@@ -374,7 +335,7 @@ void capturePieces(Game& aGame, const Move& aMove)   // PLACE THE KING EVERYWHER
                     && aGame.itsBoard.itsCells[aMove.itsEndPosition.itsRow+2][aMove.itsEndPosition.itsCol].itsPieceType == NONE) ) )
             {
                 //delete piece (end+1,end)
-                aGame.itsBoard.itsCells[aMove.itsEndPosition.itsRow+1][aMove.itsEndPosition.itsCol].itsPieceType = NONE;
+                removeCapturedPiece(aGame,{aMove.itsEndPosition.itsRow+1,aMove.itsEndPosition.itsCol});
             }
         }
         /* LEFT */
@@ -387,7 +348,7 @@ void capturePieces(Game& aGame, const Move& aMove)   // PLACE THE KING EVERYWHER
                 || (aGame.itsBoard.itsCells[aMove.itsEndPosition.itsRow-2][aMove.itsEndPosition.itsCol].itsCellType == CASTLE
                     && aGame.itsBoard.itsCells[aMove.itsEndPosition.itsRow-2][aMove.itsEndPosition.itsCol].itsPieceType == NONE) ) )
             {
-                aGame.itsBoard.itsCells[aMove.itsEndPosition.itsRow-1][aMove.itsEndPosition.itsCol].itsPieceType = NONE;
+                removeCapturedPiece(aGame,{aMove.itsEndPosition.itsRow-1,aMove.itsEndPosition.itsCol});
             }
         }
         /* UP */
@@ -400,7 +361,7 @@ void capturePieces(Game& aGame, const Move& aMove)   // PLACE THE KING EVERYWHER
                 || (aGame.itsBoard.itsCells[aMove.itsEndPosition.itsRow][aMove.itsEndPosition.itsCol-2].itsCellType == CASTLE
                     && aGame.itsBoard.itsCells[aMove.itsEndPosition.itsRow][aMove.itsEndPosition.itsCol-2].itsPieceType == NONE) ) )
             {
-                aGame.itsBoard.itsCells[aMove.itsEndPosition.itsRow][aMove.itsEndPosition.itsCol-1].itsPieceType = NONE;
+                removeCapturedPiece(aGame,{aMove.itsEndPosition.itsRow,aMove.itsEndPosition.itsCol-1});
             }
         }
         /* DOWN */
@@ -413,7 +374,7 @@ void capturePieces(Game& aGame, const Move& aMove)   // PLACE THE KING EVERYWHER
                 || (aGame.itsBoard.itsCells[aMove.itsEndPosition.itsRow][aMove.itsEndPosition.itsCol+2].itsCellType == CASTLE
                     && aGame.itsBoard.itsCells[aMove.itsEndPosition.itsRow][aMove.itsEndPosition.itsCol+2].itsPieceType == NONE) ) )
             {
-                aGame.itsBoard.itsCells[aMove.itsEndPosition.itsRow][aMove.itsEndPosition.itsCol+1].itsPieceType = NONE;
+                removeCapturedPiece(aGame,{aMove.itsEndPosition.itsRow,aMove.itsEndPosition.itsCol+1});
             }
         }
     }
@@ -429,7 +390,7 @@ void capturePieces(Game& aGame, const Move& aMove)   // PLACE THE KING EVERYWHER
                 || aGame.itsBoard.itsCells[aMove.itsEndPosition.itsRow+2][aMove.itsEndPosition.itsCol].itsCellType != NORMAL ) )
             {
                 //delete piece (end+1,end)
-                aGame.itsBoard.itsCells[aMove.itsEndPosition.itsRow+1][aMove.itsEndPosition.itsCol].itsPieceType = NONE;
+                removeCapturedPiece(aGame,{aMove.itsEndPosition.itsRow+1,aMove.itsEndPosition.itsCol});
             }
         }
         /* LEFT */
@@ -441,7 +402,7 @@ void capturePieces(Game& aGame, const Move& aMove)   // PLACE THE KING EVERYWHER
                 || (aGame.itsBoard.itsCells[aMove.itsEndPosition.itsRow-2][aMove.itsEndPosition.itsCol].itsPieceType == KING)
                 || (aGame.itsBoard.itsCells[aMove.itsEndPosition.itsRow-2][aMove.itsEndPosition.itsCol].itsCellType != NORMAL) ) )
             {
-                aGame.itsBoard.itsCells[aMove.itsEndPosition.itsRow-1][aMove.itsEndPosition.itsCol].itsPieceType = NONE;
+                removeCapturedPiece(aGame,{aMove.itsEndPosition.itsRow-1,aMove.itsEndPosition.itsCol});
             }
         }
         /* UP */
@@ -453,7 +414,7 @@ void capturePieces(Game& aGame, const Move& aMove)   // PLACE THE KING EVERYWHER
             || (aGame.itsBoard.itsCells[aMove.itsEndPosition.itsRow][aMove.itsEndPosition.itsCol-2].itsPieceType == KING)
             || (aGame.itsBoard.itsCells[aMove.itsEndPosition.itsRow][aMove.itsEndPosition.itsCol-2].itsCellType != NORMAL) ) )
             {
-                aGame.itsBoard.itsCells[aMove.itsEndPosition.itsRow][aMove.itsEndPosition.itsCol-1].itsPieceType = NONE;
+                removeCapturedPiece(aGame,{aMove.itsEndPosition.itsRow,aMove.itsEndPosition.itsCol-1});
             }
         }
         /* DOWN */
@@ -465,7 +426,7 @@ void capturePieces(Game& aGame, const Move& aMove)   // PLACE THE KING EVERYWHER
                 || (aGame.itsBoard.itsCells[aMove.itsEndPosition.itsRow][aMove.itsEndPosition.itsCol+2].itsPieceType == KING)
                 || (aGame.itsBoard.itsCells[aMove.itsEndPosition.itsRow][aMove.itsEndPosition.itsCol+2].itsCellType != NORMAL) ) )
             {
-                aGame.itsBoard.itsCells[aMove.itsEndPosition.itsRow][aMove.itsEndPosition.itsCol+1].itsPieceType = NONE;
+                removeCapturedPiece(aGame,{aMove.itsEndPosition.itsRow,aMove.itsEndPosition.itsCol+1});
             }
         }
     }
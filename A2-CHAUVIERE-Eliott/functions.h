@@ -20,6 +20,7 @@
  *
  * This function change the default color settings of the terminal, with two paramaters, the color
  * of the text and the color of the background.
+ * The colors are written as ANSI escape sequences; 0 on 0 restores the colors of the terminal.
  *
  * @param txtColor The text color
  * @param bgColor The background color
@@ -230,6 +231,8 @@ bool isValidMovement(const Game& aGame, const Move& aMove);
  * @param aGame The `Game` object representing the current game state,
  *        including the board and other game information.
  * @param aMove The `Move` object containing the starting and ending positions for the piece movement.
+ *
+ * **Note:** If the game has hooks (`itsHooks`), `itsOnMove` is called after the move.
  */
 void movePiece(Game& aGame, const Move& aMove);
 
@@ -253,6 +256,7 @@ void movePiece(Game& aGame, const Move& aMove);
  * **Note**:
  * - The function assumes the move has already been validated and executed.
  * - It modifies the game board to reflect any captures.
+ * - If the game has hooks (`itsHooks`), `itsOnRemove` is called for each captured piece.
  */
 void capturePieces(Game& aGame, const Move& aMove);
 
@@ -0,0 +1,259 @@
+using namespace std;
+#include "gameflow.h"
+#include "functions.h"
+#include "movegen.h"
+
+// nouveau tour : la pendule du joueur actif tourne, sauf s'il n'a aucun coup
+static void startTurn(GameFlow& aFlow, int64_t aNow)
+{
+    Move moves[MAX_MOVES];
+    if (generateMoves(aFlow.itsGame, moves) == 0) {
+        endFlow(aFlow, FLOW_BLOCKED);
+        return;
+    }
+    aFlow.itsState = FLOW_WAITING;
+    startClock(aFlow.itsClock, aFlow.itsGame.itsCurrentPlayer->itsRole, aNow);
+}
+
+static void finishFlow(GameFlow& aFlow, FlowEnd aEnd)
+{
+    aFlow.itsState = FLOW_FINISHED;
+    aFlow.itsEnd = aEnd;
+    aFlow.itsClock.itsRunning = -1;
+}
+
+bool startFlow(GameFlow& aFlow, BoardSize aSize, const TimeControl& aControl, int64_t aNow)
+{
+    Board& board = aFlow.itsGame.itsBoard;
+    if (board.itsCells != nullptr && board.itsSize != aSize)
+        deleteBoard(board);
+    if (board.itsCells == nullptr) {
+        board.itsSize = aSize;
+        if (!createBoard(board))
+            return false;
+    }
+    initializeBoard(board);
+    aFlow.itsGame.itsCurrentPlayer = &aFlow.itsGame.itsPlayer1;
+    initializeClock(aFlow.itsClock, aControl);
+    aFlow.itsPly = 0;
+    startTurn(aFlow, aNow);
+    return true;
+}
+
+FlowResult playFlowMove(GameFlow& aFlow, const Move& aMove, int64_t aNow)
+{
+    if (aFlow.itsState != FLOW_WAITING || !isValidPosition(aMove.itsStartPosition, aFlow.itsGame.itsBoard)
+        || !isValidPosition(aMove.itsEndPosition, aFlow.itsGame.itsBoard) || !isValidMovement(aFlow.itsGame, aMove))
+        return FLOW_REFUSED;
+    // temps dépassé : le coup ne compte pas
+    if (!stopClock(aFlow.itsClock, aNow)) {
+        finishFlow(aFlow, FLOW_FLAGGED);
+        return FLOW_OVER;
+    }
+    if (aFlow.itsHooks != nullptr && aFlow.itsHooks->itsOnMove != nullptr)
+        aFlow.itsHooks->itsOnMove(aFlow.itsHooks->itsContext, aFlow, aMove);
+    movePiece(aFlow.itsGame, aMove);
+    capturePieces(aFlow.itsGame, aMove);
+    aFlow.itsPly++;
+    if (isGameFinished(aFlow.itsGame)) {
+        finishFlow(aFlow, FLOW_WON);
+        return FLOW_OVER;
+    }
+    switchCurrentPlayer(aFlow.itsGame);
+    startTurn(aFlow, aNow);
+    return (aFlow.itsState == FLOW_WAITING) ? FLOW_PLAYED : FLOW_OVER;
+}
+
+bool checkFlowClock(GameFlow& aFlow, int64_t aNow)
+{
+    if (aFlow.itsState == FLOW_WAITING && getTimeToFlag(aFlow.itsClock, aFlow.itsGame.itsCurrentPlayer->itsRole, aNow) <= 0) {
+        aFlow.itsClock.itsFlagged[aFlow.itsGame.itsCurrentPlayer->itsRole] = true;
+        finishFlow(aFlow, FLOW_FLAGGED);
+    }
+    return aFlow.itsState == FLOW_FINISHED;
+}
+
+int64_t getFlowDeadline(const GameFlow& aFlow, int64_t aNow)
+{
+    if (aFlow.itsState != FLOW_WAITING)
+        return INT64_MAX;
+    int64_t left = getTimeToFlag(aFlow.itsClock, aFlow.itsGame.itsCurrentPlayer->itsRole, aNow);
+    return (left == INT64_MAX) ? INT64_MAX : aNow + left;
+}
+
+void endFlow(GameFlow& aFlow, FlowEnd aEnd)
+{
+    finishFlow(aFlow, aEnd);
+}
+
+const Player* getFlowWinner(const GameFlow& aFlow)
+{
+    const Game& game = aFlow.itsGame;
+    const Player* opponent = (game.itsCurrentPlayer == &game.itsPlayer1) ? &game.itsPlayer2 : &game.itsPlayer1;
+    switch (aFlow.itsEnd) {
+    case FLOW_WON:
+        return whoWon(game);
+    case FLOW_FLAGGED:
+    case FLOW_BLOCKED:
+        return opponent;
+    default:
+        return nullptr;
+    }
+}
+
+// le joueur attendu est prévenu, et sa pendule surveillée
+static void watchDeadline(FlowScheduler& aScheduler, GameFlow& aFlow, int64_t aDeadline)
+{
+    if (aFlow.itsDeadline != INT64_MAX)
+        aScheduler.itsDeadlines.erase({aFlow.itsDeadline, aFlow.itsId});
+    aFlow.itsDeadline = aDeadline;
+    if (aDeadline != INT64_MAX)
+        aScheduler.itsDeadlines.insert({aDeadline, aFlow.itsId});
+}
+
+static void requestMove(FlowScheduler& aScheduler, GameFlow& aFlow, int64_t aNow)
+{
+    watchDeadline(aScheduler, aFlow, getFlowDeadline(aFlow, aNow));
+    if (aFlow.itsHooks != nullptr && aFlow.itsHooks->itsOnRequest != nullptr)
+        aFlow.itsHooks->itsOnRequest(aFlow.itsHooks->itsContext, aFlow);
+}
+
+static void closeGame(FlowScheduler& aScheduler, uint32_t aId)
+{
+    auto found = aScheduler.itsGames.find(aId);
+    GameFlow& flow = *found->second;
+    watchDeadline(aScheduler, flow, INT64_MAX);
+    if (flow.itsHooks != nullptr && flow.itsHooks->itsOnEnd != nullptr)
+        flow.itsHooks->itsOnEnd(flow.itsHooks->itsContext, flow);
+    deleteBoard(flow.itsGame.itsBoard);
+    aScheduler.itsGames.erase(found);
+    aScheduler.itsLiveGames--;
+}
+
+static void handleEvent(FlowScheduler& aScheduler, const FlowEvent& aEvent)
+{
+    auto found = aScheduler.itsGames.find(aEvent.itsId);
+    if (found == aScheduler.itsGames.end())
+        return;
+    GameFlow& flow = *found->second;
+    if (aEvent.itsAbort) {
+        endFlow(flow, FLOW_ABORTED);
+        closeGame(aScheduler, aEvent.itsId);
+        return;
+    }
+    FlowResult result = playFlowMove(flow, aEvent.itsMove, aEvent.itsTime);
+    if (result != FLOW_REFUSED)
+        aScheduler.itsMoves++;
+    if (result == FLOW_OVER)
+        closeGame(aScheduler, aEvent.itsId);
+    else
+        requestMove(aScheduler, flow, aEvent.itsTime);
+}
+
+static void runScheduler(FlowScheduler& aScheduler)
+{
+    vector<FlowEvent> events;
+    vector<pair<uint32_t, unique_ptr<GameFlow>>> added;
+    unique_lock<mutex> lock(aScheduler.itsLock);
+    while (!aScheduler.itsStop) {
+        // attente jusqu'au prochain drapeau possible, ou jusqu'à un coup posté
+        auto ready = [&aScheduler]() { return aScheduler.itsStop || !aScheduler.itsInbox.empty() || !aScheduler.itsAdded.empty(); };
+        if (aScheduler.itsDeadlines.empty())
+            aScheduler.itsWake.wait(lock, ready);
+        else {
+            int64_t wait = aScheduler.itsDeadlines.begin()->first - getClockTime();
+            if (wait > 0)
+                aScheduler.itsWake.wait_for(lock, chrono::microseconds(wait), ready);
+        }
+        events.swap(aScheduler.itsInbox);
+        added.swap(aScheduler.itsAdded);
+        lock.unlock();
+
+        int64_t now = getClockTime();
+        for (auto& game : added) {
+            GameFlow& flow = *game.second;
+            flow.itsId = game.first;
+            aScheduler.itsGames[game.first] = move(game.second);
+            startFlow(flow, flow.itsGame.itsBoard.itsSize, flow.itsClock.itsControl, now);
+            if (flow.itsState == FLOW_FINISHED)
+                closeGame(aScheduler, game.first);
+            else
+                requestMove(aScheduler, flow, now);
+        }
+        added.clear();
+        for (const FlowEvent& event : events)
+            handleEvent(aScheduler, event);
+        events.clear();
+
+        // drapeaux tombés
+        now = getClockTime();
+        while (!aScheduler.itsDeadlines.empty() && aScheduler.itsDeadlines.begin()->first <= now) {
+            uint32_t id = aScheduler.itsDeadlines.begin()->second;
+            GameFlow& flow = *aScheduler.itsGames[id];
+            if (checkFlowClock(flow, now))
+                closeGame(aScheduler, id);
+            else
+                watchDeadline(aScheduler, flow, getFlowDeadline(flow, now));
+        }
+        lock.lock();
+    }
+}
+
+void startScheduler(FlowScheduler& aScheduler)
+{
+    aScheduler.itsStop = false;
+    aScheduler.itsThread = thread(runScheduler, ref(aScheduler));
+}
+
+void stopScheduler(FlowScheduler& aScheduler)
+{
+    {
+        lock_guard<mutex> lock(aScheduler.itsLock);
+        aScheduler.itsStop = true;
+    }
+    aScheduler.itsWake.notify_one();
+    if (aScheduler.itsThread.joinable())
+        aScheduler.itsThread.join();
+    for (auto& game : aScheduler.itsGames)
+        deleteBoard(game.second->itsGame.itsBoard);
+    aScheduler.itsGames.clear();
+    aScheduler.itsAdded.clear();
+    aScheduler.itsInbox.clear();
+    aScheduler.itsDeadlines.clear();
+    aScheduler.itsLiveGames = 0;
+}
+
+uint32_t scheduleGame(FlowScheduler& aScheduler, unique_ptr<GameFlow> aFlow, BoardSize aSize, const TimeControl& aControl)
+{
+    // taille et cadence gardées dans la partie jusqu'à son départ sur le fil du planificateur
+    aFlow->itsGame.itsBoard.itsSize = aSize;
+    aFlow->itsClock.itsControl = aControl;
+    uint32_t id = aScheduler.itsNextId++;
+    aScheduler.itsLiveGames++;
+    {
+        lock_guard<mutex> lock(aScheduler.itsLock);
+        aScheduler.itsAdded.emplace_back(id, move(aFlow));
+    }
+    aScheduler.itsWake.notify_one();
+    return id;
+}
+
+void postFlowMove(FlowScheduler& aScheduler, uint32_t aId, const Move& aMove)
+{
+    FlowEvent event = {aId, false, aMove, getClockTime()};
+    {
+        lock_guard<mutex> lock(aScheduler.itsLock);
+        aScheduler.itsInbox.push_back(event);
+    }
+    aScheduler.itsWake.notify_one();
+}
+
+void abortFlowGame(FlowScheduler& aScheduler, uint32_t aId)
+{
+    FlowEvent event = {aId, true, Move(), getClockTime()};
+    {
+        lock_guard<mutex> lock(aScheduler.itsLock);
+        aScheduler.itsInbox.push_back(event);
+    }
+    aScheduler.itsWake.notify_one();
+}
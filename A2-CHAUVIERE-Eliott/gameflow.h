@@ -0,0 +1,236 @@
+/**
+ * @file gameflow.h
+ *
+ * @brief The turn loop of a game as an explicit state machine, and a scheduler driving many
+ *        games from one thread.
+ *
+ * A `GameFlow` is a game with its clocks, in one of two states:
+ * - `FLOW_WAITING`: the clock of the player to move runs and the game waits for its move,
+ * - `FLOW_FINISHED`: the game is over (`itsEnd` tells why).
+ *
+ * Nothing blocks: the flow only changes when it is given a move (`playFlowMove`) or the time
+ * (`checkFlowClock`). A turn checks the move with `isValidMovement`, stops the clock, plays the
+ * move with `movePiece` and `capturePieces`, switches the player and starts the next clock, as
+ * the loop of `itsGame` always did. Where the move comes from (keyboard, network, engine) is up
+ * to the driver: `itsGame` drives one flow with blocking reads, the scheduler drives thousands.
+ *
+ * The scheduler owns its games and runs them on a single thread. Moves are posted to it from
+ * any thread (`postFlowMove`); when a game waits for a player the scheduler calls the
+ * `itsOnRequest` hook of the game, whose owner answers later with a move. A game whose player
+ * does not answer in time is flagged by the scheduler at the deadline of its clock, without any
+ * thread waiting for it.
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef GAMEFLOW_H
+#define GAMEFLOW_H
+
+#include <atomic>
+#include <condition_variable>
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "typeDef.h"
+#include "clock.h"
+
+/**
+ * @enum FlowState
+ * @brief State of a game flow.
+ */
+enum FlowState
+{
+    FLOW_WAITING,  /**< Waiting for the move of the current player. */
+    FLOW_FINISHED  /**< The game is over. */
+};
+
+/**
+ * @enum FlowEnd
+ * @brief Why a game flow finished.
+ */
+enum FlowEnd
+{
+    FLOW_WON,      /**< `isGameFinished`: the winner is given by `whoWon`. */
+    FLOW_FLAGGED,  /**< The current player lost on time. */
+    FLOW_BLOCKED,  /**< The current player had no move. */
+    FLOW_ABORTED   /**< The game was stopped from outside. */
+};
+
+/**
+ * @enum FlowResult
+ * @brief Outcome of a move given to a flow.
+ */
+enum FlowResult
+{
+    FLOW_REFUSED,  /**< Illegal move, or the game is not waiting: nothing changed. */
+    FLOW_PLAYED,   /**< The move was played; the flow waits for the next one. */
+    FLOW_OVER      /**< The move ended the game, or came after the flag (it is then not played). */
+};
+
+struct GameFlow;
+
+/**
+ * @struct FlowHooks
+ * @brief Callbacks of a flow; each one may be null.
+ */
+struct FlowHooks
+{
+    void (*itsOnRequest)(void* aContext, const GameFlow& aFlow) = nullptr;  /**< The flow waits for a move of its current player. */
+    void (*itsOnMove)(void* aContext, const GameFlow& aFlow, const Move& aMove) = nullptr; /**< A legal move is about to be played (the game is still before it). */
+    void (*itsOnEnd)(void* aContext, const GameFlow& aFlow) = nullptr;      /**< The game is over. */
+    void* itsContext = nullptr; /**< First argument of the callbacks. */
+};
+
+/**
+ * @struct GameFlow
+ * @brief A game driven as a state machine.
+ */
+struct GameFlow
+{
+    Game itsGame;                  /**< The game. */
+    GameClock itsClock;            /**< Clocks of both players. */
+    FlowState itsState = FLOW_WAITING; /**< Current state. */
+    FlowEnd itsEnd = FLOW_WON;     /**< Why the game finished (when `FLOW_FINISHED`). */
+    int itsPly = 0;                /**< Moves played. */
+    FlowHooks* itsHooks = nullptr; /**< Observers of the flow, if any. */
+    uint32_t itsId = 0;            /**< Id given by the scheduler (0 outside of it). */
+    int64_t itsDeadline = INT64_MAX; /**< Flag time watched by the scheduler. */
+};
+
+/**
+ * @brief Sets a flow on the starting position and starts the clock of the first player.
+ *
+ * @param aFlow The flow; the board is created, or kept if it has the right size. The names of the players are kept.
+ * @param aSize The board size.
+ * @param aControl The time control.
+ * @param aNow The current time (`getClockTime`).
+ * @return `false` if the board cannot be created.
+ */
+bool startFlow(GameFlow& aFlow, BoardSize aSize, const TimeControl& aControl, int64_t aNow);
+
+/**
+ * @brief Gives the move of the current player to a flow.
+ *
+ * @param aFlow The flow.
+ * @param aMove The move.
+ * @param aNow The time of the move (`getClockTime`), charged to the clock of the player.
+ * @return What became of the move.
+ */
+FlowResult playFlowMove(GameFlow& aFlow, const Move& aMove, int64_t aNow);
+
+/**
+ * @brief Flags the current player if its time is over.
+ *
+ * @param aFlow The flow.
+ * @param aNow The current time.
+ * @return `true` if the flow is finished.
+ */
+bool checkFlowClock(GameFlow& aFlow, int64_t aNow);
+
+/**
+ * @brief Returns when the current player of a waiting flow loses on time.
+ *
+ * @param aFlow The flow.
+ * @param aNow The current time.
+ * @return The time of the flag (`INT64_MAX` without clock or if the flow is finished).
+ */
+int64_t getFlowDeadline(const GameFlow& aFlow, int64_t aNow);
+
+/**
+ * @brief Ends a waiting flow (blocked player or stopped game).
+ *
+ * @param aFlow The flow.
+ * @param aEnd `FLOW_BLOCKED` or `FLOW_ABORTED`.
+ */
+void endFlow(GameFlow& aFlow, FlowEnd aEnd);
+
+/**
+ * @brief Returns the winner of a finished flow.
+ *
+ * @param aFlow The flow.
+ * @return The winner, or `nullptr` for an aborted game.
+ */
+const Player* getFlowWinner(const GameFlow& aFlow);
+
+/**
+ * @struct FlowEvent
+ * @brief Something posted to a scheduler.
+ */
+struct FlowEvent
+{
+    uint32_t itsId;            /**< The game. */
+    bool itsAbort;             /**< Stop the game instead of playing a move. */
+    Move itsMove;              /**< The move. */
+    int64_t itsTime;           /**< Time the move was posted, charged to the clock. */
+};
+
+/**
+ * @struct FlowScheduler
+ * @brief Games driven by one thread.
+ */
+struct FlowScheduler
+{
+    thread itsThread;                 /**< The thread of the scheduler. */
+    mutex itsLock;                    /**< Protects the inbox. */
+    condition_variable itsWake;       /**< Signalled when something is posted. */
+    bool itsStop = false;             /**< Set to stop the scheduler. */
+    vector<FlowEvent> itsInbox;       /**< Moves and stops posted. */
+    vector<pair<uint32_t, unique_ptr<GameFlow>>> itsAdded; /**< Games added, not yet started. */
+    unordered_map<uint32_t, unique_ptr<GameFlow>> itsGames; /**< Games in progress (scheduler thread only). */
+    set<pair<int64_t, uint32_t>> itsDeadlines; /**< Flag time of each waiting game with a clock, and its id. */
+    atomic<uint32_t> itsNextId{1};    /**< Id of the next game. */
+    atomic<uint32_t> itsLiveGames{0}; /**< Games added and not finished. */
+    atomic<uint64_t> itsMoves{0};     /**< Moves played. */
+};
+
+/**
+ * @brief Starts the thread of a scheduler.
+ *
+ * @param aScheduler The scheduler.
+ */
+void startScheduler(FlowScheduler& aScheduler);
+
+/**
+ * @brief Stops a scheduler; the games still in progress are dropped without their end hook.
+ *
+ * @param aScheduler The scheduler.
+ */
+void stopScheduler(FlowScheduler& aScheduler);
+
+/**
+ * @brief Gives a game to a scheduler, which starts it on its thread.
+ *
+ * @param aScheduler The scheduler.
+ * @param aFlow The game, not started (names and hooks set); its clock starts when the scheduler takes it.
+ * @param aSize The board size.
+ * @param aControl The time control.
+ * @return The id of the game (`itsId`).
+ */
+uint32_t scheduleGame(FlowScheduler& aScheduler, unique_ptr<GameFlow> aFlow, BoardSize aSize, const TimeControl& aControl);
+
+/**
+ * @brief Posts the move of the player of a game (any thread, also from a hook).
+ *
+ * An illegal move is refused and the player asked again (`itsOnRequest`).
+ *
+ * @param aScheduler The scheduler.
+ * @param aId The game.
+ * @param aMove The move.
+ */
+void postFlowMove(FlowScheduler& aScheduler, uint32_t aId, const Move& aMove);
+
+/**
+ * @brief Stops a game (any thread); it ends as `FLOW_ABORTED`.
+ *
+ * @param aScheduler The scheduler.
+ * @param aId The game.
+ */
+void abortFlowGame(FlowScheduler& aScheduler, uint32_t aId);
+
+#endif // GAMEFLOW_H
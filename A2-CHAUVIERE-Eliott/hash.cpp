@@ -0,0 +1,66 @@
+#include "hash.h"
+
+/**
+ * Table des clés : une par case (adressée comme sur un plateau 13x13) et par pièce,
+ * plus les clés du joueur actif et du grand plateau.
+ */
+struct ZobristKeys
+{
+    uint64_t itsPieces[BIG * BIG][4];
+    uint64_t itsSide;
+    uint64_t itsBigBoard;
+};
+
+// générateur splitmix64 : les clés sont toujours les mêmes d'une exécution à l'autre
+static uint64_t nextKey(uint64_t& aState)
+{
+    uint64_t z = (aState += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static ZobristKeys createKeys()
+{
+    ZobristKeys keys;
+    uint64_t state = 0x48A3F7A7A1ULL;
+    for (int i = 0; i < BIG * BIG; ++i) {
+        keys.itsPieces[i][NONE] = 0;
+        for (int piece = SHIELD; piece <= KING; ++piece)
+            keys.itsPieces[i][piece] = nextKey(state);
+    }
+    keys.itsSide = nextKey(state);
+    keys.itsBigBoard = nextKey(state);
+    return keys;
+}
+
+static const ZobristKeys ZOBRIST = createKeys();
+
+uint64_t getPieceKey(PieceType aPiece, const Position& aPos)
+{
+    return ZOBRIST.itsPieces[aPos.itsRow * BIG + aPos.itsCol][aPiece];
+}
+
+uint64_t getSideKey()
+{
+    return ZOBRIST.itsSide;
+}
+
+uint64_t getBoardKey(BoardSize aSize)
+{
+    return (aSize == BIG) ? ZOBRIST.itsBigBoard : 0;
+}
+
+uint64_t hashPosition(const Game& aGame)
+{
+    const Board& aBoard = aGame.itsBoard;
+    uint64_t hash = getBoardKey(aBoard.itsSize);
+    if (aGame.itsCurrentPlayer->itsRole == DEFENSE)
+        hash ^= ZOBRIST.itsSide;
+    for (int i = 0; i < aBoard.itsSize; ++i) {
+        for (int j = 0; j < aBoard.itsSize; ++j) {
+            hash ^= ZOBRIST.itsPieces[i * BIG + j][aBoard.itsCells[i][j].itsPieceType];
+        }
+    }
+    return hash;
+}
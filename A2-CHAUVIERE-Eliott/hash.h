@@ -0,0 +1,53 @@
+/**
+ * @file hash.h
+ *
+ * @brief 64-bit position hash (Zobrist hashing).
+ *
+ * Every (cell, piece) pair has a fixed random 64-bit key; the hash of a position is the
+ * exclusive or of the keys of its pieces, of a key for the side to move and of a key
+ * for the 13x13 board. Moving or removing a piece only changes the hash by the keys
+ * of that piece, which lets callers update it after each move instead of rescanning the board.
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstdint>
+#include "typeDef.h"
+
+/**
+ * @brief Returns the key of a piece standing on a cell.
+ *
+ * @param aPiece The piece (SHIELD, SWORD or KING; NONE gives 0).
+ * @param aPos The cell of the piece.
+ * @return The Zobrist key of the piece on this cell.
+ */
+uint64_t getPieceKey(PieceType aPiece, const Position& aPos);
+
+/**
+ * @brief Returns the key added to the hash when the defender is to move.
+ *
+ * @return The Zobrist key of the side to move.
+ */
+uint64_t getSideKey();
+
+/**
+ * @brief Returns the key added to the hash for a board size (0 for the 11x11 board).
+ *
+ * @param aSize The board size.
+ * @return The Zobrist key of the board size.
+ */
+uint64_t getBoardKey(BoardSize aSize);
+
+/**
+ * @brief Computes the hash of a position from the board contents and the side to move.
+ *
+ * @param aGame The game (board, board size and current player).
+ * @return The 64-bit hash of the position.
+ */
+uint64_t hashPosition(const Game& aGame);
+
+#endif // HASH_H
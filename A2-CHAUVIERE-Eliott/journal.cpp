@@ -0,0 +1,536 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+using namespace std;
+#include "journal.h"
+#include "functions.h"
+#include "symmetry.h"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// en-tête du fichier d'instantané (donne aussi la version du format)
+static const char SNAPSHOT_MAGIC[4] = {'H', 'S', 'N', '1'};
+
+static string getSegmentPath(const string& aPath, uint32_t aGeneration)
+{
+    return aPath + "." + to_string(aGeneration) + ".log";
+}
+
+static string getSnapshotPath(const string& aPath)
+{
+    return aPath + ".snap";
+}
+
+// fichiers bruts : une écriture du tampon entier puis une synchronisation des données
+static int openFile(const string& aPath)
+{
+#ifdef _WIN32
+    return _open(aPath.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    return open(aPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+#endif
+}
+
+static bool writeFile(int aFile, const string& aData)
+{
+    size_t done = 0;
+    while (done < aData.size()) {
+#ifdef _WIN32
+        int written = _write(aFile, aData.data() + done, unsigned(aData.size() - done));
+#else
+        ssize_t written = write(aFile, aData.data() + done, aData.size() - done);
+#endif
+        if (written <= 0)
+            return false;
+        done += size_t(written);
+    }
+    return true;
+}
+
+static bool syncFile(int aFile)
+{
+#ifdef _WIN32
+    return _commit(aFile) == 0;
+#elif defined(__APPLE__)
+    return fsync(aFile) == 0;
+#else
+    return fdatasync(aFile) == 0;
+#endif
+}
+
+static void closeFile(int aFile)
+{
+#ifdef _WIN32
+    _close(aFile);
+#else
+    close(aFile);
+#endif
+}
+
+// FNV-1a sur 32 bits : suffit à reconnaître un enregistrement déchiré
+static uint32_t getChecksum(const char* aData, size_t aSize)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < aSize; ++i) {
+        hash ^= (unsigned char)aData[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void appendNumber(string& aData, uint32_t aValue)
+{
+    for (int i = 0; i < 4; ++i)
+        aData += char((aValue >> (8 * i)) & 0xFF);
+}
+
+static void appendName(string& aData, const string& aName)
+{
+    size_t length = min(aName.size(), size_t(255));
+    aData += char(length);
+    aData.append(aName, 0, length);
+}
+
+// lecture bornée d'un tampon : tout débordement rend le lecteur invalide
+struct JournalReader
+{
+    const string& itsData;
+    size_t itsOffset;
+    bool itsValid;
+};
+
+static uint32_t readNumber(JournalReader& aReader)
+{
+    if (aReader.itsOffset + 4 > aReader.itsData.size()) {
+        aReader.itsValid = false;
+        return 0;
+    }
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i)
+        value |= uint32_t((unsigned char)aReader.itsData[aReader.itsOffset++]) << (8 * i);
+    return value;
+}
+
+static unsigned char readByte(JournalReader& aReader)
+{
+    if (aReader.itsOffset >= aReader.itsData.size()) {
+        aReader.itsValid = false;
+        return 0;
+    }
+    return (unsigned char)aReader.itsData[aReader.itsOffset++];
+}
+
+static string readName(JournalReader& aReader)
+{
+    size_t length = readByte(aReader);
+    if (aReader.itsOffset + length > aReader.itsData.size()) {
+        aReader.itsValid = false;
+        return "";
+    }
+    aReader.itsOffset += length;
+    return aReader.itsData.substr(aReader.itsOffset - length, length);
+}
+
+static bool readWholeFile(const string& aPath, string& aData)
+{
+    ifstream file(aPath, ios::binary);
+    if (!file)
+        return false;
+    aData.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    return true;
+}
+
+static JournalGame& startGame(map<uint32_t, JournalGame>& aGames, uint32_t aId)
+{
+    auto found = aGames.find(aId);
+    if (found != aGames.end()) {
+        deleteBoard(found->second.itsGame.itsBoard);
+        aGames.erase(found);
+    }
+    // construite en place : itsCurrentPlayer pointe dans la partie elle-même
+    return aGames[aId];
+}
+
+static bool readSnapshot(const string& aPath, map<uint32_t, JournalGame>& aGames, uint32_t& aGeneration)
+{
+    string data;
+    aGeneration = 0;
+    if (!readWholeFile(getSnapshotPath(aPath), data))
+        return true;
+    if (data.size() < sizeof(SNAPSHOT_MAGIC) + 12 || data.compare(0, 4, SNAPSHOT_MAGIC, 4) != 0)
+        return false;
+    JournalReader checksum = {data, data.size() - 4, true};
+    if (readNumber(checksum) != getChecksum(data.data(), data.size() - 4))
+        return false;
+
+    JournalReader reader = {data, 4, true};
+    aGeneration = readNumber(reader);
+    uint32_t count = readNumber(reader);
+    for (uint32_t g = 0; g < count && reader.itsValid; ++g) {
+        uint32_t id = readNumber(reader);
+        int plies = int(readNumber(reader));
+        string names[2] = {readName(reader), readName(reader)};
+        PackedBoard packed = {};
+        packed.itsSize = readByte(reader);
+        packed.itsSide = readByte(reader);
+        if (packed.itsSize != LITTLE && packed.itsSize != BIG)
+            return false;
+        for (int row = 0; row < packed.itsSize; ++row) {
+            uint32_t pieces = readNumber(reader);
+            packed.itsSwords[row] = uint16_t(pieces);
+            packed.itsShields[row] = uint16_t(pieces >> 16);
+            unsigned char low = readByte(reader);
+            packed.itsKing[row] = uint16_t(low | readByte(reader) << 8);
+        }
+        if (!reader.itsValid)
+            return false;
+        JournalGame& game = startGame(aGames, id);
+        game.itsGame.itsPlayer1.itsName = names[0];
+        game.itsGame.itsPlayer2.itsName = names[1];
+        unpackPosition(packed, game.itsGame);
+        game.itsPlies = plies;
+    }
+    return reader.itsValid;
+}
+
+// rejoue un segment ; un enregistrement incomplet ou abîmé termine le segment
+static bool replaySegment(const string& aData, map<uint32_t, JournalGame>& aGames)
+{
+    size_t offset = 0;
+    while (offset < aData.size()) {
+        JournalReader reader = {aData, offset, true};
+        char type = char(readByte(reader));
+        uint32_t id = readNumber(reader);
+        string names[2];
+        int size = 0;
+        Move move;
+        if (type == JOURNAL_START) {
+            size = readByte(reader);
+            names[0] = readName(reader);
+            names[1] = readName(reader);
+        }
+        else if (type == JOURNAL_MOVE)
+            move = {{readByte(reader), readByte(reader)}, {readByte(reader), readByte(reader)}};
+        else if (type != JOURNAL_END)
+            return true;
+        size_t end = reader.itsOffset;
+        uint32_t checksum = readNumber(reader);
+        if (!reader.itsValid || checksum != getChecksum(aData.data() + offset, end - offset))
+            return true;
+        offset = reader.itsOffset;
+
+        auto found = aGames.find(id);
+        if (type == JOURNAL_START) {
+            if (size != LITTLE && size != BIG)
+                return false;
+            JournalGame& game = startGame(aGames, id);
+            game.itsGame.itsBoard.itsSize = BoardSize(size);
+            createBoard(game.itsGame.itsBoard);
+            initializeBoard(game.itsGame.itsBoard);
+            game.itsGame.itsPlayer1.itsName = names[0];
+            game.itsGame.itsPlayer2.itsName = names[1];
+        }
+        else if (found == aGames.end())
+            return false;
+        else if (type == JOURNAL_END) {
+            deleteBoard(found->second.itsGame.itsBoard);
+            aGames.erase(found);
+        }
+        else {
+            // mêmes règles que pendant la partie
+            Game& game = found->second.itsGame;
+            if (!isValidPosition(move.itsStartPosition, game.itsBoard) || !isValidPosition(move.itsEndPosition, game.itsBoard)
+                || !isValidMovement(game, move))
+                return false;
+            movePiece(game, move);
+            capturePieces(game, move);
+            switchCurrentPlayer(game);
+            found->second.itsPlies++;
+        }
+    }
+    return true;
+}
+
+// instantané puis segments à partir de sa génération, jusqu'à aLimit exclu ; aNext reçoit le premier segment non lu
+static bool loadJournal(const string& aPath, map<uint32_t, JournalGame>& aGames, uint32_t& aBase, uint32_t& aNext,
+                        uint32_t aLimit = UINT32_MAX)
+{
+    if (!readSnapshot(aPath, aGames, aBase))
+        return false;
+    string data;
+    for (aNext = aBase; aNext < aLimit && readWholeFile(getSegmentPath(aPath, aNext), data); ++aNext)
+        if (!replaySegment(data, aGames))
+            return false;
+    return true;
+}
+
+static bool writeSnapshot(const string& aPath, uint32_t aGeneration, const map<uint32_t, JournalGame>& aGames)
+{
+    string data(SNAPSHOT_MAGIC, 4);
+    appendNumber(data, aGeneration);
+    appendNumber(data, uint32_t(aGames.size()));
+    for (const auto& entry : aGames) {
+        const JournalGame& game = entry.second;
+        PackedBoard packed;
+        packPosition(game.itsGame, packed);
+        appendNumber(data, entry.first);
+        appendNumber(data, uint32_t(game.itsPlies));
+        appendName(data, game.itsGame.itsPlayer1.itsName);
+        appendName(data, game.itsGame.itsPlayer2.itsName);
+        data += char(packed.itsSize);
+        data += char(packed.itsSide);
+        for (int row = 0; row < packed.itsSize; ++row) {
+            appendNumber(data, uint32_t(packed.itsSwords[row]) | uint32_t(packed.itsShields[row]) << 16);
+            data += char(packed.itsKing[row] & 0xFF);
+            data += char(packed.itsKing[row] >> 8);
+        }
+    }
+    appendNumber(data, getChecksum(data.data(), data.size()));
+
+    // fichier temporaire rendu durable puis renommé : l'ancien instantané reste valable jusque-là
+    string temporary = getSnapshotPath(aPath) + ".tmp";
+    int file = openFile(temporary);
+    if (file < 0)
+        return false;
+    bool written = writeFile(file, data) && syncFile(file);
+    closeFile(file);
+#ifdef _WIN32
+    remove(getSnapshotPath(aPath).c_str());
+#endif
+    if (!written || rename(temporary.c_str(), getSnapshotPath(aPath).c_str()) != 0)
+        return false;
+#ifndef _WIN32
+    // le renommage lui-même doit survivre
+    size_t slash = aPath.rfind('/');
+    int directory = open((slash == string::npos) ? "." : aPath.substr(0, slash + 1).c_str(), O_RDONLY | O_CLOEXEC);
+    if (directory >= 0) {
+        fsync(directory);
+        close(directory);
+    }
+#endif
+    return true;
+}
+
+// les enregistrements suivants vont dans un segment neuf
+static bool openNextSegment(Journal& aJournal)
+{
+    int next = openFile(getSegmentPath(aJournal.itsPath, aJournal.itsGeneration + 1));
+    if (next < 0)
+        return false;
+    if (aJournal.itsFile >= 0)
+        closeFile(aJournal.itsFile);
+    aJournal.itsFile = next;
+    aJournal.itsGeneration++;
+    aJournal.itsSegmentBytes = 0;
+    return true;
+}
+
+// instantané des segments fermés (avant aGeneration), puis ces segments supprimés
+static bool compactJournal(const string& aPath, uint32_t aGeneration)
+{
+    map<uint32_t, JournalGame> games;
+    uint32_t base;
+    uint32_t end;
+    bool taken = loadJournal(aPath, games, base, end, aGeneration) && writeSnapshot(aPath, aGeneration, games);
+    releaseJournalGames(games);
+    if (!taken)
+        return false;
+    for (uint32_t generation = base; generation < aGeneration; ++generation)
+        remove(getSegmentPath(aPath, generation).c_str());
+    return true;
+}
+
+// fil d'instantané : les segments fermés sont relus pendant que les validations continuent
+static void runSnapshotter(Journal& aJournal, uint32_t aGeneration)
+{
+    bool taken = compactJournal(aJournal.itsPath, aGeneration);
+    lock_guard<mutex> lock(aJournal.itsLock);
+    if (taken)
+        aJournal.itsSnapshots++;
+    else
+        aJournal.itsFailed = true;
+    aJournal.itsSnapshotting = false;
+    aJournal.itsWake.notify_one();
+}
+
+static void runCommitter(Journal& aJournal)
+{
+    string batch;
+    unique_lock<mutex> lock(aJournal.itsLock);
+    for (;;) {
+        aJournal.itsWake.wait_for(lock, chrono::microseconds(aJournal.itsInterval), [&aJournal]() {
+            return aJournal.itsStop || (aJournal.itsSnapshotWanted && !aJournal.itsSnapshotting);
+        });
+        // les deux tampons s'échangent : aucun ne perd sa capacité
+        batch.clear();
+        batch.swap(aJournal.itsPending);
+        uint64_t sequence = aJournal.itsWritten;
+        // un seul instantané à la fois ; une demande faite pendant l'instantané attend sa fin
+        bool snapshot = !aJournal.itsSnapshotting && !aJournal.itsStop
+                        && (aJournal.itsSnapshotWanted || aJournal.itsSegmentBytes >= aJournal.itsSnapshotBytes);
+        bool stop = aJournal.itsStop;
+        // relu ici : le fil d'instantané l'écrit sous le verrou
+        bool failed = aJournal.itsFailed;
+        if (snapshot) {
+            aJournal.itsSnapshotWanted = false;
+            aJournal.itsSnapshotting = true;
+        }
+        lock.unlock();
+
+        // une écriture et une synchronisation pour tous les coups de l'intervalle
+        bool committed = !failed;
+        if (committed && !batch.empty()) {
+            committed = writeFile(aJournal.itsFile, batch) && syncFile(aJournal.itsFile);
+            aJournal.itsSegmentBytes += batch.size();
+            aJournal.itsCommits++;
+        }
+        // seul le changement de segment se fait ici ; l'instantané se construit sur son propre fil
+        if (snapshot) {
+            if (aJournal.itsSnapshotter.joinable())
+                aJournal.itsSnapshotter.join();
+            if (committed && openNextSegment(aJournal))
+                aJournal.itsSnapshotter = thread(runSnapshotter, ref(aJournal), aJournal.itsGeneration);
+            else {
+                committed = false;
+                lock_guard<mutex> guard(aJournal.itsLock);
+                aJournal.itsSnapshotting = false;
+            }
+        }
+
+        lock.lock();
+        if (committed)
+            aJournal.itsDurable = sequence;
+        else
+            aJournal.itsFailed = true;
+        aJournal.itsCommitted.notify_all();
+        if (stop)
+            return;
+    }
+}
+
+bool recoverJournal(const string& aPath, map<uint32_t, JournalGame>& aGames)
+{
+    uint32_t base;
+    uint32_t next;
+    return loadJournal(aPath, aGames, base, next);
+}
+
+void releaseJournalGames(map<uint32_t, JournalGame>& aGames)
+{
+    for (auto& entry : aGames)
+        if (entry.second.itsGame.itsBoard.itsCells != nullptr)
+            deleteBoard(entry.second.itsGame.itsBoard);
+    aGames.clear();
+}
+
+bool openJournal(Journal& aJournal, const string& aPath)
+{
+    map<uint32_t, JournalGame> games;
+    uint32_t base;
+    uint32_t next;
+    if (!loadJournal(aPath, games, base, next)) {
+        releaseJournalGames(games);
+        return false;
+    }
+    releaseJournalGames(games);
+
+    // le dernier segment peut finir par un enregistrement déchiré : la suite part d'un segment neuf
+    aJournal.itsPath = aPath;
+    aJournal.itsGeneration = (next > base) ? next - 1 : base;
+    aJournal.itsFile = -1;
+    aJournal.itsPending.clear();
+    aJournal.itsWritten = 0;
+    aJournal.itsDurable = 0;
+    aJournal.itsStop = false;
+    aJournal.itsFailed = false;
+    aJournal.itsSnapshotWanted = false;
+    aJournal.itsSnapshotting = false;
+    if (!openNextSegment(aJournal) || !compactJournal(aPath, aJournal.itsGeneration)) {
+        if (aJournal.itsFile >= 0)
+            closeFile(aJournal.itsFile);
+        aJournal.itsFile = -1;
+        return false;
+    }
+    aJournal.itsSnapshots++;
+    aJournal.itsCommitter = thread(runCommitter, ref(aJournal));
+    return true;
+}
+
+void closeJournal(Journal& aJournal)
+{
+    if (!aJournal.itsCommitter.joinable())
+        return;
+    {
+        lock_guard<mutex> lock(aJournal.itsLock);
+        aJournal.itsStop = true;
+    }
+    aJournal.itsWake.notify_one();
+    aJournal.itsCommitter.join();
+    if (aJournal.itsSnapshotter.joinable())
+        aJournal.itsSnapshotter.join();
+    closeFile(aJournal.itsFile);
+    aJournal.itsFile = -1;
+}
+
+// ajout au tampon du prochain commit ; seule la copie se fait sous le verrou
+static uint64_t appendRecord(Journal& aJournal, string& aRecord)
+{
+    appendNumber(aRecord, getChecksum(aRecord.data(), aRecord.size()));
+    lock_guard<mutex> lock(aJournal.itsLock);
+    aJournal.itsPending += aRecord;
+    aJournal.itsWritten += aRecord.size();
+    return aJournal.itsWritten;
+}
+
+uint64_t logGameStart(Journal& aJournal, uint32_t aId, const Game& aGame)
+{
+    string record(1, char(JOURNAL_START));
+    appendNumber(record, aId);
+    record += char(aGame.itsBoard.itsSize);
+    appendName(record, aGame.itsPlayer1.itsName);
+    appendName(record, aGame.itsPlayer2.itsName);
+    return appendRecord(aJournal, record);
+}
+
+uint64_t logMove(Journal& aJournal, uint32_t aId, const Move& aMove)
+{
+    // 13 octets : tient dans le tampon interne de la chaîne, aucune allocation
+    string record(1, char(JOURNAL_MOVE));
+    appendNumber(record, aId);
+    record += char(aMove.itsStartPosition.itsRow);
+    record += char(aMove.itsStartPosition.itsCol);
+    record += char(aMove.itsEndPosition.itsRow);
+    record += char(aMove.itsEndPosition.itsCol);
+    return appendRecord(aJournal, record);
+}
+
+uint64_t logGameEnd(Journal& aJournal, uint32_t aId)
+{
+    string record(1, char(JOURNAL_END));
+    appendNumber(record, aId);
+    return appendRecord(aJournal, record);
+}
+
+bool waitJournal(Journal& aJournal, uint64_t aSequence)
+{
+    unique_lock<mutex> lock(aJournal.itsLock);
+    aJournal.itsCommitted.wait(lock, [&]() { return aJournal.itsDurable >= aSequence || aJournal.itsFailed; });
+    return aJournal.itsDurable >= aSequence;
+}
+
+void snapshotJournal(Journal& aJournal)
+{
+    {
+        lock_guard<mutex> lock(aJournal.itsLock);
+        aJournal.itsSnapshotWanted = true;
+    }
+    aJournal.itsWake.notify_one();
+}
@@ -0,0 +1,191 @@
+/**
+ * @file journal.h
+ *
+ * @brief Write-ahead log of live games: every applied move is logged so that the games in
+ *        progress survive a crash of their host.
+ *
+ * The log is a sequence of segments `<path>.<n>.log`, each a plain concatenation of records:
+ * - `JOURNAL_START`: a game begins (board size and names of both players),
+ * - `JOURNAL_MOVE`: a move was applied to a game (start and end cells, one byte each),
+ * - `JOURNAL_END`: a game is over and can be forgotten.
+ *
+ * Every record is `type (1 byte) | game id (4 bytes) | data | checksum (4 bytes)`; the checksum
+ * covers the type, the id and the data, so a record torn by a crash ends the segment cleanly.
+ *
+ * Group commit: the writers only append their record to a buffer under a lock, which costs
+ * well under a microsecond. A commit thread takes the buffer every `itsInterval` microseconds,
+ * writes it with a single `write` and makes it durable with a single `fdatasync`, whatever the
+ * number of games and moves in it. A caller that must know its move is on disk waits for the
+ * sequence returned by the log functions (`waitJournal`); the others lose at most one interval
+ * of moves in a crash.
+ *
+ * Snapshots: when a segment exceeds `itsSnapshotBytes`, the commit thread opens the next segment
+ * and hands the closed ones to a snapshot thread, then goes on committing every interval. The
+ * snapshot thread rebuilds the games from the previous snapshot and the closed segments, and
+ * writes `<path>.snap`: the generation of the first segment to replay and, for each live game, its
+ * names, its number of plies and its position as a `PackedBoard`. The finished games are dropped,
+ * so the log stays proportional to the games in progress. The snapshot is written to a temporary
+ * file made durable then renamed, so a crash leaves either the old or the new one.
+ *
+ * Recovery (`recoverJournal`) loads the snapshot then replays the segments from its generation
+ * through `movePiece`, `capturePieces` and `switchCurrentPlayer`, checking each move with
+ * `isValidMovement`.
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+#include "typeDef.h"
+
+/**
+ * @brief Default time between two commits, in microseconds.
+ */
+const int JOURNAL_INTERVAL = 2000;
+
+/**
+ * @brief Default size of a segment beyond which a snapshot is taken, in bytes.
+ */
+const uint64_t JOURNAL_SNAPSHOT_BYTES = 16 << 20;
+
+/**
+ * @enum JournalRecord
+ * @brief Type of a record (first byte).
+ */
+enum JournalRecord
+{
+    JOURNAL_START = 'S', /**< A game begins. */
+    JOURNAL_MOVE = 'M',  /**< A move was applied. */
+    JOURNAL_END = 'E'    /**< A game is over. */
+};
+
+/**
+ * @struct JournalGame
+ * @brief A game rebuilt from the log.
+ */
+struct JournalGame
+{
+    Game itsGame;       /**< Names, position and player to move; the board comes from `createBoard`. */
+    int itsPlies = 0;   /**< Moves played. */
+};
+
+/**
+ * @struct Journal
+ * @brief An open log, with its commit thread.
+ */
+struct Journal
+{
+    string itsPath;                          /**< Path of the log, without the segment suffix. */
+    int itsInterval = JOURNAL_INTERVAL;      /**< Time between two commits, in microseconds. */
+    uint64_t itsSnapshotBytes = JOURNAL_SNAPSHOT_BYTES; /**< Segment size beyond which a snapshot is taken. */
+    int itsFile = -1;                        /**< Descriptor of the current segment. */
+    uint32_t itsGeneration = 0;              /**< Number of the current segment. */
+    uint64_t itsSegmentBytes = 0;            /**< Bytes written to the current segment. */
+    mutex itsLock;                           /**< Protects the buffer and the sequences. */
+    condition_variable itsCommitted;         /**< Signalled after each commit. */
+    condition_variable itsWake;              /**< Wakes the commit thread early (close, snapshot). */
+    string itsPending;                       /**< Records waiting for the next commit. */
+    uint64_t itsWritten = 0;                 /**< Bytes logged since opening (sequence of the last record). */
+    uint64_t itsDurable = 0;                 /**< Bytes logged and made durable. */
+    bool itsSnapshotWanted = false;          /**< A snapshot was asked for (`snapshotJournal`). */
+    bool itsStop = false;                    /**< Set to close the log. */
+    bool itsFailed = false;                  /**< A write or a sync failed: nothing is durable any more. */
+    thread itsCommitter;                     /**< The commit thread. */
+    thread itsSnapshotter;                   /**< The thread of the last snapshot. */
+    bool itsSnapshotting = false;            /**< A snapshot thread is running. */
+    atomic<uint64_t> itsCommits{0};          /**< Commits done (one `fdatasync` each). */
+    atomic<uint64_t> itsSnapshots{0};        /**< Snapshots written. */
+};
+
+/**
+ * @brief Rebuilds the games in progress from a log.
+ *
+ * @param aPath Path of the log, without the segment suffix.
+ * @param aGames Receives the live games by id (their boards must be freed with `releaseJournalGames`).
+ * @return `false` if the snapshot is corrupted or a move does not apply; the games read so far are kept.
+ *         A missing log is an empty one; a torn record ends its segment.
+ */
+bool recoverJournal(const string& aPath, map<uint32_t, JournalGame>& aGames);
+
+/**
+ * @brief Frees the boards of recovered games and empties the map.
+ *
+ * @param aGames The games.
+ */
+void releaseJournalGames(map<uint32_t, JournalGame>& aGames);
+
+/**
+ * @brief Opens a log for writing and starts its commit thread.
+ *
+ * The existing log is compacted first: its live games are written to a new snapshot and its old
+ * segments removed, so that the records of this run start a fresh segment.
+ *
+ * @param aJournal The log (closed); `itsInterval` and `itsSnapshotBytes` may be set beforehand.
+ * @param aPath Path of the log, without the segment suffix.
+ * @return `false` if the log cannot be recovered or its files cannot be written.
+ */
+bool openJournal(Journal& aJournal, const string& aPath);
+
+/**
+ * @brief Commits what is pending, stops the commit thread and closes the log.
+ *
+ * The games in progress stay in the log and are found again by the next recovery.
+ *
+ * @param aJournal The log.
+ */
+void closeJournal(Journal& aJournal);
+
+/**
+ * @brief Logs the beginning of a game.
+ *
+ * @param aJournal The log.
+ * @param aId Id of the game, unique among the games of the log.
+ * @param aGame The game, on its starting position, with the names of both players.
+ * @return The sequence to wait for to know the record durable.
+ */
+uint64_t logGameStart(Journal& aJournal, uint32_t aId, const Game& aGame);
+
+/**
+ * @brief Logs a move applied to a game.
+ *
+ * @param aJournal The log.
+ * @param aId Id of the game.
+ * @param aMove The move.
+ * @return The sequence to wait for to know the record durable.
+ */
+uint64_t logMove(Journal& aJournal, uint32_t aId, const Move& aMove);
+
+/**
+ * @brief Logs the end of a game.
+ *
+ * @param aJournal The log.
+ * @param aId Id of the game.
+ * @return The sequence to wait for to know the record durable.
+ */
+uint64_t logGameEnd(Journal& aJournal, uint32_t aId);
+
+/**
+ * @brief Waits until a record is durable.
+ *
+ * @param aJournal The log.
+ * @param aSequence Sequence returned when logging the record.
+ * @return `false` if the log failed before the record was committed.
+ */
+bool waitJournal(Journal& aJournal, uint64_t aSequence);
+
+/**
+ * @brief Asks the commit thread for a snapshot at its next commit, whatever the size of the segment.
+ *
+ * @param aJournal The log.
+ */
+void snapshotJournal(Journal& aJournal);
+
+#endif // JOURNAL_H
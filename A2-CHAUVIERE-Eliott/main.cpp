@@ -1,8 +1,28 @@
 #include <iostream>
+#include <fstream>
+#include <cstdlib>
 
 using namespace std;
 
 #include "functions.h"
+#include "batch.h"
+#include "book.h"
+#include "clock.h"
+#include "engine.h"
+#include "gameflow.h"
+#include "hash.h"
+#include "movegen.h"
+#include "notation.h"
+#include "posindex.h"
+#include "record.h"
+#include "render.h"
+#include "search.h"
+#include "selfplay.h"
+#include "server.h"
+#include "tablebase.h"
+#include "timeline.h"
+#include "tuner.h"
+#include "validator.h"
 #include "test.h"
 
 int defaultColor = 0;
@@ -17,6 +37,12 @@ void itsGame(){
     cin>>player1Name;
     cout<<"Nom du joueur 2 : ";
     cin>>player2Name;
+    string player1Bot;  //un joueur peut etre tenu par l'ordinateur
+    string player2Bot;
+    cout<<"Ordinateur pour le joueur 1 (o/n) : ";
+    cin>>player1Bot;
+    cout<<"Ordinateur pour le joueur 2 (o/n) : ";
+    cin>>player2Bot;
 
     BoardSize aBoardSize;  //Définir la taille du plateau 11 ou 13
     while(!chooseSizeBoard(aBoardSize))
@@ -26,52 +52,129 @@ void itsGame(){
         color(defaultColor,0);
     }
 
-    Board aBoard={nullptr,aBoardSize};  //créer et initialiser le plateau de jeu
-    createBoard(aBoard);
-    initializeBoard(aBoard);
+    TimeControl aControl;  //choisir la cadence de la pendule
+    string aControlText;
+    cout<<"Cadence en secondes (300+5 Fischer, 600/30x5 byo-yomi, 0 sans pendule) : ";
+    cin>>aControlText;
+    while (!parseTimeControl(aControlText,aControl))
+    {
+        color(4,0);
+        cout<<"Cadence invalide"<<endl;
+        color(defaultColor,0);
+        cout<<"Cadence : ";
+        cin>>aControlText;
+    }
+    GameFlow aFlow;  //la partie avance coup par coup, sans boucle bloquante propre
+    aFlow.itsGame.itsPlayer1.itsName = player1Name;
+    aFlow.itsGame.itsPlayer2.itsName = player2Name;
+    aFlow.itsGame.itsPlayer1.itsIsBot = (player1Bot == "o" || player1Bot == "O");
+    aFlow.itsGame.itsPlayer2.itsIsBot = (player2Bot == "o" || player2Bot == "O");
+    Game& aGame = aFlow.itsGame;
+    startFlow(aFlow,aBoardSize,aControl,getClockTime());  //créer et initialiser le plateau de jeu
 
-    displayBoard(aBoard);  //afficher le plateau
+    BoardRenderer aRenderer;  //le plateau reste en haut de l'ecran, seules les cases changees sont redessinees
+    drawBoard(aRenderer,aGame.itsBoard);  //afficher le plateau
 
     Position aPos = {0,0};  //initialiser les variables
     Position aPosEnd = {0,0};
-    Game aGame;
-    aGame.itsBoard = aBoard;
-    aGame.itsPlayer1.itsName = player1Name;
-    aGame.itsPlayer2.itsName = player2Name;
     Move aMove;
-    do
+
+    TranspositionTable aTable;  //table de l'ordinateur, remplie aussi pendant le temps de l'adversaire
+    Analysis aPonder;
+    AnalysisConfig aPonderConfig;
+    aPonderConfig.itsLines = 1;
+    aPonderConfig.itsMaxDepth = SEARCH_MAX_PLY - 1;
+    aPonderConfig.itsTable = &aTable;
+    if (aGame.itsPlayer1.itsIsBot || aGame.itsPlayer2.itsIsBot)
+        createTranspositionTable(aTable,aPonderConfig.itsHashBits);
+
+    RecordWriter aWriter;  //enregistrer la partie dans le fichier des parties
+    FlowHooks aHooks;
+    if (openRecordWriter(aWriter,RECORD_FILE))
     {
-        do
+        beginRecord(aWriter,aGame);
+        aHooks.itsContext = &aWriter;
+        aHooks.itsOnMove = [](void* aContext, const GameFlow& aPlayed, const Move& aPlayedMove)
         {
-            cout<<"Au tour de '"<<aGame.itsCurrentPlayer->itsName<<"' qui joue : "<<aGame.itsCurrentPlayer->itsRole<<endl;
+            writeRecordMove(*static_cast<RecordWriter*>(aContext),aPlayed.itsGame,aPlayedMove);  //enregistrer le coup avant de le jouer
+        };
+        aFlow.itsHooks = &aHooks;
+    }
 
-            while (!getPositionFromInput(aPos,aBoard))      //Position de la pièce à déplacer
-            {
-                color(4,0);
-                cout<<"Position non-valide"<<endl;
-                color(defaultColor,0);
-            }
-            while (!getPositionFromInput(aPosEnd,aBoard))   //Position d'arrivée de la pièce
+    while (aFlow.itsState == FLOW_WAITING)
+    {
+        string aMover = aGame.itsCurrentPlayer->itsName;
+        FlowResult aResult;
+        if (aGame.itsCurrentPlayer->itsIsBot)  //l'ordinateur cherche son coup dans le temps alloue
+        {
+            Move aMoves[MAX_MOVES];
+            MoveBudget aBudget = {2*CLOCK_SECOND,5*CLOCK_SECOND};  //sans pendule : quelques secondes par coup
+            if (aControl.itsMode != CLOCK_NONE)
+                aBudget = allocateTime(aFlow.itsClock,aGame.itsCurrentPlayer->itsRole,generateMoves(aGame,aMoves),aFlow.itsPly);
+            if (!searchMove(aGame,aBudget,&aTable,aMove))
             {
-                color(4,0);
-                cout<<"Position non-valide"<<endl;
-                color(defaultColor,0);
+                endFlow(aFlow,FLOW_BLOCKED);
+                break;
             }
-            aMove = {aPos,aPosEnd};
-            if (!isValidMovement(aGame,aMove))              //vérification de la validité du mouvement
+            aResult = playFlowMove(aFlow,aMove,getClockTime());
+        }
+        else
+        {
+            Player* aOpponent = (aGame.itsCurrentPlayer == &aGame.itsPlayer1) ? &aGame.itsPlayer2 : &aGame.itsPlayer1;
+            if (aOpponent->itsIsBot)  //l'ordinateur cherche pendant la saisie, la table garde ses resultats
+                startAnalysis(aPonder,aGame,aPonderConfig,AnalysisCallback());
+            do
             {
-                color(4,0);
-                cout<<"Mouvement non-valide"<<endl;
-                color(defaultColor,0);
-            }
+                cout<<"Au tour de '"<<aGame.itsCurrentPlayer->itsName<<"' qui joue : "<<aGame.itsCurrentPlayer->itsRole<<endl;
+                if (aControl.itsMode != CLOCK_NONE)
+                    cout<<"Temps restant : "<<formatClockTime(getTimeToFlag(aFlow.itsClock,aGame.itsCurrentPlayer->itsRole,getClockTime()))<<endl;
 
-        }while (!isValidMovement(aGame,aMove));
-        movePiece(aGame,aMove);     //déplacer la pièce
-        capturePieces(aGame,aMove); //enlever les possibles pièces capturées
-        displayBoard(aBoard);       //afficher le plateau
-        switchCurrentPlayer(aGame); //change le joueur actif
-    }while (!isGameFinished(aGame));
-        cout<<endl<<"Le vainqueur est '"<<whoWon(aGame)->itsName<<"' qui était en "<<whoWon(aGame)->itsRole<<endl; //affiche le gagnant
+                while (!getPositionFromInput(aPos,aGame.itsBoard))      //Position de la pièce à déplacer
+                {
+                    color(4,0);
+                    cout<<"Position non-valide"<<endl;
+                    color(defaultColor,0);
+                }
+                while (!getPositionFromInput(aPosEnd,aGame.itsBoard))   //Position d'arrivée de la pièce
+                {
+                    color(4,0);
+                    cout<<"Position non-valide"<<endl;
+                    color(defaultColor,0);
+                }
+                aMove = {aPos,aPosEnd};
+                aResult = playFlowMove(aFlow,aMove,getClockTime());  //vérification du mouvement, pendule et coup joué
+                if (aResult == FLOW_REFUSED)
+                {
+                    color(4,0);
+                    cout<<"Mouvement non-valide"<<endl;
+                    color(defaultColor,0);
+                }
+
+            }while (aResult == FLOW_REFUSED);
+            stopAnalysis(aPonder);
+        }
+        if (aFlow.itsState == FLOW_FINISHED && aFlow.itsEnd == FLOW_FLAGGED)  //temps depasse : le coup ne compte pas
+            break;
+        drawBoard(aRenderer,aGame.itsBoard);    //afficher le plateau
+        char aText[MOVE_STRING_SIZE];   //le texte sous le plateau vient d'etre efface : rappeler le coup
+        formatMove(aMove,aText,MOVE_STRING_SIZE);
+        cout<<"'"<<aMover<<"' a joue "<<aText<<endl;
+    }
+    if (aWriter.itsStream.is_open())
+    {
+        endRecord(aWriter,aGame);
+        closeRecordWriter(aWriter);
+    }
+    const Player* aWinner = getFlowWinner(aFlow);
+    if (aFlow.itsEnd == FLOW_BLOCKED)
+        cout<<endl<<"Partie arretee : '"<<aGame.itsCurrentPlayer->itsName<<"' n'a aucun coup possible"<<endl;
+    else
+    {
+        if (aFlow.itsEnd == FLOW_FLAGGED)
+            cout<<endl<<"'"<<aGame.itsCurrentPlayer->itsName<<"' a depasse son temps"<<endl;
+        cout<<"Le vainqueur est '"<<aWinner->itsName<<"' qui était en "<<aWinner->itsRole<<endl; //affiche le gagnant
+    }
+    deleteBoard(aGame.itsBoard);
 }
 
 void launchTest()
@@ -85,10 +188,234 @@ void launchTest()
     //test_isSwordLeft();
     //test_isKingEscaped();
     //test_isKingCaptured();
+    //test_notation();
+    //test_generateMoves();
+    //test_record();
+    //test_validateArchive();
+    //test_positionIndex();
+    //test_symmetry();
+    //test_tablebase();
+    //test_openingBook();
+    //test_evaluation();
+    //test_nnue();
+    //test_selfPlay();
+    //test_tuner();
+    //test_search();
+    //test_clock();
+    //test_searchStats();
+    //test_pondering();
+    //test_render();
+    //test_batch();
+    //test_engine();
+    //test_server();
+    //test_gamePool();
+    //test_broadcast();
+    //test_journal();
+    //test_timeline();
+    //test_gameFlow();
+    //test_searchPool();
 }
 
-int main()
+int main(int argc, char* argv[])
 {
+    if (argc >= 3 && string(argv[1]) == "--validate") //valider une archive : --validate fichier [threads]
+    {
+        ValidationReport aReport;
+        if (!validateArchive(argv[2],(argc >= 4) ? atoi(argv[3]) : 0,aReport))
+        {
+            cout<<"Impossible d'ouvrir "<<argv[2]<<endl;
+            return 1;
+        }
+        displayValidationReport(aReport);
+        return aReport.itsFailures.empty() && !aReport.itsTruncated ? 0 : 2;
+    }
+    if (argc >= 2 && string(argv[1]) == "--batch") //rejouer des parties ecrites une par ligne, sans affichage : --batch [fichier]
+    {
+        ios::sync_with_stdio(false);
+        ifstream aFile;
+        if (argc >= 3 && string(argv[2]) != "-")
+        {
+            aFile.open(argv[2]);
+            if (!aFile)
+            {
+                cerr<<"Impossible d'ouvrir "<<argv[2]<<endl;
+                return 1;
+            }
+        }
+        BatchReport aReport;
+        runBatch(aFile.is_open() ? aFile : cin,cout,aReport);
+        cerr<<aReport.itsGames<<" partie(s) en "<<aReport.itsSeconds<<" s : "<<aReport.itsCounts[BATCH_FINISHED]<<" terminee(s), "
+            <<aReport.itsCounts[BATCH_UNFINISHED]<<" inachevee(s), "<<aReport.itsCounts[BATCH_ILLEGAL]<<" avec un coup illegal, "
+            <<aReport.itsCounts[BATCH_INVALID]<<" illisible(s)"<<endl;
+        return (aReport.itsCounts[BATCH_ILLEGAL] + aReport.itsCounts[BATCH_INVALID] == 0) ? 0 : 2;
+    }
+    if (argc >= 2 && string(argv[1]) == "--engine") //protocole moteur sur l'entree et la sortie standard : --engine
+    {
+        runEngine(cin,cout);
+        return 0;
+    }
+    if (argc >= 2 && string(argv[1]) == "--server") //heberger des parties en TCP jusqu'a "quit" ou la fin de l'entree : --server [port] [threads] [journal]
+    {
+        Server aServer;
+        ServerConfig aConfig;
+        aConfig.itsPort = (argc >= 3) ? atoi(argv[2]) : aConfig.itsPort;
+        aConfig.itsThreads = (argc >= 4) ? atoi(argv[3]) : 0;
+        aConfig.itsJournal = (argc >= 5) ? argv[4] : "";
+        if (!startServer(aServer,aConfig))
+        {
+            cout<<"Impossible d'ecouter le port "<<aConfig.itsPort<<" ou d'ouvrir le journal"<<endl;
+            return 1;
+        }
+        cout<<"Serveur sur le port "<<aServer.itsPort<<" ("<<aServer.itsLoops.size()<<" boucle(s))"<<endl;
+        string aLine;
+        while (getline(cin,aLine) && aLine != "quit")
+            cout<<getServerGames(aServer)<<" partie(s) en cours, "<<getServerMoves(aServer)<<" coup(s) joue(s)"<<endl;
+        stopServer(aServer);
+        return 0;
+    }
+    if (argc >= 4 && string(argv[1]) == "--index") //indexer les positions d'une archive : --index archive index
+    {
+        if (!buildPositionIndex(argv[2],argv[3]))
+        {
+            cout<<"Indexation impossible"<<endl;
+            return 1;
+        }
+        return 0;
+    }
+    if (argc >= 4 && string(argv[1]) == "--query") //parties passees par une position : --query index "position"
+    {
+        PositionIndex aIndex;
+        Game aGame;
+        if (!openPositionIndex(aIndex,argv[2]) || !parsePosition(argv[3],aGame))
+        {
+            cout<<"Index ou position invalide"<<endl;
+            return 1;
+        }
+        const IndexEntry* aFirst;
+        uint64_t aCount = findPosition(aIndex,hashPosition(aGame),aFirst);
+        long aWins[3] = {0,0,0};
+        for (uint64_t i = 0; i < aCount; ++i)
+        {
+            cout<<"Partie "<<aFirst[i].itsGame<<" (coup "<<aFirst[i].itsPly<<") : resultat "<<int(aFirst[i].itsResult)<<endl;
+            aWins[aFirst[i].itsResult]++;
+        }
+        cout<<aCount<<" partie(s) : "<<aWins[RECORD_PLAYER1]<<" gagnee(s) par l'attaque, "<<aWins[RECORD_PLAYER2]
+            <<" par la defense, "<<aWins[RECORD_UNFINISHED]<<" inachevee(s)"<<endl;
+        closePositionIndex(aIndex);
+        deleteBoard(aGame.itsBoard);
+        return 0;
+    }
+
+    if (argc >= 4 && string(argv[1]) == "--replay") //revoir une partie d'une archive, coup par coup ou par saut : --replay archive numero
+    {
+        Timeline aTimeline;
+        Game aGame;
+        if (!loadRecordTimeline(argv[2],atol(argv[3]),aTimeline,aGame))
+        {
+            cout<<"Partie introuvable"<<endl;
+            return 1;
+        }
+        int aPly = 0;
+        seekTimeline(aTimeline,aGame,aPly);  //depart de la partie
+        BoardRenderer aRenderer;
+        string aLine;
+        while (true)
+        {
+            drawBoard(aRenderer,aGame.itsBoard);
+            cout<<aGame.itsPlayer1.itsName<<" contre "<<aGame.itsPlayer2.itsName<<" : coup "<<aPly<<" / "<<getTimelineLength(aTimeline)
+                <<" (entree ou + : suivant, - : precedent, numero : saut, q : quitter)"<<endl;
+            if (!getline(cin,aLine) || aLine == "q")
+                break;
+            if (aLine == "+" || aLine.empty())  //coup suivant
+                stepTimelineForward(aTimeline,aGame,aPly);
+            else if (aLine == "-")  //coup precedent
+                stepTimelineBackward(aTimeline,aGame,aPly);
+            else if (seekTimeline(aTimeline,aGame,atoi(aLine.c_str())))  //saut direct au coup demande
+                aPly = atoi(aLine.c_str());
+        }
+        deleteBoard(aGame.itsBoard);
+        return 0;
+    }
+
+    if (argc >= 3 && string(argv[1]) == "--analyse") //meilleurs coups d'une position, une ligne JSON par profondeur : --analyse "position" [lignes] [profondeur]
+    {
+        Game aGame;
+        if (!parsePosition(argv[2],aGame))
+        {
+            cout<<"Position invalide"<<endl;
+            return 1;
+        }
+        AnalysisConfig aConfig;
+        aConfig.itsLines = (argc >= 4) ? atoi(argv[3]) : aConfig.itsLines;
+        aConfig.itsMaxDepth = (argc >= 5) ? atoi(argv[4]) : 6;
+        aConfig.itsTiming = true; //temps par fonction dans le resume, au prix de noeuds en moins
+        Analysis aAnalysis;
+        SearchStats aStats;
+        startAnalysis(aAnalysis,aGame,aConfig,[&aStats](const AnalysisInfo& aInfo)
+        {
+            cout<<formatAnalysisJson(aInfo)<<endl;
+            aStats = aInfo.itsStats;
+        });
+        waitAnalysis(aAnalysis);
+        cerr<<formatStatsSummary(aStats);  //compteurs de la recherche, hors du flux JSON
+        deleteBoard(aGame.itsBoard);
+        return 0;
+    }
+
+    if (argc >= 4 && string(argv[1]) == "--book") //construire un livre d'ouvertures : --book archive livre [coups]
+    {
+        if (!buildOpeningBook(argv[2],argv[3],(argc >= 5) ? atoi(argv[4]) : BOOK_DEFAULT_PLIES))
+        {
+            cout<<"Construction du livre impossible"<<endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (argc >= 4 && string(argv[1]) == "--selfplay") //generer des positions d'entrainement : --selfplay parties prefixe [threads]
+    {
+        SelfPlayConfig aConfig;
+        aConfig.itsGames = strtoull(argv[2],nullptr,10);
+        aConfig.itsPrefix = argv[3];
+        aConfig.itsThreads = (argc >= 5) ? atoi(argv[4]) : 0;
+        SelfPlayReport aReport;
+        bool aWritten = generateSelfPlay(aConfig,aReport);
+        cout<<aReport.itsGames<<" parties, "<<aReport.itsSamples<<" positions dans "<<aReport.itsShards<<" fichier(s), "
+            <<aReport.itsDuplicates<<" doublon(s) ecarte(s) en "<<aReport.itsSeconds<<" s"<<endl;
+        cout<<formatStatsSummary(aReport.itsStats);
+        return aWritten ? 0 : 1;
+    }
+
+    if (argc >= 5 && string(argv[1]) == "--tablebase") //construire une table de finales : --tablebase boucliers epees dossier [threads]
+    {
+        if (!generateTablebase(atoi(argv[2]),atoi(argv[3]),argv[4],(argc >= 6) ? atoi(argv[5]) : 0))
+        {
+            cout<<"Construction impossible"<<endl;
+            return 1;
+        }
+        cout<<"Table "<<getTablebaseName(atoi(argv[2]),atoi(argv[3]))<<" construite"<<endl;
+        return 0;
+    }
+
+    if (argc >= 4 && string(argv[1]) == "--tune") //regler les poids de l'evaluation : --tune poids shard...
+    {
+        EvalWeights aWeights;
+        if (!loadEvalWeights(aWeights,argv[2]))
+            aWeights = DEFAULT_EVAL_WEIGHTS;
+        TunerData aData;
+        if (!loadTunerData(vector<string>(argv + 3,argv + argc),aData))
+        {
+            cout<<"Impossible d'ouvrir les positions"<<endl;
+            return 1;
+        }
+        TunerConfig aConfig;
+        aConfig.itsVerbose = true;
+        cout<<aData.itsTargets.size()<<" positions, perte initiale "<<getTunerLoss(aData,aWeights,aConfig)<<endl;
+        double aLoss = tuneEvalWeights(aData,aConfig,aWeights);
+        cout<<"Perte finale "<<aLoss<<endl;
+        return saveEvalWeights(aWeights,argv[2]) ? 0 : 1;
+    }
+
     //launchTest();
     itsGame();
     return 0;
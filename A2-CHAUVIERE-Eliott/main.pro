@@ -1,14 +1,69 @@
 TEMPLATE = app
-CONFIG += console c++17
+CONFIG += console c++17 thread
 CONFIG -= app_bundle
 CONFIG -= qt
+# DEFINES += HNEFATAFL_NO_STATS # retire les compteurs de recherche
 
 SOURCES += \
+        batch.cpp \
+        broadcast.cpp \
+        book.cpp \
+        clock.cpp \
+        engine.cpp \
+        evaluation.cpp \
         functions.cpp \
+        gameflow.cpp \
+        hash.cpp \
+        journal.cpp \
         main.cpp \
-        test.cpp
+        mappedfile.cpp \
+        movegen.cpp \
+        nnue.cpp \
+        notation.cpp \
+        pool.cpp \
+        posindex.cpp \
+        record.cpp \
+        render.cpp \
+        search.cpp \
+        searchpool.cpp \
+        selfplay.cpp \
+        server.cpp \
+        stats.cpp \
+        symmetry.cpp \
+        tablebase.cpp \
+        timeline.cpp \
+        test.cpp \
+        tuner.cpp \
+        validator.cpp
 
 HEADERS += \
+    batch.h \
+    broadcast.h \
+    book.h \
+    clock.h \
+    engine.h \
+    evaluation.h \
     functions.h \
+    gameflow.h \
+    hash.h \
+    journal.h \
+    mappedfile.h \
+    movegen.h \
+    nnue.h \
+    notation.h \
+    pool.h \
+    posindex.h \
+    record.h \
+    render.h \
+    search.h \
+    searchpool.h \
+    selfplay.h \
+    server.h \
+    stats.h \
+    symmetry.h \
+    tablebase.h \
+    timeline.h \
     test.h \
-    typeDef.h
+    tuner.h \
+    typeDef.h \
+    validator.h
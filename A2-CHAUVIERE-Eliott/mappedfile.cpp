@@ -0,0 +1,85 @@
+#include "mappedfile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+bool openMappedFile(MappedFile& aFile, const string& aPath)
+{
+    HANDLE file = CreateFileA(aPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* data = (mapping != nullptr) ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (data == nullptr)
+    {
+        if (mapping != nullptr)
+            CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    aFile.itsData = static_cast<const unsigned char*>(data);
+    aFile.itsSize = size_t(size.QuadPart);
+    aFile.itsFile = file;
+    aFile.itsMapping = mapping;
+    return true;
+}
+
+void closeMappedFile(MappedFile& aFile)
+{
+    if (aFile.itsData == nullptr)
+        return;
+    UnmapViewOfFile(aFile.itsData);
+    CloseHandle(aFile.itsMapping);
+    CloseHandle(aFile.itsFile);
+    aFile = MappedFile();
+}
+
+#else
+
+bool openMappedFile(MappedFile& aFile, const string& aPath)
+{
+    int descriptor = open(aPath.c_str(), O_RDONLY);
+    if (descriptor == -1)
+        return false;
+    struct stat info;
+    if (fstat(descriptor, &info) == -1 || info.st_size == 0)
+    {
+        close(descriptor);
+        return false;
+    }
+    void* data = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_SHARED, descriptor, 0);
+    if (data == MAP_FAILED)
+    {
+        close(descriptor);
+        return false;
+    }
+    aFile.itsData = static_cast<const unsigned char*>(data);
+    aFile.itsSize = size_t(info.st_size);
+    aFile.itsDescriptor = descriptor;
+    return true;
+}
+
+void closeMappedFile(MappedFile& aFile)
+{
+    if (aFile.itsData == nullptr)
+        return;
+    munmap(const_cast<unsigned char*>(aFile.itsData), aFile.itsSize);
+    close(aFile.itsDescriptor);
+    aFile = MappedFile();
+}
+
+#endif
@@ -0,0 +1,51 @@
+/**
+ * @file mappedfile.h
+ *
+ * @brief Read-only memory mapping of a file (Windows and POSIX).
+ *
+ * The databases of the game (position index, opening book, tablebases...) are read through
+ * a mapping, so that only the pages actually visited are loaded and several processes share them.
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include "typeDef.h"
+
+/**
+ * @struct MappedFile
+ * @brief A file mapped in memory, read only.
+ */
+struct MappedFile
+{
+    const unsigned char* itsData = nullptr; /**< First byte of the file, or nullptr if not mapped. */
+    size_t itsSize = 0;                     /**< Size of the file in bytes. */
+#ifdef _WIN32
+    void* itsFile = nullptr;                /**< Handle of the file. */
+    void* itsMapping = nullptr;             /**< Handle of the mapping object. */
+#else
+    int itsDescriptor = -1;                 /**< Descriptor of the file. */
+#endif
+};
+
+/**
+ * @brief Maps a whole file in memory, read only.
+ *
+ * @param aFile The mapping to open.
+ * @param aPath The path of the file.
+ * @return `true` if the file is mapped, `false` if it cannot be opened or is empty.
+ */
+bool openMappedFile(MappedFile& aFile, const string& aPath);
+
+/**
+ * @brief Unmaps a file and closes it. Does nothing if the file is not mapped.
+ *
+ * @param aFile The mapping to close.
+ */
+void closeMappedFile(MappedFile& aFile);
+
+#endif // MAPPEDFILE_H
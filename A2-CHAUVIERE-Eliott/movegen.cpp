@@ -0,0 +1,96 @@
+#include "movegen.h"
+#include "functions.h"
+#include "stats.h"
+
+// haut, bas, gauche, droite
+static const int DIR_ROW[4] = {-1, 1, 0, 0};
+static const int DIR_COL[4] = {0, 0, -1, 1};
+
+int generateMoves(const Game& aGame, Move* aMoves)
+{
+    const Board& aBoard = aGame.itsBoard;
+    int size = aBoard.itsSize;
+    bool attack = (aGame.itsCurrentPlayer->itsRole == ATTACK);
+    int count = 0;
+
+    for (int i = 0; i < size; ++i) {
+        for (int j = 0; j < size; ++j) {
+            PieceType piece = aBoard.itsCells[i][j].itsPieceType;
+            if (attack ? (piece != SWORD) : (piece != SHIELD && piece != KING))
+                continue;
+            for (int d = 0; d < 4; ++d) {
+                int row = i + DIR_ROW[d];
+                int col = j + DIR_COL[d];
+                // on avance tant que la case est libre (et normale, sauf pour le roi)
+                while (row >= 0 && row < size && col >= 0 && col < size
+                       && aBoard.itsCells[row][col].itsPieceType == NONE
+                       && (piece == KING || aBoard.itsCells[row][col].itsCellType == NORMAL))
+                {
+                    aMoves[count++] = {{i, j}, {row, col}};
+                    row += DIR_ROW[d];
+                    col += DIR_COL[d];
+                }
+            }
+        }
+    }
+    return count;
+}
+
+int getMoveIndex(const Game& aGame, const Move& aMove)
+{
+    Move moves[MAX_MOVES];
+    int count = generateMoves(aGame, moves);
+    for (int i = 0; i < count; ++i) {
+        if (moves[i].itsStartPosition.itsRow == aMove.itsStartPosition.itsRow
+            && moves[i].itsStartPosition.itsCol == aMove.itsStartPosition.itsCol
+            && moves[i].itsEndPosition.itsRow == aMove.itsEndPosition.itsRow
+            && moves[i].itsEndPosition.itsCol == aMove.itsEndPosition.itsCol)
+            return i;
+    }
+    return -1;
+}
+
+Position getNeighbour(const Move& aMove, int aDirection)
+{
+    return {aMove.itsEndPosition.itsRow + DIR_ROW[aDirection], aMove.itsEndPosition.itsCol + DIR_COL[aDirection]};
+}
+
+void makeMove(Game& aGame, const Move& aMove, MoveUndo& aUndo)
+{
+    // voisins relevés après le déplacement : la case de départ peut être l'un d'eux
+    movePiece(aGame, aMove);
+    Position neighbours[4];
+    for (int d = 0; d < 4; ++d) {
+        neighbours[d] = getNeighbour(aMove, d);
+        aUndo.itsNeighbours[d] = isValidPosition(neighbours[d], aGame.itsBoard)
+                                     ? aGame.itsBoard.itsCells[neighbours[d].itsRow][neighbours[d].itsCol].itsPieceType
+                                     : NONE;
+    }
+    {
+        STATS_TIME(itsCaptureTime);
+        capturePieces(aGame, aMove);
+    }
+    switchCurrentPlayer(aGame);
+
+    // les voisins devenus vides ont été capturés
+    aUndo.itsCaptured = 0;
+    for (int d = 0; d < 4; ++d) {
+        if (aUndo.itsNeighbours[d] != NONE
+            && aGame.itsBoard.itsCells[neighbours[d].itsRow][neighbours[d].itsCol].itsPieceType == NONE)
+            aUndo.itsCaptured |= 1 << d;
+    }
+}
+
+void unmakeMove(Game& aGame, const Move& aMove, const MoveUndo& aUndo)
+{
+    switchCurrentPlayer(aGame);
+    for (int d = 0; d < 4; ++d) {
+        if (aUndo.itsCaptured & (1 << d)) {
+            Position pos = getNeighbour(aMove, d);
+            aGame.itsBoard.itsCells[pos.itsRow][pos.itsCol].itsPieceType = aUndo.itsNeighbours[d];
+            if (aGame.itsHooks != nullptr)
+                aGame.itsHooks->itsOnPlace(aGame.itsHooks->itsContext, aUndo.itsNeighbours[d], pos);
+        }
+    }
+    movePiece(aGame, {aMove.itsEndPosition, aMove.itsStartPosition});
+}
@@ -0,0 +1,89 @@
+/**
+ * @file movegen.h
+ *
+ * @brief Generation of the legal moves of the current player.
+ *
+ * The moves follow the same rules as `isValidMovement`: a piece slides horizontally or
+ * vertically over empty cells; only the king may cross or stop on a fortress or the castle.
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef MOVEGEN_H
+#define MOVEGEN_H
+
+#include "typeDef.h"
+
+/**
+ * @brief Upper bound of the number of legal moves in a position.
+ *
+ * At most 24 pieces per side (swords on a 13x13 board), each reaching at most 24 cells.
+ */
+const int MAX_MOVES = 576;
+
+/**
+ * @struct MoveUndo
+ * @brief What `unmakeMove` needs to take a move back.
+ *
+ * `capturePieces` can only remove the four neighbours of the end cell of the move,
+ * so their pieces are saved before the move is played.
+ */
+struct MoveUndo
+{
+    PieceType itsNeighbours[4]; /**< Pieces above, below, left and right of the end cell before the captures. */
+    int itsCaptured;            /**< Bit d is set if neighbour d (same order) was captured. */
+};
+
+/**
+ * @brief Plays a legal move: `movePiece`, `capturePieces`, then `switchCurrentPlayer`.
+ *
+ * @param aGame The game.
+ * @param aMove The move, assumed legal.
+ * @param aUndo Receives what is needed to take the move back.
+ */
+void makeMove(Game& aGame, const Move& aMove, MoveUndo& aUndo);
+
+/**
+ * @brief Takes back a move played with `makeMove` (captured pieces are put back).
+ *
+ * The hooks of the game, if any, see the piece move back (`itsOnMove`) and each captured piece put back (`itsOnPlace`).
+ *
+ * @param aGame The game.
+ * @param aMove The move.
+ * @param aUndo The information saved by `makeMove`.
+ */
+void unmakeMove(Game& aGame, const Move& aMove, const MoveUndo& aUndo);
+
+/**
+ * @brief Returns the cell of a neighbour of the end cell of a move.
+ *
+ * @param aMove The move.
+ * @param aDirection 0 (above), 1 (below), 2 (left) or 3 (right), as in `MoveUndo`.
+ * @return The neighbour cell (possibly outside the board).
+ */
+Position getNeighbour(const Move& aMove, int aDirection);
+
+/**
+ * @brief Lists the legal moves of the current player.
+ *
+ * The order of the list is fixed: starting cells are scanned row by row, and from each
+ * piece the directions up, down, left and right are explored, nearest cell first.
+ * This order is part of the game record format, where a move is stored as its index in this list.
+ *
+ * @param aGame The game, with the board and the current player.
+ * @param aMoves An array of at least `MAX_MOVES` moves receiving the list.
+ * @return The number of moves written in `aMoves`.
+ */
+int generateMoves(const Game& aGame, Move* aMoves);
+
+/**
+ * @brief Finds the index of a move in the list produced by `generateMoves`.
+ *
+ * @param aGame The game, with the board and the current player.
+ * @param aMove The move to look for.
+ * @return The index of the move, or -1 if the move is not legal.
+ */
+int getMoveIndex(const Game& aGame, const Move& aMove);
+
+#endif // MOVEGEN_H
@@ -0,0 +1,341 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+// le code AVX2 est compilé pour sa cible quelles que soient les options, et choisi au lancement
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NNUE_AVX2
+#define NNUE_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+using namespace std;
+#include "nnue.h"
+
+static const int NNUE_HEADER_SIZE = 32;
+static const int NNUE_OUTPUT_SHIFT = 6;
+
+/**
+ * En-tête d'un fichier de réseau.
+ */
+struct NnueHeader
+{
+    uint64_t itsMagic;
+    uint32_t itsFeatures;
+    uint32_t itsL1;
+    uint32_t itsL2;
+    uint32_t itsL3;
+    uint32_t itsUnused[2];
+};
+
+// taille des données qui suivent l'en-tête
+static size_t getNetworkSize()
+{
+    return size_t(NNUE_FEATURES) * NNUE_L1 * sizeof(int16_t) + NNUE_L1 * sizeof(int16_t)
+           + size_t(NNUE_L2) * NNUE_L1 + NNUE_L2 * sizeof(int32_t)
+           + size_t(NNUE_L3) * NNUE_L2 + NNUE_L3 * sizeof(int32_t)
+           + 2 * NNUE_L3 + 2 * sizeof(int32_t);
+}
+
+bool openNnueNetwork(NnueNetwork& aNetwork, const string& aPath)
+{
+    if (!openMappedFile(aNetwork.itsFile, aPath))
+        return false;
+    const NnueHeader* header = reinterpret_cast<const NnueHeader*>(aNetwork.itsFile.itsData);
+    if (aNetwork.itsFile.itsSize != NNUE_HEADER_SIZE + getNetworkSize() || header->itsMagic != NNUE_MAGIC
+        || header->itsFeatures != uint32_t(NNUE_FEATURES) || header->itsL1 != uint32_t(NNUE_L1)
+        || header->itsL2 != uint32_t(NNUE_L2) || header->itsL3 != uint32_t(NNUE_L3)) {
+        closeMappedFile(aNetwork.itsFile);
+        return false;
+    }
+
+    // les tableaux se suivent ; les tailles gardent chacun aligné sur 32 octets jusqu'à la dernière couche
+    const unsigned char* data = aNetwork.itsFile.itsData + NNUE_HEADER_SIZE;
+    aNetwork.itsFeatureWeights = reinterpret_cast<const int16_t*>(data);
+    data += size_t(NNUE_FEATURES) * NNUE_L1 * sizeof(int16_t);
+    aNetwork.itsFeatureBiases = reinterpret_cast<const int16_t*>(data);
+    data += NNUE_L1 * sizeof(int16_t);
+    aNetwork.itsWeights1 = reinterpret_cast<const int8_t*>(data);
+    data += size_t(NNUE_L2) * NNUE_L1;
+    aNetwork.itsBiases1 = reinterpret_cast<const int32_t*>(data);
+    data += NNUE_L2 * sizeof(int32_t);
+    aNetwork.itsWeights2 = reinterpret_cast<const int8_t*>(data);
+    data += size_t(NNUE_L3) * NNUE_L2;
+    aNetwork.itsBiases2 = reinterpret_cast<const int32_t*>(data);
+    data += NNUE_L3 * sizeof(int32_t);
+    aNetwork.itsOutputWeights = reinterpret_cast<const int8_t*>(data);
+    data += 2 * NNUE_L3;
+    aNetwork.itsOutputBiases = reinterpret_cast<const int32_t*>(data);
+    return true;
+}
+
+void closeNnueNetwork(NnueNetwork& aNetwork)
+{
+    closeMappedFile(aNetwork.itsFile);
+    aNetwork = NnueNetwork();
+}
+
+// générateur splitmix64
+static uint64_t nextRandom(uint64_t& aState)
+{
+    uint64_t z = (aState += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// valeur aléatoire dans [-aRange, aRange]
+static int randomValue(uint64_t& aState, int aRange)
+{
+    return int(nextRandom(aState) % uint64_t(2 * aRange + 1)) - aRange;
+}
+
+bool createNnueNetwork(const string& aPath, uint64_t aSeed)
+{
+    NnueHeader header = {NNUE_MAGIC, uint32_t(NNUE_FEATURES), uint32_t(NNUE_L1), uint32_t(NNUE_L2), uint32_t(NNUE_L3), {0, 0}};
+    vector<unsigned char> data(getNetworkSize());
+    unsigned char* out = data.data();
+    uint64_t state = aSeed;
+
+    auto fill16 = [&](size_t aCount, int aRange) {
+        for (size_t i = 0; i < aCount; ++i, out += sizeof(int16_t)) {
+            int16_t value = int16_t(randomValue(state, aRange));
+            memcpy(out, &value, sizeof(value));
+        }
+    };
+    auto fill8 = [&](size_t aCount, int aRange) {
+        for (size_t i = 0; i < aCount; ++i)
+            *out++ = static_cast<unsigned char>(int8_t(randomValue(state, aRange)));
+    };
+    auto fill32 = [&](size_t aCount, int aRange) {
+        for (size_t i = 0; i < aCount; ++i, out += sizeof(int32_t)) {
+            int32_t value = randomValue(state, aRange);
+            memcpy(out, &value, sizeof(value));
+        }
+    };
+    fill16(size_t(NNUE_FEATURES) * NNUE_L1, 24);
+    fill16(NNUE_L1, 32);
+    fill8(size_t(NNUE_L2) * NNUE_L1, 32);
+    fill32(NNUE_L2, 2000);
+    fill8(size_t(NNUE_L3) * NNUE_L2, 48);
+    fill32(NNUE_L3, 2000);
+    fill8(2 * NNUE_L3, 64);
+    fill32(2, 4000);
+
+    ofstream file(aPath, ios::binary | ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(data.data()), streamsize(data.size()));
+    return bool(file);
+}
+
+// ligne de poids d'une pièce sur une case (les deux tailles de plateau ont des entrées distinctes)
+static const int16_t* getFeatureRow(const NnueEvaluator& aEvaluator, PieceType aPiece, const Position& aPos)
+{
+    int feature = aEvaluator.itsSizeOffset + (int(aPiece) - 1) * BIG * BIG + aPos.itsRow * BIG + aPos.itsCol;
+    return aEvaluator.itsNetwork->itsFeatureWeights + size_t(feature) * NNUE_L1;
+}
+
+#ifdef NNUE_AVX2
+static bool detectAvx2()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+static const bool nnueAvx2 = detectAvx2();
+
+NNUE_TARGET_AVX2 static void addRowAvx2(int16_t* aAccumulator, const int16_t* aRow)
+{
+    for (int i = 0; i < NNUE_L1; i += 16) {
+        __m256i sum = _mm256_add_epi16(_mm256_load_si256(reinterpret_cast<const __m256i*>(aAccumulator + i)),
+                                       _mm256_loadu_si256(reinterpret_cast<const __m256i*>(aRow + i)));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(aAccumulator + i), sum);
+    }
+}
+
+NNUE_TARGET_AVX2 static void subRowAvx2(int16_t* aAccumulator, const int16_t* aRow)
+{
+    for (int i = 0; i < NNUE_L1; i += 16) {
+        __m256i difference = _mm256_sub_epi16(_mm256_load_si256(reinterpret_cast<const __m256i*>(aAccumulator + i)),
+                                              _mm256_loadu_si256(reinterpret_cast<const __m256i*>(aRow + i)));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(aAccumulator + i), difference);
+    }
+}
+#else
+static const bool nnueAvx2 = false;
+#endif
+
+static void addRow(int16_t* aAccumulator, const int16_t* aRow)
+{
+#ifdef NNUE_AVX2
+    if (nnueAvx2) {
+        addRowAvx2(aAccumulator, aRow);
+        return;
+    }
+#endif
+    for (int i = 0; i < NNUE_L1; ++i)
+        aAccumulator[i] = int16_t(aAccumulator[i] + aRow[i]);
+}
+
+static void subRow(int16_t* aAccumulator, const int16_t* aRow)
+{
+#ifdef NNUE_AVX2
+    if (nnueAvx2) {
+        subRowAvx2(aAccumulator, aRow);
+        return;
+    }
+#endif
+    for (int i = 0; i < NNUE_L1; ++i)
+        aAccumulator[i] = int16_t(aAccumulator[i] - aRow[i]);
+}
+
+static void onMove(void* aContext, PieceType aPiece, const Position& aFrom, const Position& aTo)
+{
+    NnueEvaluator& evaluator = *static_cast<NnueEvaluator*>(aContext);
+    subRow(evaluator.itsAccumulator, getFeatureRow(evaluator, aPiece, aFrom));
+    addRow(evaluator.itsAccumulator, getFeatureRow(evaluator, aPiece, aTo));
+}
+
+static void onRemove(void* aContext, PieceType aPiece, const Position& aPos)
+{
+    NnueEvaluator& evaluator = *static_cast<NnueEvaluator*>(aContext);
+    subRow(evaluator.itsAccumulator, getFeatureRow(evaluator, aPiece, aPos));
+}
+
+static void onPlace(void* aContext, PieceType aPiece, const Position& aPos)
+{
+    NnueEvaluator& evaluator = *static_cast<NnueEvaluator*>(aContext);
+    addRow(evaluator.itsAccumulator, getFeatureRow(evaluator, aPiece, aPos));
+}
+
+void attachNnue(NnueEvaluator& aEvaluator, const NnueNetwork& aNetwork, Game& aGame)
+{
+    const Board& aBoard = aGame.itsBoard;
+    aEvaluator.itsNetwork = &aNetwork;
+    aEvaluator.itsSizeOffset = (aBoard.itsSize == BIG) ? 3 * BIG * BIG : 0;
+    copy(aNetwork.itsFeatureBiases, aNetwork.itsFeatureBiases + NNUE_L1, aEvaluator.itsAccumulator);
+    for (int i = 0; i < aBoard.itsSize; ++i)
+        for (int j = 0; j < aBoard.itsSize; ++j)
+            if (aBoard.itsCells[i][j].itsPieceType != NONE)
+                addRow(aEvaluator.itsAccumulator, getFeatureRow(aEvaluator, aBoard.itsCells[i][j].itsPieceType, {i, j}));
+
+    aEvaluator.itsHooks.itsOnMove = onMove;
+    aEvaluator.itsHooks.itsOnRemove = onRemove;
+    aEvaluator.itsHooks.itsOnPlace = onPlace;
+    aEvaluator.itsHooks.itsContext = &aEvaluator;
+    aGame.itsHooks = &aEvaluator.itsHooks;
+}
+
+void detachNnue(NnueEvaluator& aEvaluator, Game& aGame)
+{
+    if (aGame.itsHooks == &aEvaluator.itsHooks)
+        aGame.itsHooks = nullptr;
+}
+
+static uint8_t clip(int aValue)
+{
+    return uint8_t(min(127, max(0, aValue)));
+}
+
+// couche dense : sorties écrêtées de sum(entrée * poids) / 64 + biais
+static void denseScalar(const uint8_t* aInput, int aInputs, const int8_t* aWeights, const int32_t* aBiases, int aOutputs, uint8_t* aOutput)
+{
+    for (int o = 0; o < aOutputs; ++o) {
+        int32_t sum = aBiases[o];
+        for (int i = 0; i < aInputs; ++i)
+            sum += int32_t(aInput[i]) * aWeights[o * aInputs + i];
+        aOutput[o] = clip(sum >> NNUE_WEIGHT_SHIFT);
+    }
+}
+
+static int forwardScalar(const NnueEvaluator& aEvaluator, const Game& aGame)
+{
+    const NnueNetwork& net = *aEvaluator.itsNetwork;
+    uint8_t input[NNUE_L1];
+    uint8_t hidden1[NNUE_L2];
+    uint8_t hidden2[NNUE_L3];
+    for (int i = 0; i < NNUE_L1; ++i)
+        input[i] = clip(aEvaluator.itsAccumulator[i]);
+    denseScalar(input, NNUE_L1, net.itsWeights1, net.itsBiases1, NNUE_L2, hidden1);
+    denseScalar(hidden1, NNUE_L2, net.itsWeights2, net.itsBiases2, NNUE_L3, hidden2);
+
+    int side = (aGame.itsCurrentPlayer->itsRole == ATTACK) ? 0 : 1;
+    int32_t output = net.itsOutputBiases[side];
+    for (int i = 0; i < NNUE_L3; ++i)
+        output += int32_t(hidden2[i]) * net.itsOutputWeights[side * NNUE_L3 + i];
+    return output >> NNUE_OUTPUT_SHIFT;
+}
+
+#ifdef NNUE_AVX2
+// somme des 8 entiers 32 bits d'un registre
+NNUE_TARGET_AVX2 static int32_t sumLanes(__m256i aValue)
+{
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(aValue), _mm256_extracti128_si256(aValue, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+}
+
+// produit scalaire de 32 octets non signés par 32 octets signés, par blocs de 32 (les produits ne saturent pas : 2 x 127 x 127 < 32767)
+NNUE_TARGET_AVX2 static int32_t dotAvx2(const uint8_t* aInput, const int8_t* aWeights, int aCount)
+{
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i sum = _mm256_setzero_si256();
+    for (int i = 0; i < aCount; i += 32) {
+        __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(aInput + i));
+        __m256i weights = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(aWeights + i));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(input, weights), ones));
+    }
+    return sumLanes(sum);
+}
+
+NNUE_TARGET_AVX2 static void denseAvx2(const uint8_t* aInput, int aInputs, const int8_t* aWeights, const int32_t* aBiases, int aOutputs, uint8_t* aOutput)
+{
+    for (int o = 0; o < aOutputs; ++o)
+        aOutput[o] = clip((aBiases[o] + dotAvx2(aInput, aWeights + o * aInputs, aInputs)) >> NNUE_WEIGHT_SHIFT);
+}
+
+NNUE_TARGET_AVX2 static int forwardAvx2(const NnueEvaluator& aEvaluator, const Game& aGame)
+{
+    const NnueNetwork& net = *aEvaluator.itsNetwork;
+    alignas(32) uint8_t input[NNUE_L1];
+    alignas(32) uint8_t hidden1[NNUE_L2];
+    alignas(32) uint8_t hidden2[NNUE_L3];
+
+    // écrêtage de l'accumulateur : 16 + 16 valeurs 16 bits regroupées en 32 octets
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i top = _mm256_set1_epi16(127);
+    for (int i = 0; i < NNUE_L1; i += 32) {
+        __m256i low = _mm256_load_si256(reinterpret_cast<const __m256i*>(aEvaluator.itsAccumulator + i));
+        __m256i high = _mm256_load_si256(reinterpret_cast<const __m256i*>(aEvaluator.itsAccumulator + i + 16));
+        low = _mm256_min_epi16(_mm256_max_epi16(low, zero), top);
+        high = _mm256_min_epi16(_mm256_max_epi16(high, zero), top);
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(input + i), packed);
+    }
+    denseAvx2(input, NNUE_L1, net.itsWeights1, net.itsBiases1, NNUE_L2, hidden1);
+    denseAvx2(hidden1, NNUE_L2, net.itsWeights2, net.itsBiases2, NNUE_L3, hidden2);
+
+    int side = (aGame.itsCurrentPlayer->itsRole == ATTACK) ? 0 : 1;
+    int32_t output = net.itsOutputBiases[side] + dotAvx2(hidden2, net.itsOutputWeights + side * NNUE_L3, NNUE_L3);
+    return output >> NNUE_OUTPUT_SHIFT;
+}
+#endif
+
+int evaluateNnue(const NnueEvaluator& aEvaluator, const Game& aGame)
+{
+#ifdef NNUE_AVX2
+    if (nnueAvx2)
+        return forwardAvx2(aEvaluator, aGame);
+#endif
+    return forwardScalar(aEvaluator, aGame);
+}
+
+bool hasNnueAvx2()
+{
+    return nnueAvx2;
+}
+
+int evaluateNnueScalar(const NnueEvaluator& aEvaluator, const Game& aGame)
+{
+    return forwardScalar(aEvaluator, aGame);
+}
@@ -0,0 +1,163 @@
+/**
+ * @file nnue.h
+ *
+ * @brief Efficiently updatable neural network evaluation.
+ *
+ * The input of the network is sparse: one feature per (board size, piece, cell), i.e.
+ * 2 x 3 x 169 features of which at most 37 are active. The first layer is therefore an
+ * accumulator of `NNUE_L1` 16-bit sums of weight rows, kept up to date by the `GameHooks`
+ * of the game: a move subtracts one row and adds another, a capture subtracts one row.
+ * The following layers are small 8-bit dense layers computed at each evaluation, with AVX2
+ * when the processor has it (checked once at start-up, no compiler flag needed: the AVX2
+ * functions are compiled for that target on x86 with GCC or Clang) and with plain loops
+ * otherwise; both give exactly the same result. The last layer has one output per side to move.
+ *
+ * Network file (in the byte order of the machine): a 32-byte header (`NNUE_MAGIC` then the
+ * layer sizes), then int16 feature weights [features][L1] and biases [L1], int8 weights
+ * [L2][L1] and int32 biases [L2], int8 weights [L3][L2] and int32 biases [L3], int8 weights
+ * [2][L3] and int32 biases [2]. The file is mapped in memory and used in place.
+ *
+ * Quantization: accumulator and hidden values are clipped to [0, 127] (127 = 1.0), dense
+ * weights have a scale of 64 (`NNUE_WEIGHT_SHIFT`).
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef NNUE_H
+#define NNUE_H
+
+#include <cstdint>
+#include "typeDef.h"
+#include "mappedfile.h"
+
+/**
+ * @brief First 8 bytes of a network file.
+ */
+const uint64_t NNUE_MAGIC = 0x31554E4E54414648ULL; // "HFATNNU1"
+
+/**
+ * @brief Number of input features: 2 board sizes, 3 pieces, 13x13 cells.
+ */
+const int NNUE_FEATURES = 2 * 3 * BIG * BIG;
+
+/**
+ * @brief Size of the accumulator (first layer).
+ */
+const int NNUE_L1 = 256;
+
+/**
+ * @brief Size of the second layer.
+ */
+const int NNUE_L2 = 32;
+
+/**
+ * @brief Size of the third layer.
+ */
+const int NNUE_L3 = 32;
+
+/**
+ * @brief Scale of the dense weights (as a shift: 64 = 1.0).
+ */
+const int NNUE_WEIGHT_SHIFT = 6;
+
+/**
+ * @struct NnueNetwork
+ * @brief A network file mapped in memory.
+ */
+struct NnueNetwork
+{
+    MappedFile itsFile;                          /**< The mapped file. */
+    const int16_t* itsFeatureWeights = nullptr;  /**< [NNUE_FEATURES][NNUE_L1] */
+    const int16_t* itsFeatureBiases = nullptr;   /**< [NNUE_L1] */
+    const int8_t* itsWeights1 = nullptr;         /**< [NNUE_L2][NNUE_L1] */
+    const int32_t* itsBiases1 = nullptr;         /**< [NNUE_L2] */
+    const int8_t* itsWeights2 = nullptr;         /**< [NNUE_L3][NNUE_L2] */
+    const int32_t* itsBiases2 = nullptr;         /**< [NNUE_L3] */
+    const int8_t* itsOutputWeights = nullptr;    /**< [2][NNUE_L3], one row per side to move. */
+    const int32_t* itsOutputBiases = nullptr;    /**< [2] */
+};
+
+/**
+ * @struct NnueEvaluator
+ * @brief Accumulator of a game.
+ *
+ * Once attached, the evaluator is referenced by the game (`itsHooks`), so it must not be
+ * moved or destroyed before `detachNnue`.
+ */
+struct NnueEvaluator
+{
+    alignas(32) int16_t itsAccumulator[NNUE_L1]; /**< Sums of the weight rows of the active features. */
+    const NnueNetwork* itsNetwork = nullptr;     /**< The network. */
+    int itsSizeOffset = 0;                       /**< First feature of the board size of the game. */
+    GameHooks itsHooks;                          /**< Hooks installed in the game. */
+};
+
+/**
+ * @brief Maps a network file in memory.
+ *
+ * @param aNetwork The network to open.
+ * @param aPath The path of the network file.
+ * @return `true` if the file is a valid network of the sizes above.
+ */
+bool openNnueNetwork(NnueNetwork& aNetwork, const string& aPath);
+
+/**
+ * @brief Unmaps a network file.
+ *
+ * @param aNetwork The network to close.
+ */
+void closeNnueNetwork(NnueNetwork& aNetwork);
+
+/**
+ * @brief Writes a network with small random weights (a starting point for training, and for tests).
+ *
+ * @param aPath The path of the network file.
+ * @param aSeed The seed of the random weights.
+ * @return `true` if the file was written.
+ */
+bool createNnueNetwork(const string& aPath, uint64_t aSeed);
+
+/**
+ * @brief Computes the accumulator of a game and installs the hooks that keep it up to date.
+ *
+ * @param aEvaluator The evaluator.
+ * @param aNetwork The open network.
+ * @param aGame The game (its board must exist).
+ */
+void attachNnue(NnueEvaluator& aEvaluator, const NnueNetwork& aNetwork, Game& aGame);
+
+/**
+ * @brief Removes the hooks of an evaluator from a game.
+ *
+ * @param aEvaluator The evaluator.
+ * @param aGame The game.
+ */
+void detachNnue(NnueEvaluator& aEvaluator, Game& aGame);
+
+/**
+ * @brief Evaluates a position with the network.
+ *
+ * @param aEvaluator The evaluator attached to the game.
+ * @param aGame The game.
+ * @return The score for the player to move.
+ */
+int evaluateNnue(const NnueEvaluator& aEvaluator, const Game& aGame);
+
+/**
+ * @brief Evaluates a position with the plain loops, whatever the target (reference for the vector code).
+ *
+ * @param aEvaluator The evaluator attached to the game.
+ * @param aGame The game.
+ * @return The score for the player to move.
+ */
+int evaluateNnueScalar(const NnueEvaluator& aEvaluator, const Game& aGame);
+
+/**
+ * @brief Tells whether the evaluation uses the AVX2 code on this processor.
+ *
+ * @return `true` if AVX2 was detected at start-up.
+ */
+bool hasNnueAvx2();
+
+#endif // NNUE_H
@@ -0,0 +1,214 @@
+#include "notation.h"
+#include "functions.h"
+
+// écrit un entier positif (< 100) dans le buffer, renvoie le nombre de caractères écrits
+static int writeNumber(int aNumber, char* aBuffer)
+{
+    if (aNumber >= 10)
+    {
+        aBuffer[0] = char('0' + aNumber / 10);
+        aBuffer[1] = char('0' + aNumber % 10);
+        return 2;
+    }
+    aBuffer[0] = char('0' + aNumber);
+    return 1;
+}
+
+// lit un entier positif, avance le pointeur ; renvoie -1 si pas de chiffre
+static int readNumber(const char*& aText)
+{
+    if (*aText < '0' || *aText > '9')
+        return -1;
+    int number = 0;
+    while (*aText >= '0' && *aText <= '9' && number < 100)
+    {
+        number = number * 10 + (*aText - '0');
+        aText++;
+    }
+    return number;
+}
+
+// type de case imposé par la taille du plateau (forteresses aux coins, château au centre)
+static CellType cellTypeAt(int aRow, int aCol, int aSize)
+{
+    int last = aSize - 1;
+    if ((aRow == 0 || aRow == last) && (aCol == 0 || aCol == last))
+        return FORTRESS;
+    if (aRow == aSize / 2 && aCol == aSize / 2)
+        return CASTLE;
+    return NORMAL;
+}
+
+int formatPosition(const Game& aGame, char* aBuffer, int aBufferSize)
+{
+    // 2 caractères max par case + séparateurs + " a 13" : la taille la plus large tient dans POSITION_STRING_SIZE
+    if (aBufferSize < POSITION_STRING_SIZE)
+        return -1;
+
+    const Board& aBoard = aGame.itsBoard;
+    int length = 0;
+    for (int i = 0; i < aBoard.itsSize; ++i)
+    {
+        if (i > 0)
+            aBuffer[length++] = '/';
+        int empty = 0;
+        for (int j = 0; j < aBoard.itsSize; ++j)
+        {
+            PieceType piece = aBoard.itsCells[i][j].itsPieceType;
+            if (piece == NONE)
+            {
+                empty++;
+                continue;
+            }
+            if (empty > 0)
+            {
+                length += writeNumber(empty, aBuffer + length);
+                empty = 0;
+            }
+            aBuffer[length++] = (piece == SWORD) ? 'X' : (piece == SHIELD) ? 'U' : 'K';
+        }
+        if (empty > 0)
+            length += writeNumber(empty, aBuffer + length);
+    }
+    aBuffer[length++] = ' ';
+    aBuffer[length++] = (aGame.itsCurrentPlayer->itsRole == ATTACK) ? 'a' : 'd';
+    aBuffer[length++] = ' ';
+    length += writeNumber(aBoard.itsSize, aBuffer + length);
+    aBuffer[length] = '\0';
+    return length;
+}
+
+bool parsePosition(const char* aText, Game& aGame, const char** aEnd)
+{
+    // largeur de la première ligne = taille du plateau
+    int size = 0;
+    for (const char* p = aText; *p != '/' && *p != ' ' && *p != '\0';)
+    {
+        int run = readNumber(p);
+        if (run == -1)
+        {
+            size++;
+            p++;
+        }
+        else
+            size += run;
+    }
+    if (size != LITTLE && size != BIG)
+        return false;
+
+    Board& aBoard = aGame.itsBoard;
+    if (aBoard.itsCells == nullptr)
+    {
+        aBoard.itsSize = BoardSize(size);
+        if (!createBoard(aBoard))
+            return false;
+    }
+    else if (aBoard.itsSize != size)
+        return false;
+
+    const char* p = aText;
+    int kings = 0;
+    for (int i = 0; i < size; ++i)
+    {
+        if (i > 0 && *p++ != '/')
+            return false;
+        int j = 0;
+        while (j < size)
+        {
+            int run = readNumber(p);
+            if (run == 0)
+                return false;
+            if (run > 0)
+            {
+                if (j + run > size)
+                    return false;
+                for (int k = 0; k < run; ++k, ++j)
+                    aBoard.itsCells[i][j] = {cellTypeAt(i, j, size), NONE};
+                continue;
+            }
+            PieceType piece;
+            switch (*p) {
+            case 'X':
+                piece = SWORD;
+                break;
+            case 'U':
+                piece = SHIELD;
+                break;
+            case 'K':
+                piece = KING;
+                kings++;
+                break;
+            default:
+                return false;
+            }
+            aBoard.itsCells[i][j] = {cellTypeAt(i, j, size), piece};
+            p++;
+            j++;
+        }
+    }
+    if (kings > 1 || *p++ != ' ')
+        return false;
+
+    // joueur actif
+    PlayerRole role;
+    if (*p == 'a')
+        role = ATTACK;
+    else if (*p == 'd')
+        role = DEFENSE;
+    else
+        return false;
+    p++;
+
+    // taille rappelée en fin de chaîne
+    if (*p++ != ' ' || readNumber(p) != size)
+        return false;
+
+    aGame.itsCurrentPlayer = (aGame.itsPlayer1.itsRole == role) ? &aGame.itsPlayer1 : &aGame.itsPlayer2;
+    if (aEnd != nullptr)
+        *aEnd = p;
+    return true;
+}
+
+int formatMove(const Move& aMove, char* aBuffer, int aBufferSize)
+{
+    if (aBufferSize < MOVE_STRING_SIZE)
+        return -1;
+    int length = 0;
+    aBuffer[length++] = char('a' + aMove.itsStartPosition.itsRow);
+    length += writeNumber(aMove.itsStartPosition.itsCol + 1, aBuffer + length);
+    aBuffer[length++] = '-';
+    aBuffer[length++] = char('a' + aMove.itsEndPosition.itsRow);
+    length += writeNumber(aMove.itsEndPosition.itsCol + 1, aBuffer + length);
+    aBuffer[length] = '\0';
+    return length;
+}
+
+// lit une case "e4" ; la lettre donne la ligne et le nombre la colonne comme dans getPositionFromInput
+static bool readCell(const char*& aText, const Board& aBoard, Position& aPos)
+{
+    char letter = *aText;
+    if (letter >= 'a' && letter <= 'z')
+        aPos.itsRow = letter - 'a';
+    else if (letter >= 'A' && letter <= 'Z')
+        aPos.itsRow = letter - 'A';
+    else
+        return false;
+    aText++;
+    int number = readNumber(aText);
+    if (number < 1)
+        return false;
+    aPos.itsCol = number - 1;
+    return isValidPosition(aPos, aBoard);
+}
+
+bool parseMove(const char* aText, const Board& aBoard, Move& aMove, const char** aEnd)
+{
+    const char* p = aText;
+    Move move;
+    if (!readCell(p, aBoard, move.itsStartPosition) || *p++ != '-' || !readCell(p, aBoard, move.itsEndPosition))
+        return false;
+    aMove = move;
+    if (aEnd != nullptr)
+        *aEnd = p;
+    return true;
+}
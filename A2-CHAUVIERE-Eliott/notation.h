@@ -0,0 +1,93 @@
+/**
+ * @file notation.h
+ *
+ * @brief Compact text notation for positions and moves.
+ *
+ * A position string lists the rows from the top of the board (row 'A') to the bottom,
+ * separated by '/'. Inside a row, 'X' is a sword, 'U' a shield, 'K' the king (the same
+ * letters as `displayBoard`) and a number is a run of empty cells. The rows are followed
+ * by the side to move ('a' for ATTACK, 'd' for DEFENSE) and the board size, for example
+ * the starting 11x11 position:
+ *
+ *     3XXXXX3/5X5/11/X4U4X/X3UUU3X/XX1UUKUU1XX/X3UUU3X/X4U4X/11/5X5/3XXXXX3 a 11
+ *
+ * A move is written as two cells joined by '-', each cell being the row letter followed
+ * by the column number, as typed in `getPositionFromInput` (e.g. "e1-e4").
+ *
+ * None of these functions allocate memory: formatters write into a buffer given by the
+ * caller and parsers read directly from a C string.
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef NOTATION_H
+#define NOTATION_H
+
+#include "typeDef.h"
+
+/**
+ * @brief Size of a buffer large enough for any position string (including the final '\0').
+ */
+const int POSITION_STRING_SIZE = 192;
+
+/**
+ * @brief Size of a buffer large enough for any move string (including the final '\0').
+ */
+const int MOVE_STRING_SIZE = 8;
+
+/**
+ * @brief Writes the position of a game in compact notation.
+ *
+ * The board, the role of `itsCurrentPlayer` and the board size are written into `aBuffer`,
+ * followed by a '\0'.
+ *
+ * @param aGame The game to describe.
+ * @param aBuffer The buffer receiving the text.
+ * @param aBufferSize The size of `aBuffer` in bytes (`POSITION_STRING_SIZE` is always enough).
+ * @return The length of the text written (without the '\0'), or -1 if the buffer is too small.
+ */
+int formatPosition(const Game& aGame, char* aBuffer, int aBufferSize);
+
+/**
+ * @brief Reads a position written in compact notation into a game.
+ *
+ * The cells of `aGame.itsBoard` are overwritten (pieces and cell types) and `itsCurrentPlayer`
+ * is set to the player holding the role to move. If the board has not been created yet,
+ * `createBoard` is called with the size read from the text; otherwise the size must match
+ * the existing board.
+ *
+ * @param aText The text to read.
+ * @param aGame The game receiving the position.
+ * @param aEnd If not null, receives a pointer to the first character after the position.
+ * @return `true` if the text is a valid position, `false` otherwise (the board may then be partially written).
+ *
+ * @note At most one king is accepted; the rows must exactly fill the board.
+ */
+bool parsePosition(const char* aText, Game& aGame, const char** aEnd = nullptr);
+
+/**
+ * @brief Writes a move in compact notation (e.g. "e1-e4").
+ *
+ * @param aMove The move to write.
+ * @param aBuffer The buffer receiving the text.
+ * @param aBufferSize The size of `aBuffer` in bytes (`MOVE_STRING_SIZE` is always enough).
+ * @return The length of the text written (without the '\0'), or -1 if the buffer is too small.
+ */
+int formatMove(const Move& aMove, char* aBuffer, int aBufferSize);
+
+/**
+ * @brief Reads a move written in compact notation.
+ *
+ * Row letters are accepted in upper or lower case. Both cells must be inside `aBoard`;
+ * the legality of the move itself is left to `isValidMovement`.
+ *
+ * @param aText The text to read.
+ * @param aBoard The board the move is played on (only its size is used).
+ * @param aMove Receives the move if the text is valid.
+ * @param aEnd If not null, receives a pointer to the first character after the move.
+ * @return `true` if the text is a valid move, `false` otherwise.
+ */
+bool parseMove(const char* aText, const Board& aBoard, Move& aMove, const char** aEnd = nullptr);
+
+#endif // NOTATION_H
@@ -0,0 +1,133 @@
+#include <new>
+using namespace std;
+#include "pool.h"
+#include "functions.h"
+
+// liste libre du fil appelant, attribuée à tour de rôle au premier appel
+static int getThreadShard()
+{
+    static atomic<int> nextShard{0};
+    thread_local int shard = nextShard++ % POOL_SHARDS;
+    return shard;
+}
+
+static PooledGame* getSlot(GamePool& aPool, uint32_t aSlot)
+{
+    uint32_t slab = aSlot / POOL_SLAB_SLOTS;
+    if (slab >= aPool.itsSlabCount.load(memory_order_acquire))
+        return nullptr;
+    return &aPool.itsSlabs[slab].load(memory_order_acquire)[aSlot % POOL_SLAB_SLOTS];
+}
+
+static bool popSlot(GamePool& aPool, PoolShard& aShard, uint32_t& aSlot)
+{
+    if (aShard.itsFirst == 0)
+        return false;
+    aSlot = aShard.itsFirst - 1;
+    aShard.itsFirst = getSlot(aPool, aSlot)->itsNextFree;
+    aShard.itsCount--;
+    return true;
+}
+
+static void pushSlot(GamePool& aPool, PoolShard& aShard, uint32_t aSlot)
+{
+    getSlot(aPool, aSlot)->itsNextFree = aShard.itsFirst;
+    aShard.itsFirst = aSlot + 1;
+    aShard.itsCount++;
+}
+
+// nouvelle plaque : un emplacement pour l'appelant, les autres dans sa liste
+static bool addSlab(GamePool& aPool, PoolShard& aShard, uint32_t& aSlot)
+{
+    lock_guard<mutex> grow(aPool.itsGrowLock);
+    uint32_t slab = aPool.itsSlabCount.load();
+    if (slab >= POOL_MAX_SLABS)
+        return false;
+    PooledGame* slots = new (nothrow) PooledGame[POOL_SLAB_SLOTS];
+    if (slots == nullptr)
+        return false;
+    for (uint32_t i = 0; i < POOL_SLAB_SLOTS; ++i)
+        for (int row = 0; row < BIG; ++row)
+            slots[i].itsRows[row] = slots[i].itsCells + row * BIG;
+    aPool.itsSlabs[slab].store(slots, memory_order_release);
+    aPool.itsSlabCount.store(slab + 1, memory_order_release);
+
+    aSlot = slab * POOL_SLAB_SLOTS;
+    lock_guard<mutex> lock(aShard.itsLock);
+    for (uint32_t i = POOL_SLAB_SLOTS - 1; i > 0; --i)
+        pushSlot(aPool, aShard, aSlot + i);
+    return true;
+}
+
+bool acquireGame(GamePool& aPool, BoardSize aSize, GameHandle& aHandle)
+{
+    int own = getThreadShard();
+    uint32_t slot;
+    bool found;
+    {
+        lock_guard<mutex> lock(aPool.itsShards[own].itsLock);
+        found = popSlot(aPool, aPool.itsShards[own], slot);
+    }
+    // liste vide : un emplacement pris ailleurs, une plaque de plus en dernier recours
+    for (int i = 1; !found && i < POOL_SHARDS; ++i) {
+        PoolShard& shard = aPool.itsShards[(own + i) % POOL_SHARDS];
+        lock_guard<mutex> lock(shard.itsLock);
+        found = popSlot(aPool, shard, slot);
+    }
+    if (!found && !addSlab(aPool, aPool.itsShards[own], slot))
+        return false;
+
+    PooledGame& pooled = *getSlot(aPool, slot);
+    Game& game = pooled.itsGame;
+    game.itsBoard.itsCells = pooled.itsRows;
+    game.itsBoard.itsSize = aSize;
+    initializeBoard(game.itsBoard);
+    game.itsPlayer1 = Player{"Player 1", ATTACK};
+    game.itsPlayer2 = Player{"Player 2", DEFENSE};
+    game.itsCurrentPlayer = &game.itsPlayer1;
+    game.itsHooks = nullptr;
+    aHandle.itsSlot = slot;
+    aHandle.itsGeneration = pooled.itsGeneration.fetch_add(1) + 1;
+    aPool.itsLiveGames++;
+    return true;
+}
+
+Game* getPooledGame(GamePool& aPool, const GameHandle& aHandle)
+{
+    PooledGame* pooled = getSlot(aPool, aHandle.itsSlot);
+    if (pooled == nullptr || pooled->itsGeneration.load(memory_order_acquire) != aHandle.itsGeneration
+        || (aHandle.itsGeneration & 1) == 0)
+        return nullptr;
+    return &pooled->itsGame;
+}
+
+bool releaseGame(GamePool& aPool, const GameHandle& aHandle)
+{
+    PooledGame* pooled = getSlot(aPool, aHandle.itsSlot);
+    uint32_t generation = aHandle.itsGeneration;
+    // une seule libération réussit, même entre deux fils
+    if (pooled == nullptr || (generation & 1) == 0 || !pooled->itsGeneration.compare_exchange_strong(generation, generation + 1))
+        return false;
+    aPool.itsLiveGames--;
+    PoolShard& shard = aPool.itsShards[getThreadShard()];
+    lock_guard<mutex> lock(shard.itsLock);
+    pushSlot(aPool, shard, aHandle.itsSlot);
+    return true;
+}
+
+uint32_t getPoolCapacity(const GamePool& aPool)
+{
+    return aPool.itsSlabCount.load() * POOL_SLAB_SLOTS;
+}
+
+void destroyGamePool(GamePool& aPool)
+{
+    for (uint32_t slab = 0; slab < aPool.itsSlabCount.load(); ++slab)
+        delete[] aPool.itsSlabs[slab].exchange(nullptr);
+    aPool.itsSlabCount = 0;
+    for (PoolShard& shard : aPool.itsShards) {
+        shard.itsFirst = 0;
+        shard.itsCount = 0;
+    }
+    aPool.itsLiveGames = 0;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file pool.h
+ *
+ * @brief Pool of games with their boards, for hosts starting and ending many games.
+ *
+ * The games live in slabs of `POOL_SLAB_SLOTS` slots allocated once and never freed before
+ * the pool: each slot holds a `Game` and the cells of a 13x13 board, so acquiring a game
+ * allocates nothing (`createBoard` makes one allocation per row). The free slots are kept in
+ * `POOL_SHARDS` lists, each with its own lock; a thread always uses the same list (they are
+ * given in turn to the threads), takes a slot from another list when its own is empty, and
+ * only adds a slab when every list is empty. Under a steady flow of games the pool stops growing.
+ *
+ * A game is reached through a handle holding the slot and its generation: releasing the game
+ * changes the generation, so a handle kept after the release is recognised as stale
+ * (`getPooledGame` returns null) instead of reaching the next game of the slot.
+ *
+ * @note The board of a pooled game belongs to the pool: it must not be given to `deleteBoard`.
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include "typeDef.h"
+
+/**
+ * @brief Slots of a slab.
+ */
+const uint32_t POOL_SLAB_SLOTS = 256;
+
+/**
+ * @brief Most slabs of a pool (so at most 1M games).
+ */
+const uint32_t POOL_MAX_SLABS = 4096;
+
+/**
+ * @brief Free lists of a pool.
+ */
+const int POOL_SHARDS = 16;
+
+/**
+ * @struct GameHandle
+ * @brief Reference to a pooled game.
+ */
+struct GameHandle
+{
+    uint32_t itsSlot = 0;        /**< Slot of the game. */
+    uint32_t itsGeneration = 0;  /**< Generation of the slot when the game was acquired (0 is never valid). */
+};
+
+/**
+ * @struct PooledGame
+ * @brief A slot: a game and the storage of its board.
+ */
+struct PooledGame
+{
+    Game itsGame;                        /**< The game; its board points to `itsRows`. */
+    Cell* itsRows[BIG];                  /**< Rows of the board, inside `itsCells`. */
+    Cell itsCells[BIG * BIG];            /**< Cells of the board. */
+    atomic<uint32_t> itsGeneration{0};   /**< Odd while the game is in use, even while the slot is free. */
+    uint32_t itsNextFree = 0;            /**< Next slot of the free list. */
+};
+
+/**
+ * @struct PoolShard
+ * @brief A free list (alone on its cache line).
+ */
+struct alignas(64) PoolShard
+{
+    mutex itsLock;              /**< Protects the list. */
+    uint32_t itsFirst = 0;      /**< First free slot plus one (0 if the list is empty). */
+    uint32_t itsCount = 0;      /**< Free slots in the list. */
+};
+
+/**
+ * @struct GamePool
+ * @brief A pool of games.
+ */
+struct GamePool
+{
+    atomic<PooledGame*> itsSlabs[POOL_MAX_SLABS] = {};  /**< The slabs allocated. */
+    atomic<uint32_t> itsSlabCount{0};                   /**< Number of slabs. */
+    mutex itsGrowLock;                                  /**< Taken to add a slab. */
+    PoolShard itsShards[POOL_SHARDS];                   /**< The free lists. */
+    atomic<uint32_t> itsLiveGames{0};                   /**< Games in use. */
+};
+
+/**
+ * @brief Takes a game from a pool, on the starting position of a board.
+ *
+ * The players get their default names and roles, player 1 to move, and no hooks.
+ *
+ * @param aPool The pool.
+ * @param aSize The board size.
+ * @param aHandle Receives the handle of the game.
+ * @return `false` if the pool is full or out of memory.
+ */
+bool acquireGame(GamePool& aPool, BoardSize aSize, GameHandle& aHandle);
+
+/**
+ * @brief Reaches a pooled game.
+ *
+ * @param aPool The pool.
+ * @param aHandle The handle.
+ * @return The game, or `nullptr` if the handle is stale (game released) or invalid.
+ */
+Game* getPooledGame(GamePool& aPool, const GameHandle& aHandle);
+
+/**
+ * @brief Gives a game back to its pool.
+ *
+ * @param aPool The pool.
+ * @param aHandle The handle of the game.
+ * @return `false` if the handle is stale (the game was already released).
+ */
+bool releaseGame(GamePool& aPool, const GameHandle& aHandle);
+
+/**
+ * @brief Counts the slots allocated by a pool.
+ *
+ * @param aPool The pool.
+ * @return Games in use plus free slots.
+ */
+uint32_t getPoolCapacity(const GamePool& aPool);
+
+/**
+ * @brief Frees the slabs of a pool (every handle becomes invalid).
+ *
+ * @param aPool The pool; no thread may use it any more.
+ */
+void destroyGamePool(GamePool& aPool);
+
+#endif // POOL_H
@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <queue>
+#include <vector>
+using namespace std;
+#include "posindex.h"
+#include "functions.h"
+#include "hash.h"
+#include "record.h"
+
+// ordre de l'index : hash, puis numéro de partie, puis coup
+static bool entryLess(const IndexEntry& a, const IndexEntry& b)
+{
+    if (a.itsHash != b.itsHash)
+        return a.itsHash < b.itsHash;
+    if (a.itsGame != b.itsGame)
+        return a.itsGame < b.itsGame;
+    return a.itsPly < b.itsPly;
+}
+
+// trie un lot d'entrées et l'écrit dans un fichier temporaire
+static bool writeRun(vector<IndexEntry>& aRun, const string& aPath)
+{
+    sort(aRun.begin(), aRun.end(), entryLess);
+    ofstream out(aPath, ios::binary | ios::trunc);
+    out.write(reinterpret_cast<const char*>(aRun.data()), streamsize(aRun.size() * sizeof(IndexEntry)));
+    aRun.clear();
+    return bool(out);
+}
+
+/**
+ * Lecture séquentielle d'un fichier temporaire pendant la fusion.
+ */
+struct RunReader
+{
+    ifstream itsStream;
+    char itsBuffer[1 << 16];
+    IndexEntry itsEntry;
+};
+
+static bool nextEntry(RunReader& aRun)
+{
+    return bool(aRun.itsStream.read(reinterpret_cast<char*>(&aRun.itsEntry), sizeof(IndexEntry)));
+}
+
+// fusion des fichiers temporaires triés dans le fichier d'index, en supprimant les doublons (même position, même partie)
+static bool mergeRuns(const vector<string>& aRuns, const string& aIndexPath)
+{
+    vector<RunReader> runs(aRuns.size());
+    auto greater = [&runs](int a, int b) { return entryLess(runs[b].itsEntry, runs[a].itsEntry); };
+    priority_queue<int, vector<int>, decltype(greater)> heap(greater);
+    for (size_t i = 0; i < aRuns.size(); ++i) {
+        runs[i].itsStream.rdbuf()->pubsetbuf(runs[i].itsBuffer, sizeof(runs[i].itsBuffer));
+        runs[i].itsStream.open(aRuns[i], ios::binary);
+        if (nextEntry(runs[i]))
+            heap.push(int(i));
+    }
+
+    ofstream out(aIndexPath, ios::binary | ios::trunc);
+    char buffer[1 << 16];
+    out.rdbuf()->pubsetbuf(buffer, sizeof(buffer));
+    uint64_t header[2] = {POSITION_INDEX_MAGIC, 0};
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    IndexEntry last = {0, 0, 0, 0, 0};
+    while (!heap.empty()) {
+        int i = heap.top();
+        heap.pop();
+        const IndexEntry& entry = runs[i].itsEntry;
+        if (header[1] == 0 || entry.itsHash != last.itsHash || entry.itsGame != last.itsGame) {
+            out.write(reinterpret_cast<const char*>(&entry), sizeof(IndexEntry));
+            last = entry;
+            header[1]++;
+        }
+        if (nextEntry(runs[i]))
+            heap.push(i);
+    }
+
+    // nombre d'entrées réellement écrites
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    return bool(out);
+}
+
+bool buildPositionIndex(const string& aArchivePath, const string& aIndexPath, size_t aRunEntries)
+{
+    RecordReader reader;
+    if (!openRecordReader(reader, aArchivePath))
+        return false;
+
+    vector<IndexEntry> run;
+    vector<IndexEntry> positions; // positions de la partie en cours, en attendant son résultat
+    vector<string> runPaths;
+    Game game;
+    bool valid = true;
+    uint32_t gameNumber = 0;
+
+    while (valid && reader.itsStream.peek() != EOF) {
+        gameNumber++;
+        if (!readRecordHeader(reader, game)) {
+            valid = false;
+            break;
+        }
+        positions.clear();
+        positions.push_back({hashPosition(game), gameNumber, 0, 0, 0});
+        Move move;
+        RecordStatus status;
+        while ((status = replayRecordMove(reader, game, move)) == RECORD_MOVE)
+            positions.push_back({hashPosition(game), gameNumber, uint16_t(positions.size()), 0, 0});
+        if (status == RECORD_ERROR) {
+            valid = false;
+            break;
+        }
+
+        for (IndexEntry& entry : positions) {
+            entry.itsResult = uint8_t(reader.itsResult);
+            run.push_back(entry);
+            if (run.size() >= aRunEntries) {
+                runPaths.push_back(aIndexPath + ".run" + to_string(runPaths.size()));
+                valid = valid && writeRun(run, runPaths.back());
+            }
+        }
+    }
+    closeRecordReader(reader);
+    deleteBoard(game.itsBoard);
+
+    if (valid && (!run.empty() || runPaths.empty())) {
+        runPaths.push_back(aIndexPath + ".run" + to_string(runPaths.size()));
+        valid = writeRun(run, runPaths.back());
+    }
+    if (valid)
+        valid = mergeRuns(runPaths, aIndexPath);
+    for (const string& path : runPaths)
+        remove(path.c_str());
+    return valid;
+}
+
+bool openPositionIndex(PositionIndex& aIndex, const string& aPath)
+{
+    if (!openMappedFile(aIndex.itsFile, aPath))
+        return false;
+    const uint64_t* header = reinterpret_cast<const uint64_t*>(aIndex.itsFile.itsData);
+    if (aIndex.itsFile.itsSize < 2 * sizeof(uint64_t) || header[0] != POSITION_INDEX_MAGIC
+        || aIndex.itsFile.itsSize != 2 * sizeof(uint64_t) + header[1] * sizeof(IndexEntry)) {
+        closeMappedFile(aIndex.itsFile);
+        return false;
+    }
+    aIndex.itsEntries = reinterpret_cast<const IndexEntry*>(header + 2);
+    aIndex.itsCount = header[1];
+    return true;
+}
+
+void closePositionIndex(PositionIndex& aIndex)
+{
+    closeMappedFile(aIndex.itsFile);
+    aIndex.itsEntries = nullptr;
+    aIndex.itsCount = 0;
+}
+
+uint64_t findPosition(const PositionIndex& aIndex, uint64_t aHash, const IndexEntry*& aFirst)
+{
+    const IndexEntry* entries = aIndex.itsEntries;
+    uint64_t low = 0;               // toutes les entrées avant low ont un hash < aHash
+    uint64_t high = aIndex.itsCount; // toutes les entrées à partir de high ont un hash >= aHash
+
+    // recherche par interpolation tant que l'intervalle est grand
+    for (int step = 0; step < 8 && high - low > 32; ++step) {
+        uint64_t lowHash = entries[low].itsHash;
+        uint64_t highHash = entries[high - 1].itsHash;
+        if (aHash <= lowHash) {
+            high = low;
+            break;
+        }
+        if (aHash > highHash) {
+            low = high;
+            break;
+        }
+        long double ratio = (long double)(aHash - lowHash) / (long double)(highHash - lowHash);
+        uint64_t guess = low + uint64_t(ratio * (high - 1 - low));
+        if (entries[guess].itsHash < aHash)
+            low = guess + 1;
+        else
+            high = guess;
+    }
+
+    // fin par dichotomie
+    const IndexEntry* first = lower_bound(entries + low, entries + high, aHash,
+                                          [](const IndexEntry& entry, uint64_t hash) { return entry.itsHash < hash; });
+    const IndexEntry* last = first;
+    while (last != entries + aIndex.itsCount && last->itsHash == aHash)
+        last++;
+    aFirst = first;
+    return uint64_t(last - first);
+}
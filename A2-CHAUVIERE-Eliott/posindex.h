@@ -0,0 +1,99 @@
+/**
+ * @file posindex.h
+ *
+ * @brief Index of the positions reached in a game record archive.
+ *
+ * The indexer replays every game of an archive and writes one entry per (position, game),
+ * sorted by position hash (`hashPosition`). The index file is made of a 16-byte header
+ * (`POSITION_INDEX_MAGIC` and the number of entries) followed by the `IndexEntry` table,
+ * in the byte order of the machine. Queries map the file in memory and search the table
+ * in place, so the index never has to fit in RAM, neither when it is built (sorted runs
+ * merged from temporary files) nor when it is read.
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef POSINDEX_H
+#define POSINDEX_H
+
+#include <cstdint>
+#include "typeDef.h"
+#include "mappedfile.h"
+
+/**
+ * @brief First 8 bytes of an index file.
+ */
+const uint64_t POSITION_INDEX_MAGIC = 0x3158444954414648ULL; // "HFATIDX1"
+
+/**
+ * @brief Number of entries sorted in memory before being written to a temporary run (256 MB).
+ */
+const size_t POSITION_INDEX_RUN = size_t(1) << 24;
+
+/**
+ * @struct IndexEntry
+ * @brief One game reaching one position.
+ */
+struct IndexEntry
+{
+    uint64_t itsHash;   /**< Hash of the position. */
+    uint32_t itsGame;   /**< Number of the game in the archive (from 1). */
+    uint16_t itsPly;    /**< First ply after which the game reached the position (0 for the start). */
+    uint8_t itsResult;  /**< Result of the game (a `RecordResult`). */
+    uint8_t itsUnused;  /**< Padding, always 0. */
+};
+
+/**
+ * @struct PositionIndex
+ * @brief An index file mapped in memory.
+ */
+struct PositionIndex
+{
+    MappedFile itsFile;                     /**< The mapped file. */
+    const IndexEntry* itsEntries = nullptr; /**< The sorted table. */
+    uint64_t itsCount = 0;                  /**< Number of entries of the table. */
+};
+
+/**
+ * @brief Builds the position index of a record archive.
+ *
+ * Entries are sorted by (hash, game); a game reaching the same position twice is only listed once,
+ * with its first ply. Temporary runs are written next to the index and removed at the end.
+ *
+ * @param aArchivePath The record archive to index.
+ * @param aIndexPath The index file to write.
+ * @param aRunEntries Number of entries sorted in memory at once.
+ * @return `true` if the index was written, `false` if a file could not be opened or the archive is corrupted.
+ */
+bool buildPositionIndex(const string& aArchivePath, const string& aIndexPath, size_t aRunEntries = POSITION_INDEX_RUN);
+
+/**
+ * @brief Maps an index file in memory.
+ *
+ * @param aIndex The index to open.
+ * @param aPath The path of the index file.
+ * @return `true` if the file is a valid index, `false` otherwise.
+ */
+bool openPositionIndex(PositionIndex& aIndex, const string& aPath);
+
+/**
+ * @brief Unmaps an index file.
+ *
+ * @param aIndex The index to close.
+ */
+void closePositionIndex(PositionIndex& aIndex);
+
+/**
+ * @brief Finds the games that reached a position.
+ *
+ * The table is searched by interpolation (hashes are uniformly spread), ending with a binary search.
+ *
+ * @param aIndex The open index.
+ * @param aHash The hash of the position (`hashPosition`).
+ * @param aFirst Receives a pointer to the first entry of the position, sorted by game number.
+ * @return The number of games that reached the position (0 if none).
+ */
+uint64_t findPosition(const PositionIndex& aIndex, uint64_t aHash, const IndexEntry*& aFirst);
+
+#endif // POSINDEX_H
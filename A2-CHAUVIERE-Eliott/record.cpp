@@ -0,0 +1,185 @@
+#include "record.h"
+#include "functions.h"
+#include "movegen.h"
+
+// écrit un nom précédé de sa longueur (255 caractères au plus)
+static void writeName(ofstream& aStream, const string& aName)
+{
+    size_t length = aName.size() < 255 ? aName.size() : 255;
+    aStream.put(char(length));
+    aStream.write(aName.data(), length);
+}
+
+// lit un nom précédé de sa longueur
+static bool readName(ifstream& aStream, string& aName)
+{
+    int length = aStream.get();
+    if (length == EOF)
+        return false;
+    aName.resize(length);
+    aStream.read(&aName[0], length);
+    return bool(aStream);
+}
+
+RecordResult getRecordResult(const Game& aGame)
+{
+    Player* winner = whoWon(aGame);
+    if (winner == &aGame.itsPlayer1)
+        return RECORD_PLAYER1;
+    if (winner == &aGame.itsPlayer2)
+        return RECORD_PLAYER2;
+    return RECORD_UNFINISHED;
+}
+
+bool openRecordWriter(RecordWriter& aWriter, const string& aPath)
+{
+    aWriter.itsStream.rdbuf()->pubsetbuf(aWriter.itsBuffer, RECORD_BUFFER_SIZE);
+    aWriter.itsStream.open(aPath, ios::binary | ios::app);
+    return aWriter.itsStream.is_open();
+}
+
+bool beginRecord(RecordWriter& aWriter, const Game& aGame)
+{
+    aWriter.itsStream.put(char(RECORD_MARKER));
+    aWriter.itsStream.put(char(aGame.itsBoard.itsSize));
+    writeName(aWriter.itsStream, aGame.itsPlayer1.itsName);
+    writeName(aWriter.itsStream, aGame.itsPlayer2.itsName);
+    return bool(aWriter.itsStream);
+}
+
+bool writeRecordMove(RecordWriter& aWriter, const Game& aGame, const Move& aMove)
+{
+    int index = getMoveIndex(aGame, aMove);
+    if (index == -1)
+        return false;
+
+    // varint de (index + 1) : 7 bits par octet, le bit de poids fort indique la suite
+    unsigned value = unsigned(index) + 1;
+    while (value >= 0x80)
+    {
+        aWriter.itsStream.put(char((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    aWriter.itsStream.put(char(value));
+    return bool(aWriter.itsStream);
+}
+
+bool endRecord(RecordWriter& aWriter, const Game& aGame)
+{
+    aWriter.itsStream.put(0);
+    aWriter.itsStream.put(char(getRecordResult(aGame)));
+    return bool(aWriter.itsStream);
+}
+
+void closeRecordWriter(RecordWriter& aWriter)
+{
+    aWriter.itsStream.close();
+}
+
+bool openRecordReader(RecordReader& aReader, const string& aPath)
+{
+    aReader.itsStream.rdbuf()->pubsetbuf(aReader.itsBuffer, RECORD_BUFFER_SIZE);
+    aReader.itsStream.open(aPath, ios::binary);
+    return aReader.itsStream.is_open();
+}
+
+bool readRecordHeader(RecordReader& aReader, Game& aGame)
+{
+    if (aReader.itsStream.get() != RECORD_MARKER)
+        return false;
+    int size = aReader.itsStream.get();
+    if (size != LITTLE && size != BIG)
+        return false;
+    if (!readName(aReader.itsStream, aGame.itsPlayer1.itsName) || !readName(aReader.itsStream, aGame.itsPlayer2.itsName))
+        return false;
+
+    if (aGame.itsBoard.itsCells != nullptr && aGame.itsBoard.itsSize != size)
+        deleteBoard(aGame.itsBoard);
+    if (aGame.itsBoard.itsCells == nullptr)
+    {
+        aGame.itsBoard.itsSize = BoardSize(size);
+        if (!createBoard(aGame.itsBoard))
+            return false;
+    }
+    initializeBoard(aGame.itsBoard);
+    aGame.itsPlayer1.itsRole = ATTACK;
+    aGame.itsPlayer2.itsRole = DEFENSE;
+    aGame.itsCurrentPlayer = &aGame.itsPlayer1;
+    aReader.itsResult = RECORD_UNFINISHED;
+    return true;
+}
+
+bool skipRecordHeader(RecordReader& aReader)
+{
+    if (aReader.itsStream.get() != RECORD_MARKER)
+        return false;
+    int size = aReader.itsStream.get();
+    if (size != LITTLE && size != BIG)
+        return false;
+    for (int i = 0; i < 2; ++i) // noms des deux joueurs
+    {
+        int length = aReader.itsStream.get();
+        if (length == EOF)
+            return false;
+        aReader.itsStream.ignore(length);
+    }
+    return bool(aReader.itsStream);
+}
+
+RecordStatus readRecordIndex(RecordReader& aReader, int& aIndex)
+{
+    unsigned value = 0;
+    int shift = 0;
+    int byte;
+    do
+    {
+        byte = aReader.itsStream.get();
+        if (byte == EOF || shift > 14)
+            return RECORD_ERROR;
+        value |= unsigned(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+
+    if (value == 0) // fin de la partie : lecture du résultat
+    {
+        int result = aReader.itsStream.get();
+        if (result != RECORD_UNFINISHED && result != RECORD_PLAYER1 && result != RECORD_PLAYER2)
+            return RECORD_ERROR;
+        aReader.itsResult = RecordResult(result);
+        return RECORD_END;
+    }
+    aIndex = int(value) - 1;
+    return RECORD_MOVE;
+}
+
+RecordStatus replayRecordMove(RecordReader& aReader, Game& aGame, Move& aMove)
+{
+    int index;
+    RecordStatus status = readRecordIndex(aReader, index);
+    if (status != RECORD_MOVE)
+        return status;
+
+    Move moves[MAX_MOVES];
+    if (index >= generateMoves(aGame, moves))
+        return RECORD_ERROR;
+    aMove = moves[index];
+    movePiece(aGame, aMove);
+    capturePieces(aGame, aMove);
+    switchCurrentPlayer(aGame);
+    return RECORD_MOVE;
+}
+
+bool skipRecord(RecordReader& aReader)
+{
+    int index;
+    RecordStatus status;
+    do
+        status = readRecordIndex(aReader, index);
+    while (status == RECORD_MOVE);
+    return status == RECORD_END;
+}
+
+void closeRecordReader(RecordReader& aReader)
+{
+    aReader.itsStream.close();
+}
@@ -0,0 +1,208 @@
+/**
+ * @file record.h
+ *
+ * @brief Binary game records: an append-only file of played games.
+ *
+ * A record file is a plain concatenation of games, so finished games can be appended to it
+ * at any time. Each game is stored as:
+ * - the marker byte `RECORD_MARKER`,
+ * - the board size (one byte, 11 or 13),
+ * - the names of player 1 and player 2 (one length byte followed by the characters),
+ * - the moves, each one written as a varint (7 bits per byte, low bits first) holding
+ *   its index in the list of `generateMoves` plus one, which takes one byte for most plies,
+ * - a 0 byte closing the moves,
+ * - the result: `RECORD_UNFINISHED`, `RECORD_PLAYER1` or `RECORD_PLAYER2` (from `whoWon`).
+ *
+ * Every game starts from `initializeBoard` with player 1 (the attacker) to move.
+ * The result comes after the moves so that a game can be written while it is being played,
+ * without keeping it in memory nor rewriting the file.
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef RECORD_H
+#define RECORD_H
+
+#include <fstream>
+#include "typeDef.h"
+
+/**
+ * @brief First byte of every game of a record file (also gives the format version).
+ */
+const unsigned char RECORD_MARKER = 0xF1;
+
+/**
+ * @brief Record file where `itsGame` appends the games played.
+ */
+const string RECORD_FILE = "parties.hrec";
+
+/**
+ * @brief Size of the stream buffers used by the writer and the reader.
+ */
+const int RECORD_BUFFER_SIZE = 1 << 16;
+
+/**
+ * @enum RecordResult
+ * @brief Result stored at the end of a game.
+ */
+enum RecordResult
+{
+    RECORD_UNFINISHED = 0, /**< The game was stopped before its end. */
+    RECORD_PLAYER1 = 1,    /**< `whoWon` returned player 1. */
+    RECORD_PLAYER2 = 2     /**< `whoWon` returned player 2. */
+};
+
+/**
+ * @enum RecordStatus
+ * @brief What was found while reading the moves of a game.
+ */
+enum RecordStatus
+{
+    RECORD_MOVE,  /**< A move was read. */
+    RECORD_END,   /**< The end of the game was reached and its result read. */
+    RECORD_ERROR  /**< The file is truncated, corrupted or holds an illegal move. */
+};
+
+/**
+ * @struct RecordWriter
+ * @brief Output stream of a record file, opened in append mode.
+ */
+struct RecordWriter
+{
+    ofstream itsStream;                   /**< The record file. */
+    char itsBuffer[RECORD_BUFFER_SIZE];   /**< Buffer of the stream. */
+};
+
+/**
+ * @struct RecordReader
+ * @brief Input stream of a record file, with the state of the game being read.
+ */
+struct RecordReader
+{
+    ifstream itsStream;                   /**< The record file. */
+    char itsBuffer[RECORD_BUFFER_SIZE];   /**< Buffer of the stream. */
+    RecordResult itsResult = RECORD_UNFINISHED; /**< Result of the last game whose end was read. */
+};
+
+/**
+ * @brief Opens a record file for appending games (the file is created if needed).
+ *
+ * @param aWriter The writer to open.
+ * @param aPath The path of the record file.
+ * @return `true` if the file is open, `false` otherwise.
+ */
+bool openRecordWriter(RecordWriter& aWriter, const string& aPath);
+
+/**
+ * @brief Starts a new game: writes the marker, the board size and the player names.
+ *
+ * @param aWriter The open writer.
+ * @param aGame The game, still in its initial position.
+ * @return `true` if the stream is still good.
+ */
+bool beginRecord(RecordWriter& aWriter, const Game& aGame);
+
+/**
+ * @brief Writes one move of the current game.
+ *
+ * Must be called before the move is played, because the move is stored as its index
+ * among the legal moves of the position.
+ *
+ * @param aWriter The open writer.
+ * @param aGame The game before the move.
+ * @param aMove The move about to be played.
+ * @return `true` if the move was written, `false` if it is not legal or the stream failed.
+ */
+bool writeRecordMove(RecordWriter& aWriter, const Game& aGame, const Move& aMove);
+
+/**
+ * @brief Ends the current game: writes the 0 byte and the result given by `whoWon`.
+ *
+ * @param aWriter The open writer.
+ * @param aGame The game in its final position.
+ * @return `true` if the stream is still good.
+ */
+bool endRecord(RecordWriter& aWriter, const Game& aGame);
+
+/**
+ * @brief Flushes and closes a record file.
+ *
+ * @param aWriter The writer to close.
+ */
+void closeRecordWriter(RecordWriter& aWriter);
+
+/**
+ * @brief Opens a record file for reading.
+ *
+ * @param aReader The reader to open.
+ * @param aPath The path of the record file.
+ * @return `true` if the file is open, `false` otherwise.
+ */
+bool openRecordReader(RecordReader& aReader, const string& aPath);
+
+/**
+ * @brief Reads the header of the next game and sets up the game to replay it.
+ *
+ * The board is created if needed (or recreated if its size differs), initialized with
+ * `initializeBoard`, the player names are set and player 1 is the current player.
+ *
+ * @param aReader The open reader.
+ * @param aGame The game receiving the initial position.
+ * @return `true` if a header was read, `false` at the end of the file or on a corrupted header.
+ */
+bool readRecordHeader(RecordReader& aReader, Game& aGame);
+
+/**
+ * @brief Skips the header of the next game without touching any board.
+ *
+ * @param aReader The open reader.
+ * @return `true` if a header was skipped, `false` at the end of the file or on a corrupted header.
+ */
+bool skipRecordHeader(RecordReader& aReader);
+
+/**
+ * @brief Reads the next raw entry of the current game.
+ *
+ * @param aReader The open reader.
+ * @param aIndex Receives the index of the move in the `generateMoves` list (for `RECORD_MOVE`).
+ * @return `RECORD_MOVE`, `RECORD_END` (the result is then in `itsResult`) or `RECORD_ERROR`.
+ */
+RecordStatus readRecordIndex(RecordReader& aReader, int& aIndex);
+
+/**
+ * @brief Reads the next move of the current game and plays it.
+ *
+ * The move is played with `movePiece` and `capturePieces`, then `switchCurrentPlayer` is called.
+ *
+ * @param aReader The open reader.
+ * @param aGame The game being replayed.
+ * @param aMove Receives the move that was played.
+ * @return `RECORD_MOVE`, `RECORD_END` (the result is then in `itsResult`) or `RECORD_ERROR`.
+ */
+RecordStatus replayRecordMove(RecordReader& aReader, Game& aGame, Move& aMove);
+
+/**
+ * @brief Skips the rest of the current game, up to the next header.
+ *
+ * @param aReader The open reader.
+ * @return `true` if the end of the game was found, `false` on a truncated file.
+ */
+bool skipRecord(RecordReader& aReader);
+
+/**
+ * @brief Closes a record file.
+ *
+ * @param aReader The reader to close.
+ */
+void closeRecordReader(RecordReader& aReader);
+
+/**
+ * @brief Converts the result of `whoWon` into a record result.
+ *
+ * @param aGame The game.
+ * @return `RECORD_PLAYER1`, `RECORD_PLAYER2` or `RECORD_UNFINISHED`.
+ */
+RecordResult getRecordResult(const Game& aGame);
+
+#endif // RECORD_H
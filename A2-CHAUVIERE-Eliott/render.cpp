@@ -0,0 +1,171 @@
+#include <cstdio>
+using namespace std;
+#include "render.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// premières lignes et colonnes (à partir de 1) des cases dans une image ancrée
+static const int FIRST_ROW_LINE = 4;
+static const int FIRST_CELL_COLUMN = 7;
+
+// couleurs de la console Windows (bleu = 1, vert = 2, rouge = 4) vers les couleurs ANSI (rouge = 1, vert = 2, bleu = 4)
+static const int WIN_TO_ANSI[8] = {0, 4, 2, 6, 1, 5, 3, 7};
+
+static const char RESET[] = "\x1b[0m";
+
+void enableAnsiOutput()
+{
+#ifdef _WIN32
+    static bool enabled = false;
+    if (enabled)
+        return;
+    enabled = true;
+    HANDLE output = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode;
+    if (GetConsoleMode(output, &mode))
+        SetConsoleMode(output, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+#endif
+}
+
+string getAnsiColor(int aText, int aBackground)
+{
+    if (aText == 0 && aBackground == 0)
+        return RESET;
+    aText &= 15;
+    aBackground &= 15;
+    int text = (aText < 8 ? 30 : 90) + WIN_TO_ANSI[aText & 7];
+    int background = (aBackground < 8 ? 40 : 100) + WIN_TO_ANSI[aBackground & 7];
+    return "\x1b[" + to_string(text) + ";" + to_string(background) + "m";
+}
+
+// caractère d'une case et sa couleur ANSI (nullptr : couleur du terminal)
+static char getGlyph(const Cell& aCell, const char*& aColor)
+{
+    aColor = nullptr;
+    switch (aCell.itsPieceType) {
+    case SHIELD:
+        aColor = "\x1b[94m";
+        return 'U';
+    case SWORD:
+        aColor = "\x1b[91m";
+        return 'X';
+    case KING:
+        aColor = "\x1b[31m";
+        return 'K';
+    default:
+        break;
+    }
+    switch (aCell.itsCellType) {
+    case FORTRESS:
+        aColor = "\x1b[90m";
+        return '#';
+    case CASTLE:
+        aColor = "\x1b[37m";
+        return '^';
+    default:
+        return ' ';
+    }
+}
+
+static void appendGlyph(string& aFrame, const Cell& aCell, char& aShown)
+{
+    const char* color;
+    aShown = getGlyph(aCell, color);
+    if (color != nullptr) {
+        aFrame += color;
+        aFrame += aShown;
+        aFrame += RESET;
+    }
+    else
+        aFrame += aShown;
+}
+
+static void appendBorder(string& aFrame, int aSize)
+{
+    aFrame += "\n    +";
+    for (int j = 0; j < aSize; ++j)
+        aFrame += "---+";
+}
+
+static void appendCursor(string& aFrame, int aLine, int aColumn)
+{
+    char text[24];
+    snprintf(text, sizeof(text), "\x1b[%d;%dH", aLine, aColumn);
+    aFrame += text;
+}
+
+void composeFrame(BoardRenderer& aRenderer, const Board& aBoard, bool aAnchored)
+{
+    string& frame = aRenderer.itsFrame;
+    if (frame.capacity() < size_t(RENDER_BUFFER_SIZE))
+        frame.reserve(RENDER_BUFFER_SIZE);
+    frame.clear();
+    if (aAnchored)
+        frame += "\x1b[H\x1b[2J"; // curseur en haut, écran effacé
+
+    frame += "\n    ";
+    for (int j = 1; j <= aBoard.itsSize; ++j) { // première ligne avec nombres
+        frame += (j < 10) ? "  " : " ";
+        frame += to_string(j);
+        frame += ' ';
+    }
+    frame += ' ';
+
+    for (int i = 0; i < aBoard.itsSize; ++i) {
+        appendBorder(frame, aBoard.itsSize);
+        frame += "\n  ";
+        frame += char('A' + i);
+        frame += ' ';
+        for (int j = 0; j < aBoard.itsSize; ++j) {
+            frame += "| ";
+            appendGlyph(frame, aBoard.itsCells[i][j], aRenderer.itsShown[i][j]);
+            frame += ' ';
+        }
+        frame += '|';
+    }
+    appendBorder(frame, aBoard.itsSize);
+    frame += '\n';
+
+    // une image non ancrée ne peut pas servir de base aux différences
+    aRenderer.itsSize = aAnchored ? aBoard.itsSize : 0;
+}
+
+int composeChanges(BoardRenderer& aRenderer, const Board& aBoard)
+{
+    string& frame = aRenderer.itsFrame;
+    frame.clear();
+    if (aRenderer.itsSize == 0 || aRenderer.itsSize != aBoard.itsSize)
+        return -1;
+
+    int changes = 0;
+    for (int i = 0; i < aBoard.itsSize; ++i) {
+        for (int j = 0; j < aBoard.itsSize; ++j) {
+            const char* color;
+            if (getGlyph(aBoard.itsCells[i][j], color) == aRenderer.itsShown[i][j])
+                continue;
+            appendCursor(frame, FIRST_ROW_LINE + 2 * i, FIRST_CELL_COLUMN + 4 * j);
+            appendGlyph(frame, aBoard.itsCells[i][j], aRenderer.itsShown[i][j]);
+            changes++;
+        }
+    }
+    // sous le plateau, le texte écrit depuis la dernière image est effacé
+    appendCursor(frame, FIRST_ROW_LINE + 2 * aBoard.itsSize, 1);
+    frame += "\x1b[J";
+    return changes;
+}
+
+void flushFrame(const BoardRenderer& aRenderer)
+{
+    enableAnsiOutput();
+    fwrite(aRenderer.itsFrame.data(), 1, aRenderer.itsFrame.size(), stdout);
+    fflush(stdout);
+}
+
+void drawBoard(BoardRenderer& aRenderer, const Board& aBoard)
+{
+    if (composeChanges(aRenderer, aBoard) < 0)
+        composeFrame(aRenderer, aBoard, true);
+    flushFrame(aRenderer);
+}
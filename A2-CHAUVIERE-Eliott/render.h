@@ -0,0 +1,89 @@
+/**
+ * @file render.h
+ *
+ * @brief Drawing of the board on a terminal with ANSI escape sequences.
+ *
+ * A frame is composed into the buffer of a `BoardRenderer`, reserved once, and written with a
+ * single call (`flushFrame`), instead of one output per character and per colour change.
+ *
+ * A frame drawn at the top of the screen (anchored) lets the next frames repaint only the
+ * cells whose content changed, usually the start and end cells of the last move and the
+ * captured pieces; the text written below the board since the last frame is cleared.
+ *
+ * On Windows the console is switched to ANSI mode (virtual terminal processing) on first use.
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "typeDef.h"
+
+/**
+ * @brief Bytes reserved for the frame buffer (a full 13x13 frame takes about 3 KB).
+ */
+const int RENDER_BUFFER_SIZE = 8192;
+
+/**
+ * @struct BoardRenderer
+ * @brief Frame buffer of a terminal and the cells it last showed.
+ */
+struct BoardRenderer
+{
+    string itsFrame;              /**< The frame being composed. */
+    char itsShown[13][13] = {};   /**< Character shown in each cell by the last anchored frame. */
+    int itsSize = 0;              /**< Board size of the last anchored frame (0 if none). */
+};
+
+/**
+ * @brief Switches the terminal to ANSI mode if needed (only does something on Windows, once).
+ */
+void enableAnsiOutput();
+
+/**
+ * @brief Returns the ANSI sequence of a console colour.
+ *
+ * @param aText The text colour (0 to 15, see `color`).
+ * @param aBackground The background colour (0 to 15).
+ * @return The escape sequence; black on black gives the reset sequence (terminal colours).
+ */
+string getAnsiColor(int aText, int aBackground);
+
+/**
+ * @brief Composes a whole frame of the board.
+ *
+ * @param aRenderer The renderer.
+ * @param aBoard The board.
+ * @param aAnchored `true` to clear the screen and draw at its top, so that the next frames can be diffs;
+ *                  `false` to draw at the cursor, like `displayBoard`.
+ */
+void composeFrame(BoardRenderer& aRenderer, const Board& aBoard, bool aAnchored);
+
+/**
+ * @brief Composes a frame repainting only the cells changed since the last anchored frame.
+ *
+ * @param aRenderer The renderer.
+ * @param aBoard The board.
+ * @return The number of cells repainted, or -1 if there is no anchored frame of this board size
+ *         (the frame is then left empty).
+ */
+int composeChanges(BoardRenderer& aRenderer, const Board& aBoard);
+
+/**
+ * @brief Writes the composed frame to the standard output in one write.
+ *
+ * @param aRenderer The renderer.
+ */
+void flushFrame(const BoardRenderer& aRenderer);
+
+/**
+ * @brief Redraws the board at the top of the screen: only the changed cells when possible, the whole frame otherwise.
+ *
+ * @param aRenderer The renderer.
+ * @param aBoard The board.
+ */
+void drawBoard(BoardRenderer& aRenderer, const Board& aBoard);
+
+#endif // RENDER_H
@@ -0,0 +1,643 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <sstream>
+using namespace std;
+#include "search.h"
+#include "clock.h"
+#include "evaluation.h"
+#include "functions.h"
+#include "hash.h"
+#include "movegen.h"
+#include "notation.h"
+#include "stats.h"
+#include "symmetry.h"
+
+static const int SEARCH_INFINITY = SEARCH_WIN + 1;
+static const int QUIESCENCE_DEPTH = 4;
+static const int CELLS = 13 * 13;
+
+enum Bound : uint8_t
+{
+    BOUND_NONE,
+    BOUND_UPPER,
+    BOUND_LOWER,
+    BOUND_EXACT
+};
+
+static_assert(sizeof(TranspositionEntry) == 16, "transposition entries should stay 16 bytes");
+
+/**
+ * État de la recherche d'un thread.
+ */
+struct SearchState
+{
+    Game itsGame;
+    Evaluator itsEvaluator;
+    uint64_t itsHash = 0;
+    TranspositionTable itsOwnTable;
+    TranspositionTable* itsTable = nullptr;       // itsOwnTable, ou la table gardée par l'appelant
+    Move itsKillers[SEARCH_MAX_PLY][2];
+    vector<int> itsHistory;                        // [départ][arrivée]
+    Move itsPv[SEARCH_MAX_PLY + 1][SEARCH_MAX_PLY + 1];
+    int itsPvLength[SEARCH_MAX_PLY + 1];
+    vector<Move> itsExcluded;                      // coups racine des lignes déjà trouvées
+    uint64_t itsNodes = 0;
+    uint64_t itsMaxNodes = 0;
+    const atomic<bool>* itsStop = nullptr;
+    const function<bool()>* itsCheckpoint = nullptr;  // point de reprise pour l'ordonnanceur, tous les 1024 noeuds
+    chrono::steady_clock::time_point itsStart;
+    chrono::steady_clock::time_point itsDeadline;
+    bool itsTimed = false;
+    bool itsAborted = false;
+};
+
+static bool isSameMove(const Move& aFirst, const Move& aSecond)
+{
+    return aFirst.itsStartPosition.itsRow == aSecond.itsStartPosition.itsRow
+        && aFirst.itsStartPosition.itsCol == aSecond.itsStartPosition.itsCol
+        && aFirst.itsEndPosition.itsRow == aSecond.itsEndPosition.itsRow
+        && aFirst.itsEndPosition.itsCol == aSecond.itsEndPosition.itsCol;
+}
+
+static int getCell(const Position& aPos)
+{
+    return aPos.itsRow * 13 + aPos.itsCol;
+}
+
+// les scores de gain dépendent de la distance à la racine : la table les garde relatifs au nœud
+static int toTableScore(int aScore, int aPly)
+{
+    if (getWinDistance(aScore) > 0)
+        return aScore + aPly;
+    if (getWinDistance(aScore) < 0)
+        return aScore - aPly;
+    return aScore;
+}
+
+static int fromTableScore(int aScore, int aPly)
+{
+    if (getWinDistance(aScore) > 0)
+        return aScore - aPly;
+    if (getWinDistance(aScore) < 0)
+        return aScore + aPly;
+    return aScore;
+}
+
+static TranspositionEntry* probeTable(SearchState& aState)
+{
+    TranspositionEntry* entry = &aState.itsTable->itsEntries[aState.itsHash & aState.itsTable->itsMask];
+    bool found = entry->itsKey == aState.itsHash && entry->itsBound != BOUND_NONE;
+    STATS_ADD(itsTableProbes, 1);
+    STATS_ADD(itsTableHits, found);
+    STATS_ADD(itsTableCollisions, !found && entry->itsBound != BOUND_NONE);
+    return found ? entry : nullptr;
+}
+
+static void storeTable(SearchState& aState, int aDepth, int aScore, Bound aBound, const Move& aMove, int aPly)
+{
+    TranspositionEntry& entry = aState.itsTable->itsEntries[aState.itsHash & aState.itsTable->itsMask];
+    // remplacement : autre position, ou profondeur au moins égale
+    if (entry.itsKey == aState.itsHash && entry.itsDepth > aDepth && aBound != BOUND_EXACT)
+        return;
+    entry.itsKey = aState.itsHash;
+    entry.itsScore = int16_t(toTableScore(aScore, aPly));
+    entry.itsDepth = uint8_t(aDepth);
+    entry.itsBound = aBound;
+    entry.itsMove[0] = uint8_t(aMove.itsStartPosition.itsRow);
+    entry.itsMove[1] = uint8_t(aMove.itsStartPosition.itsCol);
+    entry.itsMove[2] = uint8_t(aMove.itsEndPosition.itsRow);
+    entry.itsMove[3] = uint8_t(aMove.itsEndPosition.itsCol);
+}
+
+// joue un coup en tenant le hachage à jour
+static void playMove(SearchState& aState, const Move& aMove, MoveUndo& aUndo)
+{
+    const Position& from = aMove.itsStartPosition;
+    PieceType piece = aState.itsGame.itsBoard.itsCells[from.itsRow][from.itsCol].itsPieceType;
+    makeMove(aState.itsGame, aMove, aUndo);
+    aState.itsHash ^= getPieceKey(piece, from) ^ getPieceKey(piece, aMove.itsEndPosition) ^ getSideKey();
+    for (int d = 0; d < 4; ++d)
+        if (aUndo.itsCaptured & (1 << d))
+            aState.itsHash ^= getPieceKey(aUndo.itsNeighbours[d], getNeighbour(aMove, d));
+}
+
+static void takeBack(SearchState& aState, const Move& aMove, const MoveUndo& aUndo, uint64_t aHash)
+{
+    unmakeMove(aState.itsGame, aMove, aUndo);
+    aState.itsHash = aHash;
+}
+
+static int evaluateNode(const SearchState& aState)
+{
+    STATS_TIME(itsEvalTime);
+    return evaluate(aState.itsEvaluator, aState.itsGame);
+}
+
+static int generateNodeMoves(const SearchState& aState, Move* aMoves)
+{
+    STATS_TIME(itsMoveGenTime);
+    return generateMoves(aState.itsGame, aMoves);
+}
+
+// mêmes règles que isGameFinished et whoWon, avec la case du roi suivie par l'évaluateur
+static bool isFinished(const SearchState& aState, bool& aAttackWon)
+{
+    static const int DIR_ROW[4] = {-1, 1, 0, 0};
+    static const int DIR_COL[4] = {0, 0, -1, 1};
+    const Board& board = aState.itsGame.itsBoard;
+    Position king = aState.itsEvaluator.itsKing;
+    aAttackWon = true;
+    for (int d = 0; d < 4 && aAttackWon; ++d) {
+        Position pos = {king.itsRow + DIR_ROW[d], king.itsCol + DIR_COL[d]};
+        aAttackWon = !isValidPosition(pos, board) || board.itsCells[pos.itsRow][pos.itsCol].itsPieceType == SWORD
+                     || board.itsCells[pos.itsRow][pos.itsCol].itsCellType != NORMAL;
+    }
+    return aAttackWon || board.itsCells[king.itsRow][king.itsCol].itsCellType == FORTRESS
+           || aState.itsEvaluator.itsFeatures[EVAL_SWORDS] == 0;
+}
+
+// score d'une position finie pour le joueur au trait
+static int getFinishedScore(const SearchState& aState, bool aAttackWon, int aPly)
+{
+    bool attackToMove = aState.itsGame.itsCurrentPlayer->itsRole == ATTACK;
+    return (aAttackWon == attackToMove) ? SEARCH_WIN - aPly : -(SEARCH_WIN - aPly);
+}
+
+// le drapeau d'arrêt est lu à chaque noeud (un arrêt demandé est pris en compte sans délai), l'horloge tous les 1024 noeuds
+static bool shouldStop(SearchState& aState)
+{
+    if (aState.itsAborted)
+        return true;
+    if (aState.itsStop != nullptr && aState.itsStop->load(memory_order_relaxed))
+        aState.itsAborted = true;
+    else if ((aState.itsNodes & 1023) == 0) {
+        // le point de reprise peut chercher pour un autre joueur avant de rendre la main
+        if (aState.itsCheckpoint != nullptr && (*aState.itsCheckpoint)())
+            aState.itsAborted = true;
+        else if ((aState.itsMaxNodes > 0 && aState.itsNodes >= aState.itsMaxNodes)
+            || (aState.itsTimed && chrono::steady_clock::now() >= aState.itsDeadline))
+            aState.itsAborted = true;
+    }
+    return aState.itsAborted;
+}
+
+// ordre des coups : coup de la table, coups tueurs, historique
+static void orderMoves(const SearchState& aState, Move* aMoves, int aCount, const TranspositionEntry* aEntry, int aPly)
+{
+    int scores[MAX_MOVES];
+    for (int i = 0; i < aCount; ++i) {
+        const Move& move = aMoves[i];
+        if (aEntry != nullptr && move.itsStartPosition.itsRow == aEntry->itsMove[0] && move.itsStartPosition.itsCol == aEntry->itsMove[1]
+            && move.itsEndPosition.itsRow == aEntry->itsMove[2] && move.itsEndPosition.itsCol == aEntry->itsMove[3])
+            scores[i] = 1 << 30;
+        else if (isSameMove(move, aState.itsKillers[aPly][0]))
+            scores[i] = (1 << 29) + 1;
+        else if (isSameMove(move, aState.itsKillers[aPly][1]))
+            scores[i] = 1 << 29;
+        else
+            scores[i] = aState.itsHistory[getCell(move.itsStartPosition) * CELLS + getCell(move.itsEndPosition)];
+    }
+    // tri par insertion, stable : les listes sont courtes
+    for (int i = 1; i < aCount; ++i) {
+        Move move = aMoves[i];
+        int score = scores[i];
+        int j = i - 1;
+        for (; j >= 0 && scores[j] < score; --j) {
+            aMoves[j + 1] = aMoves[j];
+            scores[j + 1] = scores[j];
+        }
+        aMoves[j + 1] = move;
+        scores[j + 1] = score;
+    }
+}
+
+static void updatePv(SearchState& aState, int aPly, const Move& aMove)
+{
+    aState.itsPv[aPly][aPly] = aMove;
+    for (int i = aPly + 1; i < aState.itsPvLength[aPly + 1]; ++i)
+        aState.itsPv[aPly][i] = aState.itsPv[aPly + 1][i];
+    aState.itsPvLength[aPly] = max(aPly + 1, aState.itsPvLength[aPly + 1]);
+}
+
+// recherche de repos : seuls les coups qui capturent ou finissent la partie sont joués
+static int quiesce(SearchState& aState, int aPly, int aAlpha, int aBeta, int aDepth)
+{
+    aState.itsNodes++;
+    STATS_ADD(itsNodes, 1);
+    STATS_ADD(itsQuiescenceNodes, 1);
+    aState.itsPvLength[aPly] = aPly;
+    if (shouldStop(aState))
+        return 0;
+    int standPat = evaluateNode(aState);
+    if (standPat >= aBeta || aDepth == 0 || aPly >= SEARCH_MAX_PLY - 1)
+        return standPat;
+    int best = standPat;
+    aAlpha = max(aAlpha, standPat);
+
+    Move moves[MAX_MOVES];
+    int count = generateNodeMoves(aState, moves);
+    uint64_t hash = aState.itsHash;
+    for (int i = 0; i < count; ++i) {
+        MoveUndo undo;
+        playMove(aState, moves[i], undo);
+        aState.itsPvLength[aPly + 1] = aPly + 1;
+        bool attackWon;
+        int score;
+        if (isFinished(aState, attackWon))
+            score = -getFinishedScore(aState, attackWon, aPly + 1);
+        else if (undo.itsCaptured != 0)
+            score = -quiesce(aState, aPly + 1, -aBeta, -aAlpha, aDepth - 1);
+        else {
+            takeBack(aState, moves[i], undo, hash);
+            continue;
+        }
+        takeBack(aState, moves[i], undo, hash);
+        if (aState.itsAborted)
+            return 0;
+        if (score > best) {
+            best = score;
+            if (score > aAlpha) {
+                aAlpha = score;
+                updatePv(aState, aPly, moves[i]);
+            }
+            if (score >= aBeta)
+                break;
+        }
+    }
+    return best;
+}
+
+static int search(SearchState& aState, int aDepth, int aPly, int aAlpha, int aBeta, bool aNullMove = true)
+{
+    if (aDepth <= 0 || aPly >= SEARCH_MAX_PLY - 1)
+        return quiesce(aState, aPly, aAlpha, aBeta, QUIESCENCE_DEPTH);
+    aState.itsNodes++;
+    STATS_ADD(itsNodes, 1);
+    aState.itsPvLength[aPly] = aPly;
+    if (shouldStop(aState))
+        return 0;
+
+    bool pvNode = aBeta - aAlpha > 1;
+    TranspositionEntry* entry = probeTable(aState);
+    if (entry != nullptr && !pvNode && entry->itsDepth >= aDepth) {
+        int score = fromTableScore(entry->itsScore, aPly);
+        if (entry->itsBound == BOUND_EXACT
+            || (entry->itsBound == BOUND_LOWER && score >= aBeta)
+            || (entry->itsBound == BOUND_UPPER && score <= aAlpha))
+            return score;
+    }
+
+    // coup nul : si passer son tour suffit à dépasser beta, un vrai coup le fera aussi
+    if (aNullMove && !pvNode && aDepth >= 3 && evaluateNode(aState) >= aBeta) {
+        uint64_t hash = aState.itsHash;
+        switchCurrentPlayer(aState.itsGame);
+        aState.itsHash ^= getSideKey();
+        int score = -search(aState, aDepth - 3, aPly + 1, -aBeta, -aBeta + 1, false);
+        switchCurrentPlayer(aState.itsGame);
+        aState.itsHash = hash;
+        if (aState.itsAborted)
+            return 0;
+        if (score >= aBeta && getWinDistance(score) == 0)
+            return score;
+    }
+
+    Move moves[MAX_MOVES];
+    int count = generateNodeMoves(aState, moves);
+    if (count == 0)
+        return 0; // aucun coup : partie arrêtée
+    orderMoves(aState, moves, count, entry, aPly);
+
+    int alpha = aAlpha;
+    int best = -SEARCH_INFINITY;
+    Move bestMove = moves[0];
+    uint64_t hash = aState.itsHash;
+    for (int i = 0; i < count; ++i) {
+        MoveUndo undo;
+        playMove(aState, moves[i], undo);
+        aState.itsPvLength[aPly + 1] = aPly + 1;
+        bool attackWon;
+        int score;
+        if (isFinished(aState, attackWon))
+            score = -getFinishedScore(aState, attackWon, aPly + 1);
+        else if (i == 0)
+            score = -search(aState, aDepth - 1, aPly + 1, -aBeta, -alpha);
+        else {
+            // coups tardifs sans capture : cherchés moins profond, puis à nouveau s'ils dépassent alpha
+            int reduction = (i >= 3 && aDepth >= 3 && !pvNode && undo.itsCaptured == 0) ? 1 + (i >= 12 && aDepth >= 5) : 0;
+            score = -search(aState, aDepth - 1 - reduction, aPly + 1, -alpha - 1, -alpha);
+            if (reduction > 0 && score > alpha)
+                score = -search(aState, aDepth - 1, aPly + 1, -alpha - 1, -alpha);
+            if (score > alpha && score < aBeta)
+                score = -search(aState, aDepth - 1, aPly + 1, -aBeta, -alpha);
+        }
+        takeBack(aState, moves[i], undo, hash);
+        if (aState.itsAborted)
+            return 0;
+
+        if (score > best) {
+            best = score;
+            bestMove = moves[i];
+            if (score > alpha) {
+                alpha = score;
+                updatePv(aState, aPly, moves[i]);
+            }
+            if (score >= aBeta) {
+                STATS_ADD(itsCutoffs, 1);
+                STATS_ADD(itsFirstMoveCutoffs, i == 0);
+                if (undo.itsCaptured == 0 && !isSameMove(moves[i], aState.itsKillers[aPly][0])) {
+                    aState.itsKillers[aPly][1] = aState.itsKillers[aPly][0];
+                    aState.itsKillers[aPly][0] = moves[i];
+                }
+                aState.itsHistory[getCell(moves[i].itsStartPosition) * CELLS + getCell(moves[i].itsEndPosition)] += aDepth * aDepth;
+                break;
+            }
+        }
+    }
+
+    Bound bound = (best >= aBeta) ? BOUND_LOWER : (best > aAlpha) ? BOUND_EXACT : BOUND_UPPER;
+    storeTable(aState, aDepth, best, bound, bestMove, aPly);
+    return best;
+}
+
+// racine d'une ligne : les coups des lignes précédentes sont exclus
+static int searchRoot(SearchState& aState, const vector<Move>& aRootMoves, int aDepth, int aAlpha, int aBeta, AnalysisLine& aLine)
+{
+    aState.itsNodes++;
+    STATS_ADD(itsNodes, 1);
+    aState.itsPvLength[0] = 0;
+    int alpha = aAlpha;
+    int best = -SEARCH_INFINITY;
+    uint64_t hash = aState.itsHash;
+    bool first = true;
+    for (const Move& move : aRootMoves) {
+        bool excluded = false;
+        for (const Move& other : aState.itsExcluded)
+            excluded = excluded || isSameMove(move, other);
+        if (excluded)
+            continue;
+
+        MoveUndo undo;
+        playMove(aState, move, undo);
+        aState.itsPvLength[1] = 1;
+        bool attackWon;
+        int score;
+        if (isFinished(aState, attackWon))
+            score = -getFinishedScore(aState, attackWon, 1);
+        else if (first)
+            score = -search(aState, aDepth - 1, 1, -aBeta, -alpha);
+        else {
+            score = -search(aState, aDepth - 1, 1, -alpha - 1, -alpha);
+            if (score > alpha && score < aBeta)
+                score = -search(aState, aDepth - 1, 1, -aBeta, -alpha);
+        }
+        takeBack(aState, move, undo, hash);
+        if (aState.itsAborted)
+            return 0;
+        first = false;
+
+        if (score > best) {
+            best = score;
+            if (score > alpha || aLine.itsPv.empty()) {
+                alpha = max(alpha, score);
+                updatePv(aState, 0, move);
+                aLine.itsMove = move;
+                aLine.itsPv.assign(aState.itsPv[0], aState.itsPv[0] + aState.itsPvLength[0]);
+            }
+            if (score >= aBeta)
+                break;
+        }
+    }
+    aLine.itsScore = best;
+    return best;
+}
+
+// recherche d'une ligne avec sa fenêtre d'aspiration, élargie tant que le score en sort
+static bool searchLine(SearchState& aState, const vector<Move>& aRootMoves, int aDepth, const AnalysisLine* aPrevious,
+                       int aAspiration, AnalysisLine& aLine)
+{
+    int delta = aAspiration;
+    int alpha = -SEARCH_INFINITY;
+    int beta = SEARCH_INFINITY;
+    if (aPrevious != nullptr && aDepth >= 3 && getWinDistance(aPrevious->itsScore) == 0) {
+        alpha = max(-SEARCH_INFINITY, aPrevious->itsScore - delta);
+        beta = min(SEARCH_INFINITY, aPrevious->itsScore + delta);
+    }
+    while (true) {
+        aLine.itsPv.clear();
+        int score = searchRoot(aState, aRootMoves, aDepth, alpha, beta, aLine);
+        if (aState.itsAborted)
+            return false;
+        delta *= 2;
+        if (score <= alpha && alpha > -SEARCH_INFINITY)
+            alpha = (delta > 1000) ? -SEARCH_INFINITY : max(-SEARCH_INFINITY, score - delta);
+        else if (score >= beta && beta < SEARCH_INFINITY)
+            beta = (delta > 1000) ? SEARCH_INFINITY : min(SEARCH_INFINITY, score + delta);
+        else
+            return !aLine.itsPv.empty();
+    }
+}
+
+AnalysisInfo analysePosition(const Game& aGame, const AnalysisConfig& aConfig, const AnalysisCallback& aCallback,
+                             const atomic<bool>* aStop)
+{
+    unique_ptr<SearchState> state(new SearchState());
+    state->itsStart = chrono::steady_clock::now();
+    state->itsTimed = aConfig.itsMaxSeconds > 0;
+    state->itsDeadline = state->itsStart + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(aConfig.itsMaxSeconds));
+    state->itsMaxNodes = aConfig.itsMaxNodes;
+    state->itsStop = aStop;
+    if (aConfig.itsCheckpoint)
+        state->itsCheckpoint = &aConfig.itsCheckpoint;
+    state->itsTable = aConfig.itsTable;
+    if (state->itsTable == nullptr) {
+        createTranspositionTable(state->itsOwnTable, aConfig.itsHashBits);
+        state->itsTable = &state->itsOwnTable;
+    }
+    state->itsHistory.assign(CELLS * CELLS, 0);
+    memset(state->itsKillers, -1, sizeof(state->itsKillers));
+    resetThreadStats();
+    STATS_SET(itsTiming, aConfig.itsTiming);
+
+    // copie de la position : la recherche joue sur son propre plateau
+    PackedBoard packed;
+    packPosition(aGame, packed);
+    Game& game = state->itsGame;
+    unpackPosition(packed, game);
+    state->itsHash = hashPosition(game);
+    attachEvaluator(state->itsEvaluator, game);
+
+    AnalysisInfo result;
+    Move moves[MAX_MOVES];
+    int count = generateMoves(game, moves);
+    bool attackWon;
+    if (count > 0 && !isFinished(*state, attackWon)) {
+        vector<Move> rootMoves(moves, moves + count);
+        int lines = max(1, min(aConfig.itsLines, count));
+        for (int depth = 1; depth <= min(aConfig.itsMaxDepth, SEARCH_MAX_PLY - 1); ++depth) {
+            AnalysisInfo info;
+            info.itsDepth = depth;
+            // sans statistiques, seul STATS_ADD lit ce relevé
+            [[maybe_unused]] uint64_t nodes = state->itsNodes;
+            state->itsExcluded.clear();
+            for (int k = 0; k < lines; ++k) {
+                AnalysisLine line;
+                const AnalysisLine* previous = (k < int(result.itsLines.size())) ? &result.itsLines[k] : nullptr;
+                if (!searchLine(*state, rootMoves, depth, previous, aConfig.itsAspiration, line))
+                    break;
+                info.itsLines.push_back(line);
+                state->itsExcluded.push_back(line.itsMove);
+            }
+            if (state->itsAborted)
+                break;
+
+            // les lignes suivantes sont cherchées sans les précédentes : leurs scores décroissent
+            stable_sort(info.itsLines.begin(), info.itsLines.end(),
+                        [](const AnalysisLine& a, const AnalysisLine& b) { return a.itsScore > b.itsScore; });
+            // les meilleurs coups en tête de la racine pour la profondeur suivante
+            for (int k = int(info.itsLines.size()) - 1; k >= 0; --k) {
+                vector<Move>::iterator it = find_if(rootMoves.begin(), rootMoves.end(),
+                                                    [&](const Move& m) { return isSameMove(m, info.itsLines[k].itsMove); });
+                rotate(rootMoves.begin(), it, it + 1);
+            }
+            info.itsNodes = state->itsNodes;
+            info.itsSeconds = chrono::duration<double>(chrono::steady_clock::now() - state->itsStart).count();
+            if (depth < STATS_MAX_DEPTH) {
+                STATS_ADD(itsDepthNodes[depth], state->itsNodes - nodes);
+                STATS_SET(itsMaxDepth, depth);
+            }
+            STATS_SET(itsSeconds, info.itsSeconds);
+            STATS_COPY(info.itsStats);
+            result = info;
+            if (aCallback)
+                aCallback(result);
+            if (all_of(result.itsLines.begin(), result.itsLines.end(),
+                       [depth](const AnalysisLine& l) { return getWinDistance(l.itsScore) != 0 && abs(getWinDistance(l.itsScore)) <= depth; }))
+                break; // toutes les lignes sont des gains ou pertes forcés : inutile d'aller plus loin
+        }
+    }
+    detachEvaluator(state->itsEvaluator, game);
+    deleteBoard(game.itsBoard);
+    STATS_SET(itsTiming, false);
+    return result;
+}
+
+bool searchMove(const Game& aGame, const MoveBudget& aBudget, TranspositionTable* aTable, Move& aMove, AnalysisInfo* aInfo,
+                int aMaxDepth, const function<bool()>& aCheckpoint)
+{
+    AnalysisConfig config;
+    config.itsMaxDepth = aMaxDepth;
+    config.itsTable = aTable;
+    config.itsCheckpoint = aCheckpoint;
+    return searchMove(aGame, aBudget, config, aMove, aInfo, AnalysisCallback());
+}
+
+bool searchMove(const Game& aGame, const MoveBudget& aBudget, const AnalysisConfig& aConfig, Move& aMove,
+                AnalysisInfo* aInfo, const AnalysisCallback& aCallback, atomic<bool>* aStop)
+{
+    int64_t start = getClockTime();
+    atomic<bool> ownStop(false);
+    atomic<bool>& stop = (aStop != nullptr) ? *aStop : ownStop;
+    AnalysisConfig config = aConfig;
+    config.itsLines = 1;
+    if (aBudget.itsHard != INT64_MAX)
+        config.itsMaxSeconds = max<double>(1e-3, double(aBudget.itsHard) / CLOCK_SECOND);
+
+    // arrêt entre deux itérations une fois le délai souple atteint, plus tôt si le coup ne change plus
+    Move best = {{-1, -1}, {-1, -1}};
+    int stability = 0;
+    AnalysisInfo result = analysePosition(aGame, config, [&](const AnalysisInfo& aIteration) {
+        if (aCallback)
+            aCallback(aIteration);
+        const Move& move = aIteration.itsLines[0].itsMove;
+        stability = isSameMove(move, best) ? stability + 1 : 0;
+        best = move;
+        if (isSoftDeadlineReached(aBudget, getClockTime() - start, stability))
+            stop = true;
+    }, &stop);
+
+    if (aInfo != nullptr)
+        *aInfo = result;
+    if (!result.itsLines.empty()) {
+        aMove = result.itsLines[0].itsMove;
+        return true;
+    }
+    // aucune itération terminée : premier coup légal
+    Move moves[MAX_MOVES];
+    if (isGameFinished(aGame) || generateMoves(aGame, moves) == 0)
+        return false;
+    aMove = moves[0];
+    return true;
+}
+
+void startAnalysis(Analysis& aAnalysis, const Game& aGame, const AnalysisConfig& aConfig, const AnalysisCallback& aCallback)
+{
+    stopAnalysis(aAnalysis);
+    aAnalysis.itsStop = false;
+    aAnalysis.itsRunning = true;
+    PackedBoard packed;
+    packPosition(aGame, packed);
+    aAnalysis.itsThread = thread([&aAnalysis, packed, aConfig, aCallback]() {
+        Game game;
+        unpackPosition(packed, game);
+        analysePosition(game, aConfig, aCallback, &aAnalysis.itsStop);
+        deleteBoard(game.itsBoard);
+        aAnalysis.itsRunning = false;
+    });
+}
+
+void stopAnalysis(Analysis& aAnalysis)
+{
+    aAnalysis.itsStop = true;
+    waitAnalysis(aAnalysis);
+}
+
+void waitAnalysis(Analysis& aAnalysis)
+{
+    if (aAnalysis.itsThread.joinable())
+        aAnalysis.itsThread.join();
+}
+
+void createTranspositionTable(TranspositionTable& aTable, int aBits)
+{
+    aTable.itsEntries.assign(size_t(1) << aBits, TranspositionEntry());
+    aTable.itsMask = (uint64_t(1) << aBits) - 1;
+}
+
+void clearTranspositionTable(TranspositionTable& aTable)
+{
+    fill(aTable.itsEntries.begin(), aTable.itsEntries.end(), TranspositionEntry());
+}
+
+int getWinDistance(int aScore)
+{
+    if (aScore >= SEARCH_WIN - 2 * SEARCH_MAX_PLY)
+        return SEARCH_WIN - aScore;
+    if (aScore <= -(SEARCH_WIN - 2 * SEARCH_MAX_PLY))
+        return -(SEARCH_WIN + aScore);
+    return 0;
+}
+
+string formatAnalysisJson(const AnalysisInfo& aInfo)
+{
+    ostringstream out;
+    char text[MOVE_STRING_SIZE];
+    out << "{\"depth\":" << aInfo.itsDepth << ",\"nodes\":" << aInfo.itsNodes << ",\"time\":" << aInfo.itsSeconds
+        << ",\"nps\":" << uint64_t((aInfo.itsSeconds > 0) ? double(aInfo.itsNodes) / aInfo.itsSeconds : 0) << ",\"lines\":[";
+    for (size_t k = 0; k < aInfo.itsLines.size(); ++k) {
+        const AnalysisLine& line = aInfo.itsLines[k];
+        formatMove(line.itsMove, text, MOVE_STRING_SIZE);
+        out << (k > 0 ? "," : "") << "{\"move\":\"" << text << "\",\"score\":" << line.itsScore;
+        if (getWinDistance(line.itsScore) != 0)
+            out << ",\"win\":" << getWinDistance(line.itsScore);
+        out << ",\"pv\":[";
+        for (size_t i = 0; i < line.itsPv.size(); ++i) {
+            formatMove(line.itsPv[i], text, MOVE_STRING_SIZE);
+            out << (i > 0 ? "," : "") << "\"" << text << "\"";
+        }
+        out << "]}";
+    }
+    out << "]}";
+    return out.str();
+}
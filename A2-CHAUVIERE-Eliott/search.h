@@ -0,0 +1,238 @@
+/**
+ * @file search.h
+ *
+ * @brief Multi-line analysis of a position (alpha-beta search).
+ *
+ * The search is a negamax alpha-beta with principal variation search, a transposition table
+ * keyed by the Zobrist hash (updated from the moved and captured cells), killer moves, a history
+ * table and a quiescence search on captures and winning moves. It deepens one ply at a time; at
+ * each depth the best `itsLines` root moves are searched one after the other, each line excluding
+ * the moves of the lines before it and starting from an aspiration window around its own score
+ * at the previous depth.
+ *
+ * The transposition table can be kept by the caller between searches: a bot ponders on the
+ * opponent's time with `startAnalysis` on the position the opponent has to play, so the replies
+ * are already in the table when `searchMove` looks for its own move.
+ *
+ * An analysis runs on its own worker thread: the caller receives the lines of every completed
+ * depth through a callback (called on the worker thread), and `formatAnalysisJson` turns them
+ * into one JSON line.
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "typeDef.h"
+#include "clock.h"
+#include "stats.h"
+
+/**
+ * @brief Deepest ply reached by the search (quiescence included).
+ */
+const int SEARCH_MAX_PLY = 64;
+
+/**
+ * @brief Score of a won position; a win in `n` plies scores `SEARCH_WIN - n`.
+ */
+const int SEARCH_WIN = 30000;
+
+/**
+ * @struct TranspositionEntry
+ * @brief A position of the transposition table (16 bytes).
+ */
+struct TranspositionEntry
+{
+    uint64_t itsKey;     /**< Hash of the position (`hashPosition`). */
+    int16_t itsScore;    /**< Score, wins counted from the position. */
+    uint8_t itsDepth;    /**< Depth searched. */
+    uint8_t itsBound;    /**< 0 for an empty slot, 1 upper bound, 2 lower bound, 3 exact score. */
+    uint8_t itsMove[4];  /**< Best move: start row and column, end row and column. */
+};
+
+/**
+ * @struct TranspositionTable
+ * @brief Positions already searched, one per slot (the slot is the low bits of the hash).
+ */
+struct TranspositionTable
+{
+    vector<TranspositionEntry> itsEntries; /**< The slots. */
+    uint64_t itsMask = 0;                  /**< Number of slots minus one. */
+};
+
+/**
+ * @struct AnalysisConfig
+ * @brief Settings of an analysis.
+ */
+struct AnalysisConfig
+{
+    int itsLines = 5;            /**< Number of best moves to report. */
+    int itsMaxDepth = 32;        /**< Last depth searched. */
+    uint64_t itsMaxNodes = 0;    /**< Nodes after which the search stops (0 for no limit). */
+    double itsMaxSeconds = 0;    /**< Time after which the search stops (0 for no limit). */
+    int itsAspiration = 40;      /**< Half width of the first aspiration window of a line. */
+    int itsHashBits = 20;        /**< Size of the transposition table (2^bits entries of 16 bytes). */
+    TranspositionTable* itsTable = nullptr; /**< Table kept by the caller, or null for a table of the analysis only. */
+    bool itsTiming = false;      /**< Times move generation, captures and evaluation (`SearchStats`); slows the search down. */
+    function<bool()> itsCheckpoint; /**< Called every 1024 nodes on the searching thread (may be empty); it may run other work before returning, and returns `true` to stop the search. */
+};
+
+/**
+ * @struct AnalysisLine
+ * @brief One of the best moves of a position.
+ */
+struct AnalysisLine
+{
+    Move itsMove;        /**< The move. */
+    int itsScore;        /**< Its score for the player to move. */
+    vector<Move> itsPv;  /**< Principal variation, starting with `itsMove`. */
+};
+
+/**
+ * @struct AnalysisInfo
+ * @brief Result of a completed depth.
+ */
+struct AnalysisInfo
+{
+    int itsDepth = 0;              /**< Depth searched. */
+    uint64_t itsNodes = 0;         /**< Nodes searched since the start of the analysis. */
+    double itsSeconds = 0;         /**< Time since the start of the analysis. */
+    vector<AnalysisLine> itsLines; /**< Best moves, best first. */
+    SearchStats itsStats;          /**< Counters of the search so far. */
+};
+
+/**
+ * @brief Function receiving the result of each completed depth.
+ */
+typedef function<void(const AnalysisInfo&)> AnalysisCallback;
+
+/**
+ * @struct Analysis
+ * @brief An analysis running on a worker thread.
+ */
+struct Analysis
+{
+    thread itsThread;                /**< The worker thread. */
+    atomic<bool> itsStop{false};     /**< Set to stop the search. */
+    atomic<bool> itsRunning{false};  /**< `true` until the worker has returned. */
+};
+
+/**
+ * @brief Analyses a position on the calling thread.
+ *
+ * @param aGame The position (it is copied, the game is not changed).
+ * @param aConfig The settings.
+ * @param aCallback Called after every completed depth (may be empty).
+ * @param aStop If not null, the search stops as soon as it is set.
+ * @return The result of the last completed depth (no line if the position is finished or has no move).
+ *
+ * @note The counters of the calling thread (`threadStats`) are reset when the analysis starts.
+ */
+AnalysisInfo analysePosition(const Game& aGame, const AnalysisConfig& aConfig, const AnalysisCallback& aCallback,
+                             const atomic<bool>* aStop = nullptr);
+
+/**
+ * @brief Searches the move of a bot within the deadlines of a move.
+ *
+ * Iterations stop once the soft deadline, scaled by the stability of the best move, is reached
+ * (`isSoftDeadlineReached`); the search itself stops at the hard deadline.
+ *
+ * @param aGame The position.
+ * @param aBudget The deadlines, counted from the call (`allocateTime`).
+ * @param aTable Table kept between searches (e.g. filled while pondering), or null.
+ * @param aMove Receives the move.
+ * @param aInfo If not null, receives the last completed depth.
+ * @param aMaxDepth Last depth searched.
+ * @param aCheckpoint Called every 1024 nodes (`AnalysisConfig::itsCheckpoint`).
+ * @return `false` if the position is finished or has no move.
+ */
+bool searchMove(const Game& aGame, const MoveBudget& aBudget, TranspositionTable* aTable, Move& aMove,
+                AnalysisInfo* aInfo = nullptr, int aMaxDepth = SEARCH_MAX_PLY - 1,
+                const function<bool()>& aCheckpoint = nullptr);
+
+/**
+ * @brief Searches a move within the deadlines of a move, with the other limits of an analysis.
+ *
+ * Same stopping rules as the other `searchMove`; the hard deadline, if any, replaces
+ * `itsMaxSeconds`. Without a completed depth the move is the first legal one.
+ *
+ * @param aGame The position.
+ * @param aBudget The deadlines, counted from the call (`allocateTime`).
+ * @param aConfig The other settings (depth, nodes, table, checkpoint); `itsLines` is ignored.
+ * @param aMove Receives the move.
+ * @param aInfo If not null, receives the last completed depth.
+ * @param aCallback Called after every completed depth (may be empty).
+ * @param aStop If not null, the search stops as soon as it is set; it is set at the soft deadline.
+ * @return `false` if the position is finished or has no move.
+ */
+bool searchMove(const Game& aGame, const MoveBudget& aBudget, const AnalysisConfig& aConfig, Move& aMove,
+                AnalysisInfo* aInfo, const AnalysisCallback& aCallback, atomic<bool>* aStop = nullptr);
+
+/**
+ * @brief Starts analysing a position on a worker thread and returns at once.
+ *
+ * A running analysis is stopped first. The callback is called on the worker thread.
+ *
+ * @param aAnalysis The analysis.
+ * @param aGame The position (it is copied).
+ * @param aConfig The settings.
+ * @param aCallback Called after every completed depth.
+ */
+void startAnalysis(Analysis& aAnalysis, const Game& aGame, const AnalysisConfig& aConfig, const AnalysisCallback& aCallback);
+
+/**
+ * @brief Stops an analysis and waits for its worker thread.
+ *
+ * @param aAnalysis The analysis.
+ */
+void stopAnalysis(Analysis& aAnalysis);
+
+/**
+ * @brief Waits until an analysis reaches one of its limits.
+ *
+ * @param aAnalysis The analysis.
+ */
+void waitAnalysis(Analysis& aAnalysis);
+
+/**
+ * @brief Allocates a transposition table.
+ *
+ * @param aTable The table.
+ * @param aBits The table gets 2^bits entries of 16 bytes.
+ */
+void createTranspositionTable(TranspositionTable& aTable, int aBits);
+
+/**
+ * @brief Empties a transposition table (e.g. for a new game).
+ *
+ * @param aTable The table.
+ */
+void clearTranspositionTable(TranspositionTable& aTable);
+
+/**
+ * @brief Tells whether a score is a forced win or loss.
+ *
+ * @param aScore A score returned by the search.
+ * @return The number of plies to the end of the game (negative if the player to move loses), or 0.
+ */
+int getWinDistance(int aScore);
+
+/**
+ * @brief Writes the result of a depth as one line of JSON (without the end of line).
+ *
+ * Example: `{"depth":6,"nodes":51234,"time":0.412,"nps":124354,"lines":[{"move":"d1-d3","score":35,"pv":["d1-d3","f4-d4"]}]}`;
+ * a forced win also gives `"win":n` (plies, negative for a loss).
+ *
+ * @param aInfo The result.
+ * @return The JSON text.
+ */
+string formatAnalysisJson(const AnalysisInfo& aInfo);
+
+#endif // SEARCH_H
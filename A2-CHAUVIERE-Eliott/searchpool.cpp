@@ -0,0 +1,225 @@
+using namespace std;
+#include <algorithm>
+#include "searchpool.h"
+#include "functions.h"
+
+/**
+ * Le fil d'un ouvrier : sa file, et la tâche qu'il cherche en ce moment.
+ */
+struct SearchWorker
+{
+    SearchPool* itsPool;
+    int itsIndex;
+    int itsDepth;       // tâches empilées en cours
+    int64_t itsKey;     // clé de la tâche du dessus
+};
+
+static thread_local SearchWorker* currentWorker = nullptr;
+
+static bool isLater(const shared_ptr<SearchTask>& aFirst, const shared_ptr<SearchTask>& aSecond)
+{
+    return aFirst->itsKey > aSecond->itsKey;
+}
+
+static void pushTask(SearchPool& aPool, const shared_ptr<SearchTask>& aTask)
+{
+    // depuis un ouvrier, la tâche va dans sa propre file ; sinon chacune son tour
+    int index = (currentWorker != nullptr && currentWorker->itsPool == &aPool) ? currentWorker->itsIndex
+                                                                               : int(aPool.itsNext++ % aPool.itsQueues.size());
+    SearchQueue& queue = *aPool.itsQueues[index];
+    {
+        lock_guard<mutex> lock(queue.itsLock);
+        queue.itsTasks.push_back(aTask);
+        push_heap(queue.itsTasks.begin(), queue.itsTasks.end(), isLater);
+        queue.itsTop = queue.itsTasks.front()->itsKey;
+    }
+    aPool.itsWaiting++;
+    {
+        lock_guard<mutex> lock(aPool.itsLock);
+    }
+    aPool.itsWake.notify_one();
+}
+
+// tâche la plus urgente de toutes les files, plus urgente que aBefore ; la file de l'ouvrier d'abord
+static shared_ptr<SearchTask> takeTask(SearchPool& aPool, int aIndex, int64_t aBefore, bool aMovesOnly)
+{
+    int count = int(aPool.itsQueues.size());
+    while (aPool.itsWaiting > 0) {
+        int best = -1;
+        int64_t bestKey = aBefore;
+        for (int i = 0; i < count; ++i) {
+            int index = (aIndex + i) % count;
+            int64_t top = aPool.itsQueues[index]->itsTop.load(memory_order_relaxed);
+            if (top < bestKey) {
+                best = index;
+                bestKey = top;
+            }
+        }
+        if (best < 0)
+            return nullptr;
+        SearchQueue& queue = *aPool.itsQueues[best];
+        lock_guard<mutex> lock(queue.itsLock);
+        // la file a pu changer depuis la lecture de sa clé : on recommence
+        if (queue.itsTasks.empty() || queue.itsTasks.front()->itsKey != bestKey)
+            continue;
+        if (aMovesOnly && queue.itsTasks.front()->itsAnalysis)
+            return nullptr;
+        pop_heap(queue.itsTasks.begin(), queue.itsTasks.end(), isLater);
+        shared_ptr<SearchTask> task = move(queue.itsTasks.back());
+        queue.itsTasks.pop_back();
+        queue.itsTop = queue.itsTasks.empty() ? INT64_MAX : queue.itsTasks.front()->itsKey;
+        aPool.itsWaiting--;
+        if (best != aIndex)
+            aPool.itsSteals++;
+        return task;
+    }
+    return nullptr;
+}
+
+static void finishTask(SearchPool& aPool, SearchTask& aTask)
+{
+    aTask.itsFinished = getClockTime();
+    {
+        lock_guard<mutex> lock(aPool.itsLock);
+        aTask.itsDone = true;
+    }
+    aPool.itsDone.notify_all();
+}
+
+static void runTask(SearchPool& aPool, SearchTask& aTask);
+
+// point de reprise : une recherche de coup plus urgente passe devant, sur la pile de la recherche en cours
+static bool checkpoint(SearchPool& aPool, SearchTask& aTask)
+{
+    SearchWorker& worker = *currentWorker;
+    if (worker.itsDepth < SEARCH_POOL_NESTING && aPool.itsWaiting > 0) {
+        shared_ptr<SearchTask> urgent = takeTask(aPool, worker.itsIndex, worker.itsKey - aPool.itsMargin, true);
+        if (urgent != nullptr) {
+            aPool.itsPreemptions++;
+            // les compteurs du fil appartiennent à la recherche interrompue
+            SearchStats stats = threadStats;
+            runTask(aPool, *urgent);
+            threadStats = stats;
+        }
+    }
+    return aTask.itsStop || aPool.itsStop;
+}
+
+static void runTask(SearchPool& aPool, SearchTask& aTask)
+{
+    SearchWorker& worker = *currentWorker;
+    int64_t now = getClockTime();
+    aTask.itsStarted = now;
+    int64_t key = worker.itsKey;
+    worker.itsKey = aTask.itsAnalysis ? now + aPool.itsAging : aTask.itsKey;
+    worker.itsDepth++;
+    if (!aTask.itsStop && !aPool.itsStop) {
+        Game game;
+        unpackPosition(aTask.itsPosition, game);
+        function<bool()> check = [&aPool, &aTask]() { return checkpoint(aPool, aTask); };
+        if (aTask.itsAnalysis) {
+            AnalysisConfig config = aTask.itsConfig;
+            config.itsCheckpoint = check;
+            aTask.itsInfo = analysePosition(game, config, AnalysisCallback(), &aTask.itsStop);
+        } else {
+            // le temps passé dans la file est décompté du budget
+            int64_t waited = now - aTask.itsSubmitted;
+            MoveBudget budget = aTask.itsBudget;
+            budget.itsSoft = max<int64_t>(0, budget.itsSoft - waited);
+            // machine surchargée : le temps qui reste est partagé avec les tâches en attente
+            if (budget.itsHard != INT64_MAX) {
+                int64_t shares = 1 + aPool.itsWaiting / int64_t(aPool.itsQueues.size());
+                budget.itsHard = max<int64_t>(0, budget.itsHard - waited) / shares;
+                budget.itsSoft = min(budget.itsSoft, budget.itsHard);
+            }
+            aTask.itsFound = searchMove(game, budget, aTask.itsTable, aTask.itsMove, &aTask.itsInfo, SEARCH_MAX_PLY - 1, check);
+        }
+        deleteBoard(game.itsBoard);
+    }
+    worker.itsDepth--;
+    worker.itsKey = key;
+    finishTask(aPool, aTask);
+}
+
+static void runWorker(SearchPool& aPool, int aIndex)
+{
+    SearchWorker worker = {&aPool, aIndex, 0, INT64_MAX};
+    currentWorker = &worker;
+    while (!aPool.itsStop) {
+        shared_ptr<SearchTask> task = takeTask(aPool, aIndex, INT64_MAX, false);
+        if (task != nullptr) {
+            runTask(aPool, *task);
+            continue;
+        }
+        unique_lock<mutex> lock(aPool.itsLock);
+        aPool.itsWake.wait(lock, [&aPool]() { return aPool.itsStop || aPool.itsWaiting > 0; });
+    }
+    currentWorker = nullptr;
+}
+
+void startSearchPool(SearchPool& aPool, int aThreads)
+{
+    int threads = (aThreads > 0) ? aThreads : int(max(1u, thread::hardware_concurrency()));
+    aPool.itsStop = false;
+    aPool.itsQueues.clear();
+    for (int i = 0; i < threads; ++i)
+        aPool.itsQueues.emplace_back(new SearchQueue());
+    for (int i = 0; i < threads; ++i)
+        aPool.itsWorkers.emplace_back(runWorker, ref(aPool), i);
+}
+
+void stopSearchPool(SearchPool& aPool)
+{
+    {
+        lock_guard<mutex> lock(aPool.itsLock);
+        aPool.itsStop = true;
+    }
+    aPool.itsWake.notify_all();
+    for (thread& worker : aPool.itsWorkers)
+        worker.join();
+    aPool.itsWorkers.clear();
+    // les tâches en attente sont rendues sans résultat
+    for (auto& queue : aPool.itsQueues)
+        for (auto& task : queue->itsTasks) {
+            task->itsStop = true;
+            finishTask(aPool, *task);
+        }
+    aPool.itsQueues.clear();
+    aPool.itsWaiting = 0;
+}
+
+shared_ptr<SearchTask> submitMoveSearch(SearchPool& aPool, const Game& aGame, const MoveBudget& aBudget, TranspositionTable* aTable)
+{
+    shared_ptr<SearchTask> task = make_shared<SearchTask>();
+    packPosition(aGame, task->itsPosition);
+    task->itsBudget = aBudget;
+    task->itsTable = aTable;
+    task->itsSubmitted = getClockTime();
+    // sans échéance, la recherche attend comme une analyse
+    task->itsKey = task->itsSubmitted + ((aBudget.itsHard != INT64_MAX) ? aBudget.itsHard : aPool.itsAging);
+    pushTask(aPool, task);
+    return task;
+}
+
+shared_ptr<SearchTask> submitAnalysis(SearchPool& aPool, const Game& aGame, const AnalysisConfig& aConfig)
+{
+    shared_ptr<SearchTask> task = make_shared<SearchTask>();
+    packPosition(aGame, task->itsPosition);
+    task->itsAnalysis = true;
+    task->itsConfig = aConfig;
+    task->itsSubmitted = getClockTime();
+    task->itsKey = task->itsSubmitted + aPool.itsAging;
+    pushTask(aPool, task);
+    return task;
+}
+
+void cancelSearchTask(SearchTask& aTask)
+{
+    aTask.itsStop = true;
+}
+
+void waitSearchTask(SearchPool& aPool, const SearchTask& aTask)
+{
+    unique_lock<mutex> lock(aPool.itsLock);
+    aPool.itsDone.wait(lock, [&aTask]() { return aTask.itsDone.load(); });
+}
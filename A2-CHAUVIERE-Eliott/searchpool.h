@@ -0,0 +1,169 @@
+/**
+ * @file searchpool.h
+ *
+ * @brief A fixed pool of worker threads sharing the CPU between the searches of many bots and
+ *        analyses, so that no bot misses the deadline of its move when the machine is oversubscribed.
+ *
+ * One thread per core, whatever the number of searches: hundreds of bots thinking at once do not
+ * become hundreds of threads fighting over the cores. Each worker has its own queue of tasks,
+ * ordered by their key (smaller first):
+ * - a bot search (`submitMoveSearch`) has the hard deadline of its move as key: the most urgent
+ *   move is searched first (earliest deadline first); without a hard deadline it is keyed as an
+ *   analysis,
+ * - an analysis (`submitAnalysis`) has no deadline; its key is its submission time plus
+ *   `itsAging`, so it gets older while it waits and ends up ahead of the new bot searches.
+ *
+ * A worker takes the task with the smallest key among all the queues, its own first on equal
+ * keys: a worker without work steals from the others.
+ *
+ * Preemption is cooperative: the search calls the pool every 1024 nodes (`itsCheckpoint`). If a
+ * waiting bot search is more urgent than the running task by more than `itsMargin`, the worker
+ * runs it there, on top of the running search, which resumes where it was once the urgent move is
+ * found. A running analysis counts as urgent as the time it got the worker plus `itsAging`, so a
+ * long analysis gives way to the bots of fast games; an analysis never preempts anything.
+ *
+ * A bot search that waited gets what is left of its budget when it starts, so its move is still
+ * given before its deadline; when tasks wait, that time is divided by the number of waiting tasks
+ * per worker plus one, so that the moves due at the same time share it instead of the last ones
+ * starting too late.
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef SEARCHPOOL_H
+#define SEARCHPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "typeDef.h"
+#include "clock.h"
+#include "search.h"
+#include "symmetry.h"
+
+/**
+ * @brief Default time an analysis waits before it goes ahead of new bot searches, in microseconds.
+ */
+const int64_t SEARCH_POOL_AGING = 2 * CLOCK_SECOND;
+
+/**
+ * @brief Default advance of the key of a waiting search needed to preempt a running one, in microseconds.
+ */
+const int64_t SEARCH_POOL_MARGIN = 2000;
+
+/**
+ * @brief Searches run on top of each other on a worker, at most.
+ */
+const int SEARCH_POOL_NESTING = 4;
+
+/**
+ * @struct SearchTask
+ * @brief A search given to a pool, and its result.
+ */
+struct SearchTask
+{
+    PackedBoard itsPosition;            /**< The position searched. */
+    bool itsAnalysis = false;           /**< Analysis (`itsConfig`) rather than a move of a bot (`itsBudget`). */
+    MoveBudget itsBudget;               /**< Deadlines of the move, counted from `itsSubmitted`. */
+    TranspositionTable* itsTable = nullptr; /**< Table of the bot, or null. */
+    AnalysisConfig itsConfig;           /**< Settings of the analysis. */
+    int64_t itsSubmitted = 0;           /**< Time of the submission (`getClockTime`). */
+    int64_t itsKey = 0;                 /**< Order of the task in the queues. */
+    atomic<bool> itsStop{false};        /**< Set to cancel the task. */
+    atomic<bool> itsDone{false};        /**< `true` once the result is ready. */
+    bool itsFound = false;              /**< A move was found (bot search). */
+    Move itsMove;                       /**< The move of the bot. */
+    AnalysisInfo itsInfo;               /**< Last completed depth. */
+    int64_t itsStarted = 0;             /**< Time a worker took the task. */
+    int64_t itsFinished = 0;            /**< Time the result was ready. */
+};
+
+/**
+ * @struct SearchQueue
+ * @brief Waiting tasks of a worker, most urgent first.
+ */
+struct SearchQueue
+{
+    mutex itsLock;                            /**< Protects the tasks. */
+    vector<shared_ptr<SearchTask>> itsTasks;  /**< A heap on the keys. */
+    atomic<int64_t> itsTop{INT64_MAX};        /**< Key of the most urgent task (`INT64_MAX` if empty), read without the lock. */
+};
+
+/**
+ * @struct SearchPool
+ * @brief The workers and their queues.
+ */
+struct SearchPool
+{
+    int64_t itsAging = SEARCH_POOL_AGING;     /**< Delay added to the key of an analysis. */
+    int64_t itsMargin = SEARCH_POOL_MARGIN;   /**< Advance needed to preempt a running task. */
+    vector<thread> itsWorkers;                /**< The worker threads. */
+    vector<unique_ptr<SearchQueue>> itsQueues; /**< One queue per worker. */
+    mutex itsLock;                            /**< Protects the sleep of the workers. */
+    condition_variable itsWake;               /**< Signalled when a task is submitted. */
+    condition_variable itsDone;               /**< Signalled when a task is finished. */
+    atomic<int> itsWaiting{0};                /**< Tasks in the queues. */
+    atomic<uint32_t> itsNext{0};              /**< Queue of the next submission from outside the pool. */
+    atomic<bool> itsStop{false};              /**< Set to stop the workers. */
+    atomic<uint64_t> itsPreemptions{0};       /**< Tasks run on top of another one. */
+    atomic<uint64_t> itsSteals{0};            /**< Tasks taken from the queue of another worker. */
+};
+
+/**
+ * @brief Starts the workers of a pool.
+ *
+ * @param aPool The pool (stopped); `itsAging` and `itsMargin` may be set beforehand.
+ * @param aThreads Number of workers (0 to use one per core).
+ */
+void startSearchPool(SearchPool& aPool, int aThreads = 0);
+
+/**
+ * @brief Stops the workers of a pool; the running tasks are cancelled and the waiting ones dropped.
+ *
+ * @param aPool The pool.
+ */
+void stopSearchPool(SearchPool& aPool);
+
+/**
+ * @brief Gives the move search of a bot to a pool.
+ *
+ * @param aPool The pool (started).
+ * @param aGame The position (it is copied).
+ * @param aBudget The deadlines of the move, counted from now (`allocateTime`).
+ * @param aTable Table of the bot, kept between its searches, or null; one search at a time may use it.
+ * @return The task, whose result is ready when `itsDone` is set (`waitSearchTask`).
+ */
+shared_ptr<SearchTask> submitMoveSearch(SearchPool& aPool, const Game& aGame, const MoveBudget& aBudget,
+                                        TranspositionTable* aTable = nullptr);
+
+/**
+ * @brief Gives an analysis to a pool.
+ *
+ * @param aPool The pool (started).
+ * @param aGame The position (it is copied).
+ * @param aConfig The settings; the analysis stops at their limits or when cancelled.
+ * @return The task.
+ */
+shared_ptr<SearchTask> submitAnalysis(SearchPool& aPool, const Game& aGame, const AnalysisConfig& aConfig);
+
+/**
+ * @brief Cancels a task: a running search stops within 1024 nodes, a waiting one finishes without searching.
+ *
+ * @param aTask The task.
+ */
+void cancelSearchTask(SearchTask& aTask);
+
+/**
+ * @brief Waits until the result of a task is ready.
+ *
+ * @param aPool The pool running the task.
+ * @param aTask The task.
+ */
+void waitSearchTask(SearchPool& aPool, const SearchTask& aTask);
+
+#endif // SEARCHPOOL_H
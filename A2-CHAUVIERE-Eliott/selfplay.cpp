@@ -0,0 +1,276 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+using namespace std;
+#include "selfplay.h"
+#include "evaluation.h"
+#include "functions.h"
+#include "movegen.h"
+#include "stats.h"
+
+static_assert(sizeof(TrainingSample) == 106, "the shard format needs 106-byte samples");
+
+/**
+ * Écriture des shards, partagée par les threads.
+ */
+struct ShardWriter
+{
+    mutex itsMutex;
+    ofstream itsStream;
+    string itsPrefix;
+    uint64_t itsLimit = 0;
+    uint64_t itsInShard = 0;
+    int itsShards = 0;
+    uint64_t itsSamples = 0;
+    bool itsFailed = false;
+};
+
+// met à jour le nombre d'échantillons de l'en-tête et ferme le shard courant
+static void closeShard(ShardWriter& aWriter)
+{
+    if (!aWriter.itsStream.is_open())
+        return;
+    aWriter.itsStream.seekp(sizeof(uint64_t));
+    aWriter.itsStream.write(reinterpret_cast<const char*>(&aWriter.itsInShard), sizeof(uint64_t));
+    aWriter.itsFailed = aWriter.itsFailed || !aWriter.itsStream;
+    aWriter.itsStream.close();
+}
+
+static void openShard(ShardWriter& aWriter)
+{
+    aWriter.itsStream.open(getShardName(aWriter.itsPrefix, aWriter.itsShards), ios::binary | ios::trunc);
+    uint64_t header[2] = {SAMPLE_MAGIC, 0};
+    aWriter.itsStream.write(reinterpret_cast<const char*>(header), sizeof(header));
+    aWriter.itsFailed = aWriter.itsFailed || !aWriter.itsStream;
+    aWriter.itsInShard = 0;
+    aWriter.itsShards++;
+}
+
+// écrit un tampon complet, en changeant de shard quand le courant est plein
+static void writeSamples(ShardWriter& aWriter, const vector<TrainingSample>& aSamples)
+{
+    lock_guard<mutex> lock(aWriter.itsMutex);
+    size_t done = 0;
+    while (done < aSamples.size()) {
+        if (!aWriter.itsStream.is_open() || aWriter.itsInShard == aWriter.itsLimit) {
+            closeShard(aWriter);
+            openShard(aWriter);
+        }
+        size_t count = size_t(min<uint64_t>(aSamples.size() - done, aWriter.itsLimit - aWriter.itsInShard));
+        aWriter.itsStream.write(reinterpret_cast<const char*>(aSamples.data() + done), streamsize(count * sizeof(TrainingSample)));
+        aWriter.itsInShard += count;
+        aWriter.itsSamples += count;
+        done += count;
+    }
+    aWriter.itsFailed = aWriter.itsFailed || !aWriter.itsStream;
+}
+
+/**
+ * Table de hachage sans verrou des positions déjà écrites (adressage ouvert, 0 = case libre).
+ */
+struct DedupTable
+{
+    unique_ptr<atomic<uint64_t>[]> itsKeys;
+    uint64_t itsMask = 0;
+};
+
+static const int DEDUP_PROBES = 16;
+
+// renvoie false si la position était déjà dans la table
+static bool insertKey(DedupTable& aTable, uint64_t aKey)
+{
+    if (aKey == 0)
+        aKey = 1;
+    uint64_t slot = aKey & aTable.itsMask;
+    for (int probe = 0; probe < DEDUP_PROBES; ++probe, slot = (slot + 1) & aTable.itsMask) {
+        uint64_t current = aTable.itsKeys[slot].load(memory_order_relaxed);
+        if (current == aKey)
+            return false;
+        if (current == 0) {
+            if (aTable.itsKeys[slot].compare_exchange_strong(current, aKey, memory_order_relaxed))
+                return true;
+            if (current == aKey)
+                return false;
+        }
+    }
+    return true; // table saturée autour de cette clé : la position est gardée
+}
+
+/**
+ * État partagé pendant une génération.
+ */
+struct SelfPlayShared
+{
+    const SelfPlayConfig* itsConfig;
+    ShardWriter itsWriter;
+    DedupTable itsDedup;
+    atomic<uint64_t> itsNextGame;
+    atomic<uint64_t> itsDuplicates;
+    SearchStats itsStats; // compteurs des threads, fusionnés à leur fin
+};
+
+// coup de la politique : meilleure évaluation à un coup, ou coup au hasard
+static Move chooseMove(Game& aGame, const Evaluator& aEvaluator, const Move* aMoves, int aCount, bool aRandom, mt19937_64& aRandomEngine)
+{
+    if (aRandom)
+        return aMoves[aRandomEngine() % uint64_t(aCount)];
+    Player* mover = aGame.itsCurrentPlayer;
+    int best = 0;
+    int bestScore = INT32_MIN;
+    for (int i = 0; i < aCount; ++i) {
+        MoveUndo undo;
+        makeMove(aGame, aMoves[i], undo);
+        STATS_ADD(itsNodes, 1);
+        int score;
+        if (isGameFinished(aGame))
+            score = (whoWon(aGame) == mover) ? INT32_MAX : INT32_MIN + 1;
+        else {
+            STATS_TIME(itsEvalTime);
+            score = -evaluate(aEvaluator, aGame);
+        }
+        unmakeMove(aGame, aMoves[i], undo);
+        if (score > bestScore) {
+            bestScore = score;
+            best = i;
+        }
+    }
+    return aMoves[best];
+}
+
+static void selfPlayWorker(SelfPlayShared& aShared, int aIndex)
+{
+    const SelfPlayConfig& config = *aShared.itsConfig;
+    mt19937_64 randomEngine(config.itsSeed * 0x9E3779B97F4A7C15ULL + uint64_t(aIndex));
+    vector<TrainingSample> buffer;
+    buffer.reserve(SELFPLAY_BUFFER);
+    vector<TrainingSample> positions; // positions de la partie en cours, en attendant son résultat
+    Move moves[MAX_MOVES];
+
+    Game game;
+    game.itsBoard.itsSize = config.itsSize;
+    createBoard(game.itsBoard);
+    Evaluator evaluator;
+    resetThreadStats();
+    STATS_SET(itsTiming, config.itsTiming);
+
+    while (aShared.itsNextGame.fetch_add(1) < config.itsGames) {
+        initializeBoard(game.itsBoard);
+        game.itsCurrentPlayer = &game.itsPlayer1;
+        attachEvaluator(evaluator, game);
+        int openingPlies = config.itsRandomPlies + int(randomEngine() % uint64_t(config.itsRandomPlies + 1));
+        positions.clear();
+
+        for (int ply = 0; ply < config.itsMaxPlies && !isGameFinished(game); ++ply) {
+            TrainingSample sample;
+            memset(&sample, 0, sizeof(sample));
+            packPosition(game, sample.itsPosition);
+            sample.itsPly = uint16_t(ply);
+            if (config.itsScores)
+                sample.itsScore = int16_t(max(-32000, min(32000, evaluate(evaluator, game))));
+            if (insertKey(aShared.itsDedup, getCanonicalKey(game)))
+                positions.push_back(sample);
+            else
+                aShared.itsDuplicates++;
+
+            int count;
+            {
+                STATS_TIME(itsMoveGenTime);
+                count = generateMoves(game, moves);
+            }
+            if (count == 0)
+                break;
+            bool random = ply < openingPlies || int(randomEngine() % 100) < config.itsRandomPercent;
+            Move move = chooseMove(game, evaluator, moves, count, random, randomEngine);
+            movePiece(game, move);
+            capturePieces(game, move);
+            switchCurrentPlayer(game);
+        }
+
+        Player* winner = whoWon(game);
+        int8_t result = (winner == nullptr) ? 0 : (winner->itsRole == ATTACK) ? 1 : -1;
+        for (TrainingSample& sample : positions) {
+            sample.itsResult = result;
+            buffer.push_back(sample);
+            if (buffer.size() == SELFPLAY_BUFFER) {
+                writeSamples(aShared.itsWriter, buffer);
+                buffer.clear();
+            }
+        }
+        detachEvaluator(evaluator, game);
+    }
+    if (!buffer.empty())
+        writeSamples(aShared.itsWriter, buffer);
+    deleteBoard(game.itsBoard);
+    {
+        lock_guard<mutex> lock(aShared.itsWriter.itsMutex);
+        mergeSearchStats(aShared.itsStats, threadStats);
+    }
+    STATS_SET(itsTiming, false);
+}
+
+string getShardName(const string& aPrefix, int aNumber)
+{
+    return aPrefix + "_" + to_string(aNumber) + ".hsmp";
+}
+
+bool generateSelfPlay(const SelfPlayConfig& aConfig, SelfPlayReport& aReport)
+{
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    int threads = (aConfig.itsThreads > 0) ? aConfig.itsThreads : int(max(1u, thread::hardware_concurrency()));
+
+    SelfPlayShared shared;
+    shared.itsConfig = &aConfig;
+    shared.itsWriter.itsPrefix = aConfig.itsPrefix;
+    shared.itsWriter.itsLimit = max<uint64_t>(1, aConfig.itsSamplesPerShard);
+    shared.itsDedup.itsKeys.reset(new atomic<uint64_t>[size_t(1) << aConfig.itsDedupBits]);
+    shared.itsDedup.itsMask = (uint64_t(1) << aConfig.itsDedupBits) - 1;
+    for (uint64_t i = 0; i <= shared.itsDedup.itsMask; ++i)
+        shared.itsDedup.itsKeys[i].store(0, memory_order_relaxed);
+    shared.itsNextGame = 0;
+    shared.itsDuplicates = 0;
+
+    vector<thread> workers;
+    for (int i = 0; i < threads; ++i)
+        workers.push_back(thread(selfPlayWorker, ref(shared), i));
+    for (thread& worker : workers)
+        worker.join();
+    closeShard(shared.itsWriter);
+
+    aReport.itsGames = aConfig.itsGames;
+    aReport.itsSamples = shared.itsWriter.itsSamples;
+    aReport.itsDuplicates = shared.itsDuplicates;
+    aReport.itsShards = shared.itsWriter.itsShards;
+    aReport.itsSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    aReport.itsStats = shared.itsStats;
+    aReport.itsStats.itsSeconds = aReport.itsSeconds;
+    return !shared.itsWriter.itsFailed;
+}
+
+bool openSampleShard(SampleShard& aShard, const string& aPath)
+{
+    if (!openMappedFile(aShard.itsFile, aPath))
+        return false;
+    const uint64_t* header = reinterpret_cast<const uint64_t*>(aShard.itsFile.itsData);
+    if (aShard.itsFile.itsSize < 2 * sizeof(uint64_t) || header[0] != SAMPLE_MAGIC
+        || aShard.itsFile.itsSize != 2 * sizeof(uint64_t) + header[1] * sizeof(TrainingSample)) {
+        closeMappedFile(aShard.itsFile);
+        return false;
+    }
+    aShard.itsSamples = reinterpret_cast<const TrainingSample*>(header + 2);
+    aShard.itsCount = header[1];
+    return true;
+}
+
+void closeSampleShard(SampleShard& aShard)
+{
+    closeMappedFile(aShard.itsFile);
+    aShard.itsSamples = nullptr;
+    aShard.itsCount = 0;
+}
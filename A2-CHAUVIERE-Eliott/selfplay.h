@@ -0,0 +1,132 @@
+/**
+ * @file selfplay.h
+ *
+ * @brief Generation of training positions by self-play.
+ *
+ * Worker threads play games from `initializeBoard`: a few random plies first, so that games
+ * differ, then moves chosen by the hand-crafted evaluation searched one ply deep (with some
+ * random moves). Every position of a game is labeled with the result of the game (`whoWon`)
+ * and, optionally, its static evaluation.
+ *
+ * Samples are fixed-size records written to shard files: a 16-byte header (`SAMPLE_MAGIC` and
+ * the number of samples) followed by the `TrainingSample` records. Each thread fills its own
+ * buffer and hands it to the shard writer in one sequential write when it is full. Positions
+ * already written (same canonical key, so symmetric variants too) are dropped through a
+ * lock-free hash table shared by the threads.
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef SELFPLAY_H
+#define SELFPLAY_H
+
+#include <cstdint>
+#include "typeDef.h"
+#include "mappedfile.h"
+#include "stats.h"
+#include "symmetry.h"
+
+/**
+ * @brief First 8 bytes of a shard file.
+ */
+const uint64_t SAMPLE_MAGIC = 0x31504D5354414648ULL; // "HFATSMP1"
+
+/**
+ * @brief Number of samples buffered by a thread before they are written.
+ */
+const int SELFPLAY_BUFFER = 8192;
+
+/**
+ * @struct TrainingSample
+ * @brief One labeled position (106 bytes).
+ */
+struct TrainingSample
+{
+    PackedBoard itsPosition; /**< The position, with the side to move. */
+    int16_t itsScore;        /**< Static evaluation for the side to move (0 if scores are not recorded). */
+    uint16_t itsPly;         /**< Number of plies played before the position. */
+    int8_t itsResult;        /**< 1 if the attack won the game, -1 if the defense won, 0 if it was stopped. */
+    uint8_t itsUnused[3];    /**< Padding, always 0. */
+};
+
+/**
+ * @struct SelfPlayConfig
+ * @brief Settings of a generation.
+ */
+struct SelfPlayConfig
+{
+    uint64_t itsGames = 1000;                   /**< Number of games to play. */
+    int itsThreads = 0;                         /**< Number of threads (0 to use one per core). */
+    BoardSize itsSize = LITTLE;                 /**< Board size. */
+    int itsRandomPlies = 8;                     /**< Random plies at the start of each game (plus up to as many more). */
+    int itsMaxPlies = 300;                      /**< Games longer than this are stopped (result 0). */
+    int itsRandomPercent = 10;                  /**< Share of random moves after the opening, in percent. */
+    bool itsScores = true;                      /**< Record the static evaluation of each position. */
+    uint64_t itsSamplesPerShard = 1 << 20;      /**< Largest number of samples of a shard file. */
+    int itsDedupBits = 22;                      /**< Size of the deduplication table (2^bits keys). */
+    uint64_t itsSeed = 1;                       /**< Seed of the random moves. */
+    string itsPrefix = "selfplay";              /**< Shards are named `<prefix>_<n>.hsmp`. */
+    bool itsTiming = false;                     /**< Times move generation and evaluation (`SelfPlayReport::itsStats`); slower. */
+};
+
+/**
+ * @struct SelfPlayReport
+ * @brief Statistics of a generation.
+ */
+struct SelfPlayReport
+{
+    uint64_t itsGames = 0;      /**< Games played. */
+    uint64_t itsSamples = 0;    /**< Samples written. */
+    uint64_t itsDuplicates = 0; /**< Positions dropped because they were already written. */
+    int itsShards = 0;          /**< Shard files written. */
+    double itsSeconds = 0;      /**< Wall time. */
+    SearchStats itsStats;       /**< Counters of the threads (a node is a position evaluated to choose a move). */
+};
+
+/**
+ * @struct SampleShard
+ * @brief A shard file mapped in memory.
+ */
+struct SampleShard
+{
+    MappedFile itsFile;                         /**< The mapped file. */
+    const TrainingSample* itsSamples = nullptr; /**< The samples. */
+    uint64_t itsCount = 0;                      /**< Number of samples. */
+};
+
+/**
+ * @brief Returns the file name of a shard.
+ *
+ * @param aPrefix The prefix of the shards.
+ * @param aNumber The number of the shard (from 0).
+ * @return The file name, e.g. "selfplay_3.hsmp".
+ */
+string getShardName(const string& aPrefix, int aNumber);
+
+/**
+ * @brief Plays games in parallel and writes their positions to shard files.
+ *
+ * @param aConfig The settings.
+ * @param aReport Receives the statistics.
+ * @return `false` if a shard could not be written.
+ */
+bool generateSelfPlay(const SelfPlayConfig& aConfig, SelfPlayReport& aReport);
+
+/**
+ * @brief Maps a shard file in memory.
+ *
+ * @param aShard The shard to open.
+ * @param aPath The path of the shard file.
+ * @return `true` if the file is a valid shard.
+ */
+bool openSampleShard(SampleShard& aShard, const string& aPath);
+
+/**
+ * @brief Unmaps a shard file.
+ *
+ * @param aShard The shard to close.
+ */
+void closeSampleShard(SampleShard& aShard);
+
+#endif // SELFPLAY_H
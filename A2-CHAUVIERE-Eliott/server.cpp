@@ -0,0 +1,632 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+using namespace std;
+#include "server.h"
+#include "functions.h"
+#include "notation.h"
+#include "symmetry.h"
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+static const char* const ROLE_NAMES[2] = {"attaque", "defense"};
+
+static ServerLoop& getOwner(ServerLoop& aLoop, uint32_t aGame)
+{
+    vector<unique_ptr<ServerLoop>>& loops = aLoop.itsServer->itsLoops;
+    return *loops[(aGame - 1) % loops.size()];
+}
+
+static void watchConnection(ServerLoop& aLoop, ServerConnection& aConnection, int aOperation)
+{
+    epoll_event event = {};
+    event.events = EPOLLIN | EPOLLRDHUP | (aConnection.itsWaitingOutput ? uint32_t(EPOLLOUT) : 0u);
+    event.data.fd = aConnection.itsFd;
+    epoll_ctl(aLoop.itsEpoll, aOperation, aConnection.itsFd, &event);
+}
+
+// écrit ce que la socket accepte, les lignes propres puis les trames partagées sans les copier ;
+// le reste attend EPOLLOUT
+static void flushConnection(ServerLoop& aLoop, ServerConnection& aConnection)
+{
+    for (;;) {
+        iovec parts[SERVER_WRITE_PARTS];
+        int count = 0;
+        if (!aConnection.itsOutput.empty())
+            parts[count++] = {(void*)aConnection.itsOutput.data(), aConnection.itsOutput.size()};
+        size_t offset = aConnection.itsFrameOffset;
+        for (auto frame = aConnection.itsFrames.begin(); frame != aConnection.itsFrames.end() && count < SERVER_WRITE_PARTS; ++frame) {
+            parts[count++] = {(void*)((*frame)->data() + offset), (*frame)->size() - offset};
+            offset = 0;
+        }
+        if (count == 0)
+            break;
+        msghdr message = {};
+        message.msg_iov = parts;
+        message.msg_iovlen = size_t(count);
+        ssize_t written = sendmsg(aConnection.itsFd, &message, MSG_NOSIGNAL);
+        if (written <= 0)
+            break;
+        size_t left = size_t(written);
+        size_t own = min(left, aConnection.itsOutput.size());
+        aConnection.itsOutput.erase(0, own);
+        left -= own;
+        while (left > 0) {
+            size_t rest = aConnection.itsFrames.front()->size() - aConnection.itsFrameOffset;
+            if (left < rest) {
+                aConnection.itsFrameOffset += left;
+                break;
+            }
+            left -= rest;
+            aConnection.itsFrames.pop_front();
+            aConnection.itsFrameOffset = 0;
+        }
+    }
+    bool waiting = !aConnection.itsOutput.empty() || !aConnection.itsFrames.empty();
+    if (waiting != aConnection.itsWaitingOutput) {
+        aConnection.itsWaitingOutput = waiting;
+        watchConnection(aLoop, aConnection, EPOLL_CTL_MOD);
+    }
+}
+
+static void sendLine(ServerLoop& aLoop, int aFd, const string& aLine)
+{
+    auto found = aLoop.itsConnections.find(aFd);
+    if (found == aLoop.itsConnections.end())
+        return;
+    ServerConnection& connection = found->second;
+    connection.itsOutput += aLine;
+    connection.itsOutput += '\n';
+    flushConnection(aLoop, connection);
+}
+
+// trame ajoutée à la file d'un spectateur ; un spectateur trop en retard repart de la dernière image clé
+static void sendFrame(ServerLoop& aLoop, int aFd, const BroadcastFrame& aFrame, const BroadcastChannel* aChannel)
+{
+    auto found = aLoop.itsConnections.find(aFd);
+    if (found == aLoop.itsConnections.end())
+        return;
+    ServerConnection& connection = found->second;
+    if (aChannel != nullptr && connection.itsFrames.size() >= SERVER_MAX_FRAMES) {
+        BroadcastFrame current = (connection.itsFrameOffset > 0) ? connection.itsFrames.front() : BroadcastFrame();
+        connection.itsFrames.clear();
+        if (current)
+            connection.itsFrames.push_back(current);
+        for (const BroadcastFrame& frame : getCatchUpFrames(*aChannel))
+            connection.itsFrames.push_back(frame);
+    }
+    else
+        connection.itsFrames.push_back(aFrame);
+    flushConnection(aLoop, connection);
+}
+
+// la partie est retirée de la boucle avant tout envoi : un client qui lit la dernière ligne la voit
+// déjà terminée ; les spectateurs reçoivent cette ligne et sont détachés
+static void dropGame(ServerLoop& aLoop, uint32_t aId, ServerGame& aGame, const string& aLine)
+{
+    vector<int> spectators;
+    spectators.swap(aGame.itsSpectators);
+    detachBroadcast(aGame.itsChannel, *aGame.itsGame);
+    releaseGame(aLoop.itsServer->itsPool, aGame.itsHandle);
+    aLoop.itsGames.erase(aId);
+    aLoop.itsActiveGames--;
+    BroadcastFrame frame = make_shared<const string>(aLine + "\n");
+    for (int fd : spectators) {
+        auto found = aLoop.itsConnections.find(fd);
+        if (found == aLoop.itsConnections.end())
+            continue;
+        found->second.itsWatching = 0;
+        sendFrame(aLoop, fd, frame, nullptr);
+    }
+}
+
+// fin de partie : résultat aux deux joueurs, qui sont détachés de la partie
+static void endGame(ServerLoop& aLoop, uint32_t aId, ServerGame& aGame, PlayerRole aWinner, bool aAbandon)
+{
+    const Player& winner = (aWinner == ATTACK) ? aGame.itsGame->itsPlayer1 : aGame.itsGame->itsPlayer2;
+    string line = string("end ") + ROLE_NAMES[aWinner] + " " + winner.itsName + " " + to_string(aGame.itsPlies)
+                  + (aAbandon ? " abandon" : "");
+    int fds[2] = {aGame.itsFds[0], aGame.itsFds[1]};
+    if (aLoop.itsServer->itsJournaled)
+        logGameEnd(aLoop.itsServer->itsJournal, aId);
+    dropGame(aLoop, aId, aGame, line);
+    for (int role = 0; role < 2; ++role) {
+        auto found = aLoop.itsConnections.find(fds[role]);
+        if (found == aLoop.itsConnections.end())
+            continue;
+        found->second.itsGame = 0;
+        found->second.itsRole = -1;
+        sendLine(aLoop, fds[role], line);
+    }
+}
+
+// le joueur quitte sa partie : l'adversaire gagne, ou la partie sans adversaire disparaît ;
+// une partie reprise attend le retour du joueur déconnecté
+static void leaveGame(ServerLoop& aLoop, ServerConnection& aConnection)
+{
+    auto found = aLoop.itsGames.find(aConnection.itsGame);
+    if (found == aLoop.itsGames.end())
+        return;
+    ServerGame& game = found->second;
+    PlayerRole opponent = (aConnection.itsRole == ATTACK) ? DEFENSE : ATTACK;
+    bool resigned = game.itsFds[aConnection.itsRole] == aConnection.itsFd;
+    if (game.itsFds[opponent] >= 0 || (game.itsResumed && resigned))
+        endGame(aLoop, found->first, game, opponent, true);
+    else if (game.itsResumed) {
+        aConnection.itsGame = 0;
+        aConnection.itsRole = -1;
+    }
+    else {
+        dropGame(aLoop, found->first, game, "closed " + to_string(found->first));
+        aConnection.itsGame = 0;
+        aConnection.itsRole = -1;
+    }
+}
+
+static void unwatchGame(ServerLoop& aLoop, ServerConnection& aConnection)
+{
+    auto found = aLoop.itsGames.find(aConnection.itsWatching);
+    aConnection.itsWatching = 0;
+    if (found == aLoop.itsGames.end())
+        return;
+    vector<int>& spectators = found->second.itsSpectators;
+    spectators.erase(find(spectators.begin(), spectators.end(), aConnection.itsFd));
+}
+
+static void closeConnection(ServerLoop& aLoop, int aFd)
+{
+    auto found = aLoop.itsConnections.find(aFd);
+    if (found == aLoop.itsConnections.end())
+        return;
+    // la place est libérée d'abord : le résultat ne va qu'à l'adversaire
+    auto game = aLoop.itsGames.find(found->second.itsGame);
+    if (game != aLoop.itsGames.end())
+        game->second.itsFds[found->second.itsRole] = -1;
+    unwatchGame(aLoop, found->second);
+    leaveGame(aLoop, found->second);
+    epoll_ctl(aLoop.itsEpoll, EPOLL_CTL_DEL, aFd, nullptr);
+    close(aFd);
+    aLoop.itsConnections.erase(aFd);
+}
+
+static void createGame(ServerLoop& aLoop, ServerConnection& aConnection, istringstream& aWords)
+{
+    int size = 0;
+    string name;
+    if (!(aWords >> size >> name) || (size != LITTLE && size != BIG)) {
+        sendLine(aLoop, aConnection.itsFd, "error usage: create <11|13> <name>");
+        return;
+    }
+    // partie prise dans la réserve du serveur : aucune allocation de plateau
+    GameHandle handle;
+    if (!acquireGame(aLoop.itsServer->itsPool, BoardSize(size), handle)) {
+        sendLine(aLoop, aConnection.itsFd, "error server full");
+        return;
+    }
+    uint32_t id = uint32_t(aLoop.itsCreated++ * aLoop.itsServer->itsLoops.size() + aLoop.itsIndex + 1);
+    ServerGame& game = aLoop.itsGames[id];
+    game.itsHandle = handle;
+    game.itsGame = getPooledGame(aLoop.itsServer->itsPool, handle);
+    game.itsGame->itsPlayer1.itsName = name;
+    attachBroadcast(game.itsChannel, *game.itsGame);
+    game.itsFds[ATTACK] = aConnection.itsFd;
+    aConnection.itsGame = id;
+    aConnection.itsRole = ATTACK;
+    aLoop.itsActiveGames++;
+    sendLine(aLoop, aConnection.itsFd, "created " + to_string(id));
+}
+
+static void joinGame(ServerLoop& aLoop, ServerConnection& aConnection, uint32_t aId, istringstream& aWords)
+{
+    string name;
+    auto found = aLoop.itsGames.find(aId);
+    if (!(aWords >> name) || found == aLoop.itsGames.end()) {
+        sendLine(aLoop, aConnection.itsFd, "error no game to join");
+        return;
+    }
+    ServerGame& game = found->second;
+    // partie reprise : chacun retrouve la place de son nom
+    int role = DEFENSE;
+    if (game.itsResumed)
+        role = (name == game.itsGame->itsPlayer1.itsName) ? ATTACK : (name == game.itsGame->itsPlayer2.itsName) ? DEFENSE : -1;
+    if (role < 0 || game.itsFds[role] >= 0) {
+        sendLine(aLoop, aConnection.itsFd, "error no game to join");
+        return;
+    }
+    if (!game.itsResumed)
+        game.itsGame->itsPlayer2.itsName = name;
+    game.itsFds[role] = aConnection.itsFd;
+    aConnection.itsGame = aId;
+    aConnection.itsRole = role;
+    string id = to_string(aId);
+    if (game.itsFds[1 - role] < 0) {
+        sendLine(aLoop, aConnection.itsFd, "resumed " + id + " " + ROLE_NAMES[role]);
+        return;
+    }
+    sendLine(aLoop, game.itsFds[ATTACK], "start " + id + " attaque " + game.itsGame->itsPlayer2.itsName);
+    sendLine(aLoop, game.itsFds[DEFENSE], "start " + id + " defense " + game.itsGame->itsPlayer1.itsName);
+    if (game.itsResumed) {
+        char position[POSITION_STRING_SIZE];
+        formatPosition(*game.itsGame, position, POSITION_STRING_SIZE);
+        sendLine(aLoop, game.itsFds[ATTACK], string("position ") + position);
+        sendLine(aLoop, game.itsFds[DEFENSE], string("position ") + position);
+    }
+    else if (aLoop.itsServer->itsJournaled)
+        logGameStart(aLoop.itsServer->itsJournal, aId, *game.itsGame);
+}
+
+static void playMove(ServerLoop& aLoop, ServerConnection& aConnection, istringstream& aWords)
+{
+    auto found = aLoop.itsGames.find(aConnection.itsGame);
+    string text;
+    if (found == aLoop.itsGames.end() || found->second.itsFds[ATTACK] < 0 || found->second.itsFds[DEFENSE] < 0) {
+        sendLine(aLoop, aConnection.itsFd, "error no game in progress");
+        return;
+    }
+    ServerGame& game = found->second;
+    Game& position = *game.itsGame;
+    Move move;
+    const char* end;
+    if (position.itsCurrentPlayer->itsRole != aConnection.itsRole) {
+        sendLine(aLoop, aConnection.itsFd, "error not your turn");
+        return;
+    }
+    if (!(aWords >> text) || !parseMove(text.c_str(), position.itsBoard, move, &end) || *end != '\0'
+        || !isValidMovement(position, move)) {
+        sendLine(aLoop, aConnection.itsFd, "error illegal move");
+        return;
+    }
+    // mêmes règles que la boucle de itsGame
+    movePiece(position, move);
+    capturePieces(position, move);
+    switchCurrentPlayer(position);
+    game.itsPlies++;
+    aLoop.itsMoves++;
+    // journal : le coup part au prochain commit, sans attendre le disque
+    if (aLoop.itsServer->itsJournaled)
+        logMove(aLoop.itsServer->itsJournal, found->first, move);
+    sendLine(aLoop, game.itsFds[ATTACK], "moved " + text);
+    sendLine(aLoop, game.itsFds[DEFENSE], "moved " + text);
+    BroadcastFrame frame = publishMove(game.itsChannel, position, move);
+    for (int fd : game.itsSpectators)
+        sendFrame(aLoop, fd, frame, &game.itsChannel);
+    if (isGameFinished(position))
+        endGame(aLoop, found->first, game, whoWon(position)->itsRole, false);
+}
+
+static void watchGame(ServerLoop& aLoop, ServerConnection& aConnection, uint32_t aId)
+{
+    auto found = aLoop.itsGames.find(aId);
+    if (found == aLoop.itsGames.end()) {
+        sendLine(aLoop, aConnection.itsFd, "error no game to watch");
+        return;
+    }
+    ServerGame& game = found->second;
+    game.itsSpectators.push_back(aConnection.itsFd);
+    aConnection.itsWatching = aId;
+    sendLine(aLoop, aConnection.itsFd, "watching " + to_string(aId));
+    // dernière image clé et coups suivants : trames partagées, rien n'est recopié
+    for (const BroadcastFrame& frame : getCatchUpFrames(game.itsChannel))
+        aConnection.itsFrames.push_back(frame);
+    flushConnection(aLoop, aConnection);
+}
+
+static void handOff(ServerLoop& aLoop, ServerLoop& aOwner, ServerConnection& aConnection);
+
+// traite les lignes reçues ; renvoie false si la connexion a quitté la boucle
+static bool handleInput(ServerLoop& aLoop, ServerConnection& aConnection)
+{
+    size_t start = 0;
+    size_t end;
+    while ((end = aConnection.itsInput.find('\n', start)) != string::npos) {
+        istringstream words(aConnection.itsInput.substr(start, end - start));
+        string command;
+        words >> command;
+        if (command == "join" || command == "watch") {
+            uint32_t id = 0;
+            words >> id;
+            if (aConnection.itsGame != 0 || aConnection.itsWatching != 0)
+                sendLine(aLoop, aConnection.itsFd, "error already in a game");
+            else if (id != 0 && &getOwner(aLoop, id) != &aLoop) {
+                // la partie appartient à une autre boucle : la connexion la rejoint, ligne comprise
+                aConnection.itsInput.erase(0, start);
+                handOff(aLoop, getOwner(aLoop, id), aConnection);
+                return false;
+            }
+            else if (command == "join")
+                joinGame(aLoop, aConnection, id, words);
+            else
+                watchGame(aLoop, aConnection, id);
+        }
+        else if (command == "create") {
+            if (aConnection.itsGame != 0 || aConnection.itsWatching != 0)
+                sendLine(aLoop, aConnection.itsFd, "error already in a game");
+            else
+                createGame(aLoop, aConnection, words);
+        }
+        else if (command == "move")
+            playMove(aLoop, aConnection, words);
+        else if (command == "resign")
+            leaveGame(aLoop, aConnection);
+        else if (command == "unwatch") {
+            if (aConnection.itsWatching == 0)
+                sendLine(aLoop, aConnection.itsFd, "error not watching");
+            else
+                unwatchGame(aLoop, aConnection);
+        }
+        else if (!command.empty())
+            sendLine(aLoop, aConnection.itsFd, "error unknown command " + command);
+        start = end + 1;
+    }
+    aConnection.itsInput.erase(0, start);
+    return true;
+}
+
+static void handOff(ServerLoop& aLoop, ServerLoop& aOwner, ServerConnection& aConnection)
+{
+    int fd = aConnection.itsFd;
+    epoll_ctl(aLoop.itsEpoll, EPOLL_CTL_DEL, fd, nullptr);
+    {
+        lock_guard<mutex> lock(aOwner.itsHandoffLock);
+        aOwner.itsHandoffs.push_back(move(aConnection));
+    }
+    aLoop.itsConnections.erase(fd);
+    uint64_t one = 1;
+    ssize_t written = write(aOwner.itsWake, &one, sizeof(one));
+    (void)written;
+}
+
+static void acceptConnections(ServerLoop& aLoop)
+{
+    int fd;
+    while ((fd = accept4(aLoop.itsListen, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        ServerConnection& connection = aLoop.itsConnections[fd];
+        connection.itsFd = fd;
+        watchConnection(aLoop, connection, EPOLL_CTL_ADD);
+    }
+}
+
+static void receiveHandoffs(ServerLoop& aLoop)
+{
+    uint64_t count;
+    ssize_t got = read(aLoop.itsWake, &count, sizeof(count));
+    (void)got;
+    vector<ServerConnection> handoffs;
+    {
+        lock_guard<mutex> lock(aLoop.itsHandoffLock);
+        handoffs.swap(aLoop.itsHandoffs);
+    }
+    for (ServerConnection& handoff : handoffs) {
+        int fd = handoff.itsFd;
+        ServerConnection& connection = aLoop.itsConnections[fd] = move(handoff);
+        watchConnection(aLoop, connection, EPOLL_CTL_ADD);
+        if (handleInput(aLoop, connection) && (!connection.itsOutput.empty() || !connection.itsFrames.empty()))
+            flushConnection(aLoop, connection);
+    }
+}
+
+static void receive(ServerLoop& aLoop, int aFd, uint32_t aEvents)
+{
+    auto found = aLoop.itsConnections.find(aFd);
+    if (found == aLoop.itsConnections.end())
+        return;
+    ServerConnection& connection = found->second;
+    if (aEvents & EPOLLOUT)
+        flushConnection(aLoop, connection);
+    if (!(aEvents & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)))
+        return;
+
+    char buffer[4096];
+    bool closed = false;
+    for (;;) {
+        ssize_t got = recv(aFd, buffer, sizeof(buffer), 0);
+        if (got > 0)
+            connection.itsInput.append(buffer, size_t(got));
+        else {
+            closed = (got == 0 || (errno != EAGAIN && errno != EWOULDBLOCK));
+            break;
+        }
+    }
+    if (!handleInput(aLoop, connection))
+        return;
+    if (closed || connection.itsInput.size() > SERVER_MAX_LINE)
+        closeConnection(aLoop, aFd);
+}
+
+static void runLoop(ServerLoop& aLoop)
+{
+    epoll_event events[SERVER_EVENTS];
+    while (!aLoop.itsServer->itsStop.load()) {
+        int count = epoll_wait(aLoop.itsEpoll, events, SERVER_EVENTS, -1);
+        for (int i = 0; i < count; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == aLoop.itsListen)
+                acceptConnections(aLoop);
+            else if (fd == aLoop.itsWake)
+                receiveHandoffs(aLoop);
+            else
+                receive(aLoop, fd, events[i].events);
+        }
+    }
+}
+
+static int openListener(int aPort)
+{
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return -1;
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(uint16_t(aPort));
+    if (bind(fd, (sockaddr*)&address, sizeof(address)) < 0 || listen(fd, SOMAXCONN) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void addWatch(int aEpoll, int aFd)
+{
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = aFd;
+    epoll_ctl(aEpoll, EPOLL_CTL_ADD, aFd, &event);
+}
+
+// parties du journal remises sur la boucle propriétaire de leur numéro, en attente des joueurs
+static bool resumeGames(Server& aServer, const string& aPath)
+{
+    map<uint32_t, JournalGame> games;
+    bool recovered = recoverJournal(aPath, games);
+    uint32_t loops = uint32_t(aServer.itsLoops.size());
+    for (auto& entry : games) {
+        ServerLoop& loop = *aServer.itsLoops[(entry.first - 1) % loops];
+        Game& recovered = entry.second.itsGame;
+        GameHandle handle;
+        if (!acquireGame(aServer.itsPool, recovered.itsBoard.itsSize, handle))
+            break;
+        ServerGame& game = loop.itsGames[entry.first];
+        game.itsHandle = handle;
+        game.itsGame = getPooledGame(aServer.itsPool, handle);
+        PackedBoard packed;
+        packPosition(recovered, packed);
+        unpackPosition(packed, *game.itsGame);
+        game.itsGame->itsPlayer1.itsName = recovered.itsPlayer1.itsName;
+        game.itsGame->itsPlayer2.itsName = recovered.itsPlayer2.itsName;
+        game.itsPlies = entry.second.itsPlies;
+        game.itsResumed = true;
+        game.itsChannel.itsPly = game.itsPlies;
+        attachBroadcast(game.itsChannel, *game.itsGame);
+        loop.itsCreated = max(loop.itsCreated, (entry.first - 1) / loops + 1);
+        loop.itsActiveGames++;
+    }
+    releaseJournalGames(games);
+    return recovered && openJournal(aServer.itsJournal, aPath);
+}
+
+bool startServer(Server& aServer, const ServerConfig& aConfig)
+{
+    // deux sockets par partie : autant de fichiers ouverts que le système le permet
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    int loops = (aConfig.itsThreads > 0) ? aConfig.itsThreads : max(1, int(thread::hardware_concurrency()));
+    aServer.itsStop = false;
+    aServer.itsPort = aConfig.itsPort;
+    for (int i = 0; i < loops; ++i) {
+        unique_ptr<ServerLoop> loop(new ServerLoop);
+        loop->itsIndex = i;
+        loop->itsServer = &aServer;
+        loop->itsListen = openListener(aServer.itsPort);
+        loop->itsEpoll = epoll_create1(EPOLL_CLOEXEC);
+        loop->itsWake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        bool opened = loop->itsListen >= 0 && loop->itsEpoll >= 0 && loop->itsWake >= 0;
+        aServer.itsLoops.push_back(move(loop));
+        if (!opened) {
+            stopServer(aServer);
+            return false;
+        }
+        if (i == 0) {
+            // port choisi par le système : les autres boucles écoutent le même
+            sockaddr_in address = {};
+            socklen_t length = sizeof(address);
+            getsockname(aServer.itsLoops[0]->itsListen, (sockaddr*)&address, &length);
+            aServer.itsPort = ntohs(address.sin_port);
+        }
+        addWatch(aServer.itsLoops[i]->itsEpoll, aServer.itsLoops[i]->itsListen);
+        addWatch(aServer.itsLoops[i]->itsEpoll, aServer.itsLoops[i]->itsWake);
+    }
+    if (!aConfig.itsJournal.empty()) {
+        if (!resumeGames(aServer, aConfig.itsJournal)) {
+            stopServer(aServer);
+            return false;
+        }
+        aServer.itsJournaled = true;
+    }
+    for (unique_ptr<ServerLoop>& loop : aServer.itsLoops)
+        aServer.itsThreads.emplace_back(runLoop, ref(*loop));
+    return true;
+}
+
+void stopServer(Server& aServer)
+{
+    aServer.itsStop = true;
+    for (unique_ptr<ServerLoop>& loop : aServer.itsLoops) {
+        uint64_t one = 1;
+        if (loop->itsWake >= 0) {
+            ssize_t written = write(loop->itsWake, &one, sizeof(one));
+            (void)written;
+        }
+    }
+    for (thread& loopThread : aServer.itsThreads)
+        loopThread.join();
+    aServer.itsThreads.clear();
+    // les parties en cours restent dans le journal
+    if (aServer.itsJournaled)
+        closeJournal(aServer.itsJournal);
+    aServer.itsJournaled = false;
+
+    for (unique_ptr<ServerLoop>& loop : aServer.itsLoops) {
+        for (auto& connection : loop->itsConnections)
+            close(connection.first);
+        for (ServerConnection& handoff : loop->itsHandoffs)
+            close(handoff.itsFd);
+        for (int fd : {loop->itsListen, loop->itsEpoll, loop->itsWake})
+            if (fd >= 0)
+                close(fd);
+    }
+    aServer.itsLoops.clear();
+    destroyGamePool(aServer.itsPool);
+}
+
+#else
+
+bool startServer(Server&, const ServerConfig&)
+{
+    return false; // epoll n'existe que sous Linux
+}
+
+void stopServer(Server& aServer)
+{
+    aServer.itsLoops.clear();
+    destroyGamePool(aServer.itsPool);
+}
+
+#endif
+
+uint32_t getServerGames(const Server& aServer)
+{
+    uint32_t games = 0;
+    for (const unique_ptr<ServerLoop>& loop : aServer.itsLoops)
+        games += loop->itsActiveGames;
+    return games;
+}
+
+uint64_t getServerMoves(const Server& aServer)
+{
+    uint64_t moves = 0;
+    for (const unique_ptr<ServerLoop>& loop : aServer.itsLoops)
+        moves += loop->itsMoves;
+    return moves;
+}
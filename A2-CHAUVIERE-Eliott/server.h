@@ -0,0 +1,191 @@
+/**
+ * @file server.h
+ *
+ * @brief TCP server hosting many live games in one process (Linux only, on epoll).
+ *
+ * The server runs a few event loops, one thread each. Every loop has its own epoll instance and
+ * its own listening socket on the same port (`SO_REUSEPORT`, the kernel spreads the new
+ * connections), and owns a share of the games: a game is only touched by the loop that created
+ * it, so the games need no lock. When a client joins a game owned by another loop, its
+ * connection is handed to that loop (through a queue and an `eventfd` wake-up), so both players
+ * of a game always live on the same loop. The games come from a `GamePool` shared by the loops.
+ *
+ * Line protocol (one command per line, words separated by spaces):
+ * - `create <11|13> <name>`: creates a game, the client plays the attacker; answer `created <id>`,
+ * - `join <id> <name>`: joins a game as the defender; both players get `start <id> <role> <opponent>`,
+ * - `move <m>`: plays a move in compact notation ("a4-c4"), checked with `isValidMovement` and
+ *   played with `movePiece` and `capturePieces`; both players get `moved <m>`,
+ * - `resign`: gives the game up (as does closing the connection),
+ * - `watch <id>`: follows a game as a spectator; answer `watching <id>`, then the frames of the game
+ *   (see `broadcast.h`): the last keyframe, the plies since, then every new ply, and the `end` line.
+ *   A spectator too far behind is brought back to the last keyframe.
+ * - `unwatch`: stops following the game.
+ *
+ * With a journal (`ServerConfig::itsJournal`), the games are logged from their start to their end
+ * (see `journal.h`) and a restarted server gets back the games in progress. Their players come
+ * back with `join <id> <name>`, which gives each one the seat of its name: the first gets
+ * `resumed <id> <role>`, and when both are there they get `start` then `position <position string>`.
+ * A player disconnected from a resumed game frees its seat, the game waits for it.
+ *
+ * The end of a game is sent to both players as `end <role> <name> <plies>` (the winner, from
+ * `whoWon`), followed by ` abandon` when the loser gave up; the spectators get the same line, or
+ * `closed <id>` when a game nobody joined is dropped. A refused command gets `error <reason>`.
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "typeDef.h"
+#include "broadcast.h"
+#include "journal.h"
+#include "pool.h"
+
+/**
+ * @brief Events read from epoll at once by a loop.
+ */
+const int SERVER_EVENTS = 256;
+
+/**
+ * @brief Longest command line accepted; a longer line closes the connection.
+ */
+const size_t SERVER_MAX_LINE = 512;
+
+/**
+ * @brief Buffers given to one `sendmsg` call.
+ */
+const int SERVER_WRITE_PARTS = 64;
+
+/**
+ * @brief Frames waiting for a spectator beyond which it restarts from the last keyframe.
+ */
+const size_t SERVER_MAX_FRAMES = 256;
+
+/**
+ * @struct ServerConfig
+ * @brief Settings of a server.
+ */
+struct ServerConfig
+{
+    int itsPort = 7777;   /**< TCP port (0 for a free port chosen by the system). */
+    int itsThreads = 0;   /**< Event loops (0 for the number of hardware threads). */
+    string itsJournal;    /**< Path of the journal of the games (empty for none). */
+};
+
+/**
+ * @struct ServerConnection
+ * @brief A client of a loop.
+ */
+struct ServerConnection
+{
+    int itsFd = -1;            /**< The socket. */
+    string itsInput;           /**< Received bytes not yet handled. */
+    string itsOutput;          /**< Bytes waiting for the socket to accept them. */
+    deque<BroadcastFrame> itsFrames; /**< Shared frames waiting, sent after `itsOutput`. */
+    size_t itsFrameOffset = 0; /**< Bytes of the first frame already sent. */
+    bool itsWaitingOutput = false; /**< The socket is watched for writing. */
+    uint32_t itsGame = 0;      /**< Game played (0 if none). */
+    int itsRole = -1;          /**< Role in the game (`PlayerRole`), or -1. */
+    uint32_t itsWatching = 0;  /**< Game followed as a spectator (0 if none). */
+};
+
+/**
+ * @struct ServerGame
+ * @brief A game hosted by a loop.
+ */
+struct ServerGame
+{
+    GameHandle itsHandle;        /**< The game in the pool of the server. */
+    Game* itsGame = nullptr;     /**< The position, and the names of the players. */
+    int itsFds[2] = {-1, -1};    /**< Socket of each role (-1 while the seat is free). */
+    int itsPlies = 0;            /**< Moves played. */
+    BroadcastChannel itsChannel; /**< Frames for the spectators. */
+    vector<int> itsSpectators;   /**< Sockets of the spectators. */
+    bool itsResumed = false;     /**< The game was recovered from the journal at start. */
+};
+
+struct Server;
+
+/**
+ * @struct ServerLoop
+ * @brief An event loop with the connections and games it owns.
+ */
+struct ServerLoop
+{
+    int itsIndex = 0;         /**< Position in `Server::itsLoops`; a game belongs to loop `(id - 1) % loops`. */
+    int itsEpoll = -1;        /**< The epoll instance. */
+    int itsListen = -1;       /**< The listening socket of the loop. */
+    int itsWake = -1;         /**< eventfd written to wake the loop (handoffs, stop). */
+    Server* itsServer = nullptr; /**< The server. */
+    unordered_map<int, ServerConnection> itsConnections; /**< Clients, by socket. */
+    unordered_map<uint32_t, ServerGame> itsGames;         /**< Games, by id (elements never move). */
+    uint32_t itsCreated = 0;  /**< Games created by the loop (gives the next id). */
+    mutex itsHandoffLock;     /**< Protects `itsHandoffs`. */
+    vector<ServerConnection> itsHandoffs; /**< Connections handed over by other loops. */
+    atomic<uint64_t> itsMoves{0};        /**< Moves played on the loop. */
+    atomic<uint32_t> itsActiveGames{0};  /**< Games in progress on the loop. */
+};
+
+/**
+ * @struct Server
+ * @brief A running server.
+ */
+struct Server
+{
+    vector<unique_ptr<ServerLoop>> itsLoops; /**< The event loops. */
+    vector<thread> itsThreads;               /**< One thread per loop. */
+    atomic<bool> itsStop{false};             /**< Set to stop the loops. */
+    int itsPort = 0;                         /**< Port actually listened on. */
+    GamePool itsPool;                        /**< The games, shared by the loops. */
+    Journal itsJournal;                      /**< Log of the games, used when `itsJournaled` is set. */
+    bool itsJournaled = false;               /**< The games are logged. */
+};
+
+/**
+ * @brief Opens the listening sockets and starts the event loops.
+ *
+ * The limit of open files of the process is raised to its maximum, since each game holds two sockets.
+ * With a journal, the games it holds are put back on their loops, waiting for their players.
+ *
+ * @param aServer The server (not running).
+ * @param aConfig The settings.
+ * @return `false` if the port cannot be listened on, the journal cannot be opened, or on a system without epoll.
+ */
+bool startServer(Server& aServer, const ServerConfig& aConfig);
+
+/**
+ * @brief Stops the loops, closes every connection and frees the games.
+ *
+ * The games in progress are not ended: they stay in the journal for the next start.
+ *
+ * @param aServer The server.
+ */
+void stopServer(Server& aServer);
+
+/**
+ * @brief Counts the games in progress.
+ *
+ * @param aServer The server.
+ * @return The number of games created and not finished.
+ */
+uint32_t getServerGames(const Server& aServer);
+
+/**
+ * @brief Counts the moves played.
+ *
+ * @param aServer The server.
+ * @return The number of moves played since the start.
+ */
+uint64_t getServerMoves(const Server& aServer);
+
+#endif // SERVER_H
@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <sstream>
+using namespace std;
+#include "stats.h"
+
+void resetThreadStats()
+{
+#ifndef HNEFATAFL_NO_STATS
+    threadStats = SearchStats();
+#endif
+}
+
+void mergeSearchStats(SearchStats& aTotal, const SearchStats& aStats)
+{
+    aTotal.itsNodes += aStats.itsNodes;
+    aTotal.itsQuiescenceNodes += aStats.itsQuiescenceNodes;
+    aTotal.itsCutoffs += aStats.itsCutoffs;
+    aTotal.itsFirstMoveCutoffs += aStats.itsFirstMoveCutoffs;
+    aTotal.itsTableProbes += aStats.itsTableProbes;
+    aTotal.itsTableHits += aStats.itsTableHits;
+    aTotal.itsTableCollisions += aStats.itsTableCollisions;
+    for (int d = 0; d < STATS_MAX_DEPTH; ++d)
+        aTotal.itsDepthNodes[d] += aStats.itsDepthNodes[d];
+    aTotal.itsMaxDepth = max(aTotal.itsMaxDepth, aStats.itsMaxDepth);
+    aTotal.itsMoveGenTime += aStats.itsMoveGenTime;
+    aTotal.itsCaptureTime += aStats.itsCaptureTime;
+    aTotal.itsEvalTime += aStats.itsEvalTime;
+    aTotal.itsSeconds = max(aTotal.itsSeconds, aStats.itsSeconds);
+    aTotal.itsTiming = aTotal.itsTiming || aStats.itsTiming;
+}
+
+double getBranchingFactor(const SearchStats& aStats, int aDepth)
+{
+    if (aDepth < 2 || aDepth >= STATS_MAX_DEPTH || aStats.itsDepthNodes[aDepth - 1] == 0)
+        return 0;
+    return double(aStats.itsDepthNodes[aDepth]) / double(aStats.itsDepthNodes[aDepth - 1]);
+}
+
+static double getRatio(uint64_t aPart, uint64_t aTotal)
+{
+    return (aTotal > 0) ? double(aPart) / double(aTotal) : 0;
+}
+
+string formatStatsJson(const SearchStats& aStats)
+{
+    ostringstream out;
+    out << "{\"nodes\":" << aStats.itsNodes << ",\"qnodes\":" << aStats.itsQuiescenceNodes
+        << ",\"nps\":" << uint64_t((aStats.itsSeconds > 0) ? double(aStats.itsNodes) / aStats.itsSeconds : 0)
+        << ",\"firstCutoff\":" << getRatio(aStats.itsFirstMoveCutoffs, aStats.itsCutoffs)
+        << ",\"ttProbes\":" << aStats.itsTableProbes << ",\"ttHits\":" << aStats.itsTableHits
+        << ",\"ttCollisions\":" << aStats.itsTableCollisions << ",\"ebf\":[";
+    for (int d = 1; d <= min(aStats.itsMaxDepth, STATS_MAX_DEPTH - 1); ++d)
+        out << (d > 1 ? "," : "") << getBranchingFactor(aStats, d);
+    out << "],\"moveGenMs\":" << aStats.itsMoveGenTime / 1e6 << ",\"capturesMs\":" << aStats.itsCaptureTime / 1e6
+        << ",\"evalMs\":" << aStats.itsEvalTime / 1e6 << ",\"time\":" << aStats.itsSeconds << "}";
+    return out.str();
+}
+
+string formatStatsSummary(const SearchStats& aStats)
+{
+    ostringstream out;
+    out << "Noeuds : " << aStats.itsNodes << " (dont " << aStats.itsQuiescenceNodes << " en repos) en " << aStats.itsSeconds << " s, "
+        << uint64_t((aStats.itsSeconds > 0) ? double(aStats.itsNodes) / aStats.itsSeconds : 0) << " noeuds/s" << endl;
+    out << "Coupures : " << aStats.itsCutoffs << ", " << 100 * getRatio(aStats.itsFirstMoveCutoffs, aStats.itsCutoffs)
+        << " % au premier coup" << endl;
+    out << "Table : " << aStats.itsTableProbes << " sondages, " << 100 * getRatio(aStats.itsTableHits, aStats.itsTableProbes)
+        << " % trouves, " << 100 * getRatio(aStats.itsTableCollisions, aStats.itsTableProbes) << " % collisions" << endl;
+    out << "Facteur de branchement :";
+    for (int d = 2; d <= min(aStats.itsMaxDepth, STATS_MAX_DEPTH - 1); ++d)
+        out << " " << d << ":" << getBranchingFactor(aStats, d);
+    out << endl;
+    if (aStats.itsTiming)
+        out << "Temps : generation " << aStats.itsMoveGenTime / 1e6 << " ms, captures " << aStats.itsCaptureTime / 1e6
+            << " ms, evaluation " << aStats.itsEvalTime / 1e6 << " ms" << endl;
+    else
+        out << "Temps : non mesure" << endl;
+    return out.str();
+}
@@ -0,0 +1,135 @@
+/**
+ * @file stats.h
+ *
+ * @brief Counters of the search: nodes, cutoffs, transposition table, branching factor and
+ *        time spent in move generation, captures and evaluation.
+ *
+ * Every thread fills its own `SearchStats` block (`threadStats`) through the `STATS_*` macros,
+ * without any synchronisation; the blocks are merged with `mergeSearchStats` once the threads
+ * are done. The counters always run; the timers read the clock twice per timed call, so they only
+ * run on threads that asked for them (`itsTiming`, set from `AnalysisConfig::itsTiming` or
+ * `SelfPlayConfig::itsTiming`). Building with `HNEFATAFL_NO_STATS` defined turns the macros into
+ * nothing, so the counters cost nothing in that build (the blocks then stay at 0).
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <chrono>
+#include <cstdint>
+#include "typeDef.h"
+
+/**
+ * @brief Deepest iteration whose nodes are counted.
+ */
+const int STATS_MAX_DEPTH = 64;
+
+/**
+ * @struct SearchStats
+ * @brief Counters of one or more threads.
+ */
+struct SearchStats
+{
+    uint64_t itsNodes = 0;              /**< Nodes searched (quiescence included). */
+    uint64_t itsQuiescenceNodes = 0;    /**< Nodes of the quiescence search. */
+    uint64_t itsCutoffs = 0;            /**< Beta cutoffs. */
+    uint64_t itsFirstMoveCutoffs = 0;   /**< Beta cutoffs made by the first move searched. */
+    uint64_t itsTableProbes = 0;        /**< Transposition table probes. */
+    uint64_t itsTableHits = 0;          /**< Probes finding the position. */
+    uint64_t itsTableCollisions = 0;    /**< Probes finding another position in the slot. */
+    uint64_t itsDepthNodes[STATS_MAX_DEPTH] = {}; /**< Nodes of each iteration of iterative deepening. */
+    int itsMaxDepth = 0;                /**< Deepest completed iteration. */
+    int64_t itsMoveGenTime = 0;         /**< Time in `generateMoves`, in nanoseconds. */
+    int64_t itsCaptureTime = 0;         /**< Time in `capturePieces`, in nanoseconds. */
+    int64_t itsEvalTime = 0;            /**< Time in the evaluation, in nanoseconds. */
+    double itsSeconds = 0;              /**< Wall time of the search. */
+    bool itsTiming = false;             /**< The timers run (only while a search or a self-play that asked for them runs). */
+};
+
+/**
+ * @brief Counters of the calling thread.
+ */
+inline thread_local SearchStats threadStats;
+
+/**
+ * @struct StatsTimer
+ * @brief Adds the time of its scope to a counter.
+ */
+struct StatsTimer
+{
+    int64_t* itsCounter;                          /**< The counter, in nanoseconds (null if the timers do not run). */
+    chrono::steady_clock::time_point itsStart;    /**< Start of the scope. */
+
+    StatsTimer(int64_t& aCounter) : itsCounter(threadStats.itsTiming ? &aCounter : nullptr)
+    {
+        if (itsCounter != nullptr)
+            itsStart = chrono::steady_clock::now();
+    }
+    ~StatsTimer()
+    {
+        if (itsCounter != nullptr)
+            *itsCounter += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - itsStart).count();
+    }
+};
+
+#ifdef HNEFATAFL_NO_STATS
+#define STATS_ADD(aField, aCount) ((void)0)
+#define STATS_SET(aField, aValue) ((void)0)
+#define STATS_COPY(aTarget) ((void)0)
+#define STATS_TIME(aField) ((void)0)
+#else
+/** Adds `aCount` to a counter of the calling thread. */
+#define STATS_ADD(aField, aCount) (threadStats.aField += (aCount))
+/** Sets a field of the counters of the calling thread. */
+#define STATS_SET(aField, aValue) (threadStats.aField = (aValue))
+/** Copies the counters of the calling thread into `aTarget`. */
+#define STATS_COPY(aTarget) ((aTarget) = threadStats)
+/** Adds the time until the end of the enclosing scope to a timer of the calling thread. */
+#define STATS_TIME(aField) StatsTimer statsTimer(threadStats.aField)
+#endif
+
+/**
+ * @brief Resets the counters of the calling thread.
+ */
+void resetThreadStats();
+
+/**
+ * @brief Adds counters to others (the deepest iteration and the wall time are the largest ones).
+ *
+ * @param aTotal The counters receiving the sum.
+ * @param aStats The counters to add.
+ */
+void mergeSearchStats(SearchStats& aTotal, const SearchStats& aStats);
+
+/**
+ * @brief Returns the effective branching factor of an iteration (its nodes over those of the previous one).
+ *
+ * @param aStats The counters.
+ * @param aDepth The iteration (from 2).
+ * @return The branching factor, or 0 if unknown.
+ */
+double getBranchingFactor(const SearchStats& aStats, int aDepth);
+
+/**
+ * @brief Writes counters as one line of JSON (without the end of line).
+ *
+ * Example: `{"nodes":51234,"qnodes":30112,"nps":124354,"firstCutoff":0.912,"ttProbes":20000,"ttHits":6100,
+ * "ttCollisions":120,"ebf":[0,5.3,4.1],"moveGenMs":12.5,"capturesMs":20.1,"evalMs":140.2,"time":0.412}`.
+ *
+ * @param aStats The counters.
+ * @return The JSON text.
+ */
+string formatStatsJson(const SearchStats& aStats);
+
+/**
+ * @brief Writes counters as a few lines of text for a human reader.
+ *
+ * @param aStats The counters.
+ * @return The text, ending with an end of line.
+ */
+string formatStatsSummary(const SearchStats& aStats);
+
+#endif // STATS_H
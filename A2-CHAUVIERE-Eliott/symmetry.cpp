@@ -0,0 +1,193 @@
+#include "symmetry.h"
+#include "functions.h"
+#include "hash.h"
+
+// inverse l'ordre des 16 bits d'un masque
+static uint16_t reverseBits(uint16_t aMask)
+{
+    aMask = uint16_t(((aMask >> 1) & 0x5555) | ((aMask & 0x5555) << 1));
+    aMask = uint16_t(((aMask >> 2) & 0x3333) | ((aMask & 0x3333) << 2));
+    aMask = uint16_t(((aMask >> 4) & 0x0F0F) | ((aMask & 0x0F0F) << 4));
+    return uint16_t((aMask >> 8) | (aMask << 8));
+}
+
+// transposition d'une matrice de 16x16 bits par échanges de blocs (8x8, 4x4, 2x2 puis 1x1)
+static void transposeRows(uint16_t* aRows)
+{
+    static const uint16_t MASKS[4] = {0x00FF, 0x0F0F, 0x3333, 0x5555};
+    int step = 0;
+    for (int j = 8; j != 0; j >>= 1, ++step) {
+        for (int k = 0; k < 16; ++k) {
+            if (k & j)
+                continue;
+            uint16_t t = uint16_t(((aRows[k] >> j) ^ aRows[k + j]) & MASKS[step]);
+            aRows[k] ^= uint16_t(t << j);
+            aRows[k + j] ^= t;
+        }
+    }
+}
+
+// applique une symétrie à un plan (un masque par ligne)
+static void transformPlane(const uint16_t* aRows, int aTransform, int aSize, uint16_t* aResult)
+{
+    uint16_t rows[16];
+    for (int r = 0; r < 16; ++r)
+        rows[r] = aRows[r];
+    if (aTransform & 4)
+        transposeRows(rows);
+    for (int r = 0; r < aSize; ++r) {
+        uint16_t row = rows[(aTransform & 2) ? aSize - 1 - r : r];
+        aResult[r] = (aTransform & 1) ? uint16_t(reverseBits(row) >> (16 - aSize)) : row;
+    }
+    for (int r = aSize; r < 16; ++r)
+        aResult[r] = 0;
+}
+
+void packPosition(const Game& aGame, PackedBoard& aPacked)
+{
+    const Board& aBoard = aGame.itsBoard;
+    aPacked.itsSize = uint8_t(aBoard.itsSize);
+    aPacked.itsSide = uint8_t(aGame.itsCurrentPlayer->itsRole);
+    for (int i = 0; i < 16; ++i) {
+        aPacked.itsSwords[i] = 0;
+        aPacked.itsShields[i] = 0;
+        aPacked.itsKing[i] = 0;
+        if (i >= aBoard.itsSize)
+            continue;
+        for (int j = 0; j < aBoard.itsSize; ++j) {
+            switch (aBoard.itsCells[i][j].itsPieceType) {
+            case SWORD:
+                aPacked.itsSwords[i] |= uint16_t(1 << j);
+                break;
+            case SHIELD:
+                aPacked.itsShields[i] |= uint16_t(1 << j);
+                break;
+            case KING:
+                aPacked.itsKing[i] |= uint16_t(1 << j);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+}
+
+bool unpackPosition(const PackedBoard& aPacked, Game& aGame)
+{
+    Board& aBoard = aGame.itsBoard;
+    if (aBoard.itsCells == nullptr) {
+        aBoard.itsSize = BoardSize(aPacked.itsSize);
+        if (!createBoard(aBoard))
+            return false;
+    }
+    else if (aBoard.itsSize != aPacked.itsSize)
+        return false;
+
+    initializeBoard(aBoard); // types de cases
+    for (int i = 0; i < aBoard.itsSize; ++i) {
+        for (int j = 0; j < aBoard.itsSize; ++j) {
+            uint16_t bit = uint16_t(1 << j);
+            if (aPacked.itsSwords[i] & bit)
+                aBoard.itsCells[i][j].itsPieceType = SWORD;
+            else if (aPacked.itsShields[i] & bit)
+                aBoard.itsCells[i][j].itsPieceType = SHIELD;
+            else if (aPacked.itsKing[i] & bit)
+                aBoard.itsCells[i][j].itsPieceType = KING;
+            else
+                aBoard.itsCells[i][j].itsPieceType = NONE;
+        }
+    }
+    aGame.itsCurrentPlayer = (aGame.itsPlayer1.itsRole == aPacked.itsSide) ? &aGame.itsPlayer1 : &aGame.itsPlayer2;
+    return true;
+}
+
+void transformPacked(const PackedBoard& aPacked, int aTransform, PackedBoard& aResult)
+{
+    transformPlane(aPacked.itsSwords, aTransform, aPacked.itsSize, aResult.itsSwords);
+    transformPlane(aPacked.itsShields, aTransform, aPacked.itsSize, aResult.itsShields);
+    transformPlane(aPacked.itsKing, aTransform, aPacked.itsSize, aResult.itsKing);
+    aResult.itsSize = aPacked.itsSize;
+    aResult.itsSide = aPacked.itsSide;
+}
+
+// ordre total sur les positions de même taille : plans comparés ligne par ligne
+static int comparePacked(const PackedBoard& a, const PackedBoard& b)
+{
+    const uint16_t* planesA[3] = {a.itsKing, a.itsSwords, a.itsShields};
+    const uint16_t* planesB[3] = {b.itsKing, b.itsSwords, b.itsShields};
+    for (int p = 0; p < 3; ++p) {
+        for (int r = 0; r < a.itsSize; ++r) {
+            if (planesA[p][r] != planesB[p][r])
+                return (planesA[p][r] < planesB[p][r]) ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+int canonicalizePacked(const PackedBoard& aPacked, PackedBoard& aCanonical)
+{
+    aCanonical = aPacked;
+    int best = 0;
+    PackedBoard variant;
+    for (int t = 1; t < SYMMETRY_COUNT; ++t) {
+        transformPacked(aPacked, t, variant);
+        if (comparePacked(variant, aCanonical) < 0) {
+            aCanonical = variant;
+            best = t;
+        }
+    }
+    return best;
+}
+
+uint64_t hashPacked(const PackedBoard& aPacked)
+{
+    uint64_t hash = getBoardKey(BoardSize(aPacked.itsSize));
+    if (aPacked.itsSide == DEFENSE)
+        hash ^= getSideKey();
+    const uint16_t* planes[3] = {aPacked.itsShields, aPacked.itsSwords, aPacked.itsKing};
+    const PieceType pieces[3] = {SHIELD, SWORD, KING};
+    for (int p = 0; p < 3; ++p) {
+        for (int r = 0; r < aPacked.itsSize; ++r) {
+            for (unsigned mask = planes[p][r]; mask != 0; mask &= mask - 1)
+                hash ^= getPieceKey(pieces[p], {r, __builtin_ctz(mask)});
+        }
+    }
+    return hash;
+}
+
+uint64_t getCanonicalKey(const Game& aGame, int* aTransform)
+{
+    PackedBoard packed;
+    PackedBoard canonical;
+    packPosition(aGame, packed);
+    int transform = canonicalizePacked(packed, canonical);
+    if (aTransform != nullptr)
+        *aTransform = transform;
+    return hashPacked(canonical);
+}
+
+Position transformPosition(const Position& aPos, int aTransform, int aSize)
+{
+    Position pos = aPos;
+    if (aTransform & 4)
+        pos = {aPos.itsCol, aPos.itsRow};
+    if (aTransform & 2)
+        pos.itsRow = aSize - 1 - pos.itsRow;
+    if (aTransform & 1)
+        pos.itsCol = aSize - 1 - pos.itsCol;
+    return pos;
+}
+
+Move transformMove(const Move& aMove, int aTransform, int aSize)
+{
+    return {transformPosition(aMove.itsStartPosition, aTransform, aSize), transformPosition(aMove.itsEndPosition, aTransform, aSize)};
+}
+
+int getInverseTransform(int aTransform)
+{
+    // sans transposition chaque symétrie est sa propre inverse ;
+    // avec transposition, les inversions de lignes et de colonnes s'échangent
+    if (aTransform & 4)
+        return 4 | ((aTransform & 1) << 1) | ((aTransform & 2) >> 1);
+    return aTransform;
+}
@@ -0,0 +1,128 @@
+/**
+ * @file symmetry.h
+ *
+ * @brief Packed boards and the 8 symmetries of the board.
+ *
+ * Both starting positions, the fortress corners and the castle are unchanged by the 4 rotations
+ * and 4 reflections of the square, so a position and its 7 symmetric variants play the same way.
+ * A position is packed into one 16-bit mask per row and per piece type; the symmetries are then
+ * computed on whole rows (bit reversal, row reversal and a 16x16 bit-matrix transposition),
+ * without visiting the cells one by one.
+ *
+ * A transform is a number from 0 to 7: bit 2 transposes the board (row and column are exchanged),
+ * then bit 1 reverses the rows and bit 0 reverses the columns.
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include <cstdint>
+#include "typeDef.h"
+
+/**
+ * @brief Number of symmetries of the board.
+ */
+const int SYMMETRY_COUNT = 8;
+
+/**
+ * @struct PackedBoard
+ * @brief A position stored as bit masks: bit `c` of row `r` is set if the cell (r, c) holds the piece.
+ */
+struct PackedBoard
+{
+    uint16_t itsSwords[16];  /**< Swords, one mask per row (rows beyond the board size stay 0). */
+    uint16_t itsShields[16]; /**< Shields, one mask per row. */
+    uint16_t itsKing[16];    /**< King, one mask per row. */
+    uint8_t itsSize;         /**< Board size (11 or 13). */
+    uint8_t itsSide;         /**< Role of the player to move (a `PlayerRole`). */
+};
+
+/**
+ * @brief Packs the position of a game.
+ *
+ * @param aGame The game to pack.
+ * @param aPacked Receives the packed position.
+ */
+void packPosition(const Game& aGame, PackedBoard& aPacked);
+
+/**
+ * @brief Writes a packed position into a game.
+ *
+ * The board is created if needed (it must otherwise have the right size); the cell types
+ * are those of `initializeBoard` and the current player is the one holding the role to move.
+ *
+ * @param aPacked The packed position.
+ * @param aGame The game receiving the position.
+ * @return `false` if the board exists with another size.
+ */
+bool unpackPosition(const PackedBoard& aPacked, Game& aGame);
+
+/**
+ * @brief Applies a symmetry to a packed position.
+ *
+ * @param aPacked The position to transform.
+ * @param aTransform The symmetry (0 to 7).
+ * @param aResult Receives the transformed position (may not be `aPacked`).
+ */
+void transformPacked(const PackedBoard& aPacked, int aTransform, PackedBoard& aResult);
+
+/**
+ * @brief Finds the canonical variant of a position: the smallest of its 8 symmetric variants.
+ *
+ * @param aPacked The position.
+ * @param aCanonical Receives the canonical variant.
+ * @return The transform that maps `aPacked` to `aCanonical`.
+ */
+int canonicalizePacked(const PackedBoard& aPacked, PackedBoard& aCanonical);
+
+/**
+ * @brief Computes the hash of a packed position; equal to `hashPosition` of the same position.
+ *
+ * @param aPacked The packed position.
+ * @return The 64-bit Zobrist hash.
+ */
+uint64_t hashPacked(const PackedBoard& aPacked);
+
+/**
+ * @brief Computes the hash of the canonical variant of a position.
+ *
+ * Two positions that are symmetric to each other have the same canonical key.
+ *
+ * @param aGame The game.
+ * @param aTransform If not null, receives the transform mapping the game to its canonical variant.
+ * @return The hash of the canonical variant.
+ */
+uint64_t getCanonicalKey(const Game& aGame, int* aTransform = nullptr);
+
+/**
+ * @brief Applies a symmetry to a cell.
+ *
+ * @param aPos The cell.
+ * @param aTransform The symmetry (0 to 7).
+ * @param aSize The board size.
+ * @return The transformed cell.
+ */
+Position transformPosition(const Position& aPos, int aTransform, int aSize);
+
+/**
+ * @brief Applies a symmetry to a move.
+ *
+ * @param aMove The move.
+ * @param aTransform The symmetry (0 to 7).
+ * @param aSize The board size.
+ * @return The transformed move.
+ */
+Move transformMove(const Move& aMove, int aTransform, int aSize);
+
+/**
+ * @brief Returns the symmetry that cancels a given symmetry.
+ *
+ * @param aTransform The symmetry (0 to 7).
+ * @return The inverse symmetry.
+ */
+int getInverseTransform(int aTransform);
+
+#endif // SYMMETRY_H
@@ -0,0 +1,576 @@
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+using namespace std;
+#include "tablebase.h"
+#include "functions.h"
+#include "movegen.h"
+
+static const int CELLS = LITTLE * LITTLE;
+static const uint64_t TABLEBASE_MAGIC = 0x3130425441464648ULL; // "HFATB01"
+
+// valeurs stockées : 0 inconnue (nulle), 255 position impossible,
+// impair = gain en (v-1)/2 coups, pair = perte en (v-2)/2 coups
+static const uint8_t VALUE_UNKNOWN = 0;
+static const uint8_t VALUE_INVALID = 255;
+static const int MAX_DISTANCE = 126;
+
+/**
+ * En-tête d'un fichier de table.
+ */
+struct TablebaseHeader
+{
+    uint64_t itsMagic;
+    uint32_t itsShields;
+    uint32_t itsSwords;
+    uint64_t itsEntries;
+    uint32_t itsBlock;
+    uint32_t itsMaxDistance;
+};
+
+/**
+ * Position décrite par ses listes de cases (indice ligne*11+colonne, croissants).
+ */
+struct PieceSet
+{
+    int itsSide;                          // PlayerRole du joueur actif
+    int itsKing;
+    int itsShields[TABLEBASE_MAX_SHIELDS];
+    int itsSwords[TABLEBASE_MAX_SWORDS];
+    int itsShieldCount;
+    int itsSwordCount;
+};
+
+struct Binomials
+{
+    uint64_t itsValues[CELLS + 1][TABLEBASE_MAX_SWORDS + 1];
+};
+
+static Binomials createBinomials()
+{
+    Binomials table;
+    for (int n = 0; n <= CELLS; ++n)
+    {
+        table.itsValues[n][0] = 1;
+        for (int k = 1; k <= TABLEBASE_MAX_SWORDS; ++k)
+            table.itsValues[n][k] = (n == 0) ? 0 : table.itsValues[n - 1][k - 1] + table.itsValues[n - 1][k];
+    }
+    return table;
+}
+
+static const Binomials BINOMIALS = createBinomials();
+
+static uint64_t binomial(int n, int k)
+{
+    return BINOMIALS.itsValues[n][k];
+}
+
+static uint64_t countEntries(int aShields, int aSwords)
+{
+    return 2 * uint64_t(CELLS) * binomial(CELLS, aShields) * binomial(CELLS, aSwords);
+}
+
+// rang d'une combinaison de cases croissantes (système combinatoire)
+static uint64_t rankCells(const int* aCells, int aCount)
+{
+    uint64_t rank = 0;
+    for (int i = 0; i < aCount; ++i)
+        rank += binomial(aCells[i], i + 1);
+    return rank;
+}
+
+static void unrankCells(uint64_t aRank, int aCount, int* aCells)
+{
+    int cell = CELLS - 1;
+    for (int i = aCount - 1; i >= 0; --i)
+    {
+        while (binomial(cell, i + 1) > aRank)
+            cell--;
+        aCells[i] = cell;
+        aRank -= binomial(cell, i + 1);
+        cell--;
+    }
+}
+
+static uint64_t getIndex(const PieceSet& aSet)
+{
+    uint64_t shieldCombos = binomial(CELLS, aSet.itsShieldCount);
+    uint64_t swordCombos = binomial(CELLS, aSet.itsSwordCount);
+    uint64_t index = uint64_t(aSet.itsSide) * CELLS + uint64_t(aSet.itsKing);
+    index = index * shieldCombos + rankCells(aSet.itsShields, aSet.itsShieldCount);
+    return index * swordCombos + rankCells(aSet.itsSwords, aSet.itsSwordCount);
+}
+
+static void getPieceSet(uint64_t aIndex, int aShields, int aSwords, PieceSet& aSet)
+{
+    uint64_t shieldCombos = binomial(CELLS, aShields);
+    uint64_t swordCombos = binomial(CELLS, aSwords);
+    aSet.itsShieldCount = aShields;
+    aSet.itsSwordCount = aSwords;
+    unrankCells(aIndex % swordCombos, aSwords, aSet.itsSwords);
+    aIndex /= swordCombos;
+    unrankCells(aIndex % shieldCombos, aShields, aSet.itsShields);
+    aIndex /= shieldCombos;
+    aSet.itsKing = int(aIndex % CELLS);
+    aSet.itsSide = int(aIndex / CELLS);
+}
+
+// les boucliers et les épées ne peuvent pas se trouver sur une forteresse ou le château
+static bool isNormalCell(int aCell)
+{
+    int row = aCell / LITTLE;
+    int col = aCell % LITTLE;
+    if ((row == 0 || row == LITTLE - 1) && (col == 0 || col == LITTLE - 1))
+        return false;
+    return !(row == LITTLE / 2 && col == LITTLE / 2);
+}
+
+// pose les pièces sur un plateau vide ; renvoie false si deux pièces se chevauchent ou sont mal placées
+static bool placePieces(Game& aGame, const PieceSet& aSet)
+{
+    Cell** cells = aGame.itsBoard.itsCells;
+    cells[aSet.itsKing / LITTLE][aSet.itsKing % LITTLE].itsPieceType = KING;
+    bool valid = true;
+    for (int i = 0; i < aSet.itsShieldCount; ++i)
+    {
+        Cell& cell = cells[aSet.itsShields[i] / LITTLE][aSet.itsShields[i] % LITTLE];
+        valid = valid && cell.itsPieceType == NONE && isNormalCell(aSet.itsShields[i]);
+        cell.itsPieceType = SHIELD;
+    }
+    for (int i = 0; i < aSet.itsSwordCount; ++i)
+    {
+        Cell& cell = cells[aSet.itsSwords[i] / LITTLE][aSet.itsSwords[i] % LITTLE];
+        valid = valid && cell.itsPieceType == NONE && isNormalCell(aSet.itsSwords[i]);
+        cell.itsPieceType = SWORD;
+    }
+    aGame.itsCurrentPlayer = (aSet.itsSide == ATTACK) ? &aGame.itsPlayer1 : &aGame.itsPlayer2;
+    return valid;
+}
+
+static void removePieces(Game& aGame, const PieceSet& aSet)
+{
+    Cell** cells = aGame.itsBoard.itsCells;
+    cells[aSet.itsKing / LITTLE][aSet.itsKing % LITTLE].itsPieceType = NONE;
+    for (int i = 0; i < aSet.itsShieldCount; ++i)
+        cells[aSet.itsShields[i] / LITTLE][aSet.itsShields[i] % LITTLE].itsPieceType = NONE;
+    for (int i = 0; i < aSet.itsSwordCount; ++i)
+        cells[aSet.itsSwords[i] / LITTLE][aSet.itsSwords[i] % LITTLE].itsPieceType = NONE;
+}
+
+// déplace une case dans une liste croissante puis la remet en ordre
+static void moveCell(int* aCells, int aCount, int aFrom, int aTo)
+{
+    int i = 0;
+    while (aCells[i] != aFrom)
+        i++;
+    aCells[i] = aTo;
+    while (i > 0 && aCells[i - 1] > aCells[i])
+    {
+        swap(aCells[i - 1], aCells[i]);
+        i--;
+    }
+    while (i < aCount - 1 && aCells[i + 1] < aCells[i])
+    {
+        swap(aCells[i + 1], aCells[i]);
+        i++;
+    }
+}
+
+static void removeCell(int* aCells, int& aCount, int aCell)
+{
+    int i = 0;
+    while (aCells[i] != aCell)
+        i++;
+    for (; i < aCount - 1; ++i)
+        aCells[i] = aCells[i + 1];
+    aCount--;
+}
+
+// position atteinte après un coup joué avec makeMove
+static PieceSet getSuccessor(const PieceSet& aSet, const Move& aMove, const MoveUndo& aUndo, PieceType aMoved)
+{
+    PieceSet next = aSet;
+    next.itsSide = (aSet.itsSide == ATTACK) ? DEFENSE : ATTACK;
+    int from = aMove.itsStartPosition.itsRow * LITTLE + aMove.itsStartPosition.itsCol;
+    int to = aMove.itsEndPosition.itsRow * LITTLE + aMove.itsEndPosition.itsCol;
+    if (aMoved == KING)
+        next.itsKing = to;
+    else if (aMoved == SHIELD)
+        moveCell(next.itsShields, next.itsShieldCount, from, to);
+    else
+        moveCell(next.itsSwords, next.itsSwordCount, from, to);
+
+    for (int d = 0; d < 4; ++d)
+    {
+        if (!(aUndo.itsCaptured & (1 << d)))
+            continue;
+        Position pos = getNeighbour(aMove, d);
+        int cell = pos.itsRow * LITTLE + pos.itsCol;
+        if (aUndo.itsNeighbours[d] == SHIELD)
+            removeCell(next.itsShields, next.itsShieldCount, cell);
+        else if (aUndo.itsNeighbours[d] == SWORD)
+            removeCell(next.itsSwords, next.itsSwordCount, cell);
+    }
+    return next;
+}
+
+// valeur stockée d'une position dans une table compressée (décodage d'un seul bloc)
+static uint8_t readValue(const Tablebase& aTable, uint64_t aIndex)
+{
+    uint64_t block = aIndex / TABLEBASE_BLOCK;
+    uint64_t remaining = aIndex % TABLEBASE_BLOCK;
+    const uint8_t* pair = aTable.itsData + aTable.itsOffsets[block];
+    while (remaining >= pair[0])
+    {
+        remaining -= pair[0];
+        pair += 2;
+    }
+    return pair[1];
+}
+
+static bool isWinValue(uint8_t aValue)
+{
+    return aValue != VALUE_UNKNOWN && aValue != VALUE_INVALID && (aValue & 1);
+}
+
+static bool isLossValue(uint8_t aValue)
+{
+    return aValue != VALUE_UNKNOWN && aValue != VALUE_INVALID && !(aValue & 1);
+}
+
+static int getDistance(uint8_t aValue)
+{
+    return (aValue - 1) / 2;
+}
+
+string getTablebaseName(int aShields, int aSwords)
+{
+    return "tb_" + to_string(aShields) + "_" + to_string(aSwords) + ".htb";
+}
+
+/**
+ * État partagé par les threads pendant la construction d'une table.
+ */
+struct Generation
+{
+    int itsShields;
+    int itsSwords;
+    uint64_t itsEntries;
+    unique_ptr<atomic<uint8_t>[]> itsValues;
+    const TablebaseSet* itsSubTables;
+    atomic<uint64_t> itsNext;
+    atomic<uint64_t> itsResolved;
+};
+
+static const uint64_t GENERATION_CHUNK = 4096;
+
+// valeur d'une position successeur : dans la table en construction, ou dans une plus petite si une prise a eu lieu
+static uint8_t getSuccessorValue(const Generation& aGeneration, const PieceSet& aSet)
+{
+    uint64_t index = getIndex(aSet);
+    if (aSet.itsShieldCount == aGeneration.itsShields && aSet.itsSwordCount == aGeneration.itsSwords)
+        return aGeneration.itsValues[index].load(memory_order_relaxed);
+    return readValue(aGeneration.itsSubTables->itsTables[aSet.itsShieldCount][aSet.itsSwordCount], index);
+}
+
+// passe 0 : positions impossibles et positions de fin de partie
+static void terminalPass(Generation& aGeneration)
+{
+    Game game;
+    game.itsBoard.itsSize = LITTLE;
+    createBoard(game.itsBoard);
+    initializeBoard(game.itsBoard);
+    for (int i = 0; i < LITTLE; ++i) // plateau vide, cases spéciales conservées
+        for (int j = 0; j < LITTLE; ++j)
+            game.itsBoard.itsCells[i][j].itsPieceType = NONE;
+
+    uint64_t start;
+    while ((start = aGeneration.itsNext.fetch_add(GENERATION_CHUNK)) < aGeneration.itsEntries)
+    {
+        uint64_t end = min(start + GENERATION_CHUNK, aGeneration.itsEntries);
+        for (uint64_t index = start; index < end; ++index)
+        {
+            PieceSet set;
+            getPieceSet(index, aGeneration.itsShields, aGeneration.itsSwords, set);
+            uint8_t value = VALUE_UNKNOWN;
+            if (!placePieces(game, set))
+                value = VALUE_INVALID;
+            else if (isGameFinished(game))
+                value = (whoWon(game) == game.itsCurrentPlayer) ? 1 : 2; // gain ou perte en 0 coup
+            removePieces(game, set);
+            aGeneration.itsValues[index].store(value, memory_order_relaxed);
+        }
+    }
+    deleteBoard(game.itsBoard);
+}
+
+// passe d : gains en d coups et pertes en d coups
+static void retrogradePass(Generation& aGeneration, int aDistance)
+{
+    Game game;
+    game.itsBoard.itsSize = LITTLE;
+    createBoard(game.itsBoard);
+    initializeBoard(game.itsBoard);
+    for (int i = 0; i < LITTLE; ++i)
+        for (int j = 0; j < LITTLE; ++j)
+            game.itsBoard.itsCells[i][j].itsPieceType = NONE;
+
+    Move moves[MAX_MOVES];
+    uint64_t resolved = 0;
+    uint64_t start;
+    while ((start = aGeneration.itsNext.fetch_add(GENERATION_CHUNK)) < aGeneration.itsEntries)
+    {
+        uint64_t end = min(start + GENERATION_CHUNK, aGeneration.itsEntries);
+        for (uint64_t index = start; index < end; ++index)
+        {
+            if (aGeneration.itsValues[index].load(memory_order_relaxed) != VALUE_UNKNOWN)
+                continue;
+            PieceSet set;
+            getPieceSet(index, aGeneration.itsShields, aGeneration.itsSwords, set);
+            placePieces(game, set);
+
+            bool win = false;
+            bool allWins = true;
+            int count = generateMoves(game, moves);
+            for (int m = 0; m < count && !win; ++m)
+            {
+                const Move& move = moves[m];
+                PieceType moved = game.itsBoard.itsCells[move.itsStartPosition.itsRow][move.itsStartPosition.itsCol].itsPieceType;
+                MoveUndo undo;
+                makeMove(game, move, undo);
+                uint8_t value = getSuccessorValue(aGeneration, getSuccessor(set, move, undo, moved));
+                unmakeMove(game, move, undo);
+
+                // seules comptent les valeurs trouvées aux passes précédentes
+                if (isLossValue(value) && getDistance(value) < aDistance)
+                    win = true;
+                else if (!(isWinValue(value) && getDistance(value) < aDistance))
+                    allWins = false;
+            }
+            removePieces(game, set);
+
+            if (win || (allWins && count > 0))
+            {
+                aGeneration.itsValues[index].store(uint8_t((win ? 1 : 2) + 2 * aDistance), memory_order_relaxed);
+                resolved++;
+            }
+        }
+    }
+    aGeneration.itsResolved += resolved;
+    deleteBoard(game.itsBoard);
+}
+
+// lance une passe sur tous les threads
+static void runPass(Generation& aGeneration, int aThreads, int aDistance)
+{
+    aGeneration.itsNext = 0;
+    aGeneration.itsResolved = 0;
+    vector<thread> workers;
+    for (int i = 0; i < aThreads; ++i)
+    {
+        if (aDistance == 0)
+            workers.push_back(thread(terminalPass, ref(aGeneration)));
+        else
+            workers.push_back(thread(retrogradePass, ref(aGeneration), aDistance));
+    }
+    for (thread& worker : workers)
+        worker.join();
+}
+
+// écrit la table compressée par blocs (paires longueur, valeur)
+static bool writeTablebase(const Generation& aGeneration, const string& aPath, int aMaxDistance)
+{
+    ofstream out(aPath, ios::binary | ios::trunc);
+    if (!out)
+        return false;
+    uint64_t blocks = (aGeneration.itsEntries + TABLEBASE_BLOCK - 1) / TABLEBASE_BLOCK;
+    TablebaseHeader header = {TABLEBASE_MAGIC, uint32_t(aGeneration.itsShields), uint32_t(aGeneration.itsSwords),
+                              aGeneration.itsEntries, uint32_t(TABLEBASE_BLOCK), uint32_t(aMaxDistance)};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    vector<uint64_t> offsets(blocks + 1, 0);
+    out.write(reinterpret_cast<const char*>(offsets.data()), streamsize(offsets.size() * sizeof(uint64_t)));
+
+    uint64_t written = 0;
+    vector<uint8_t> block;
+    for (uint64_t b = 0; b < blocks; ++b)
+    {
+        offsets[b] = written;
+        block.clear();
+        uint64_t end = min((b + 1) * TABLEBASE_BLOCK, aGeneration.itsEntries);
+        for (uint64_t index = b * TABLEBASE_BLOCK; index < end;)
+        {
+            uint8_t value = aGeneration.itsValues[index].load(memory_order_relaxed);
+            if (value == VALUE_INVALID)
+                value = VALUE_UNKNOWN; // une position impossible n'est jamais consultée
+            int run = 0;
+            while (index < end && run < 255)
+            {
+                uint8_t next = aGeneration.itsValues[index].load(memory_order_relaxed);
+                if ((next == VALUE_INVALID ? VALUE_UNKNOWN : next) != value)
+                    break;
+                run++;
+                index++;
+            }
+            block.push_back(uint8_t(run));
+            block.push_back(value);
+        }
+        out.write(reinterpret_cast<const char*>(block.data()), streamsize(block.size()));
+        written += block.size();
+    }
+    offsets[blocks] = written;
+    out.seekp(sizeof(header));
+    out.write(reinterpret_cast<const char*>(offsets.data()), streamsize(offsets.size() * sizeof(uint64_t)));
+    return bool(out);
+}
+
+static bool openTablebase(Tablebase& aTable, const string& aPath, int aShields, int aSwords)
+{
+    if (!openMappedFile(aTable.itsFile, aPath))
+        return false;
+    const TablebaseHeader* header = reinterpret_cast<const TablebaseHeader*>(aTable.itsFile.itsData);
+    uint64_t blocks = (countEntries(aShields, aSwords) + TABLEBASE_BLOCK - 1) / TABLEBASE_BLOCK;
+    if (aTable.itsFile.itsSize < sizeof(TablebaseHeader) + (blocks + 1) * sizeof(uint64_t)
+        || header->itsMagic != TABLEBASE_MAGIC || header->itsShields != uint32_t(aShields)
+        || header->itsSwords != uint32_t(aSwords) || header->itsBlock != uint32_t(TABLEBASE_BLOCK)
+        || header->itsEntries != countEntries(aShields, aSwords))
+    {
+        closeMappedFile(aTable.itsFile);
+        return false;
+    }
+    aTable.itsEntries = header->itsEntries;
+    aTable.itsOffsets = reinterpret_cast<const uint64_t*>(header + 1);
+    aTable.itsData = reinterpret_cast<const uint8_t*>(aTable.itsOffsets + blocks + 1);
+    return true;
+}
+
+static int getMaxDistance(const Tablebase& aTable)
+{
+    return int(reinterpret_cast<const TablebaseHeader*>(aTable.itsFile.itsData)->itsMaxDistance);
+}
+
+bool generateTablebase(int aShields, int aSwords, const string& aDirectory, int aThreads)
+{
+    if (aShields < 0 || aShields > TABLEBASE_MAX_SHIELDS || aSwords < 0 || aSwords > TABLEBASE_MAX_SWORDS
+        || countEntries(aShields, aSwords) > TABLEBASE_MAX_ENTRIES)
+        return false;
+    string path = aDirectory + "/" + getTablebaseName(aShields, aSwords);
+    if (ifstream(path).good())
+        return true;
+
+    // tables plus petites d'abord : une prise fait perdre des boucliers ou des épées
+    for (int s = 0; s <= aShields; ++s)
+        for (int w = 0; w <= aSwords; ++w)
+            if ((s != aShields || w != aSwords) && !generateTablebase(s, w, aDirectory, aThreads))
+                return false;
+
+    TablebaseSet subTables;
+    openTablebases(subTables, aDirectory);
+    int maxSubDistance = 0;
+    for (int s = 0; s <= aShields; ++s)
+        for (int w = 0; w <= aSwords; ++w)
+            if ((s != aShields || w != aSwords) && subTables.itsTables[s][w].itsData != nullptr)
+                maxSubDistance = max(maxSubDistance, getMaxDistance(subTables.itsTables[s][w]));
+
+    if (aThreads <= 0)
+        aThreads = max(1u, thread::hardware_concurrency());
+    Generation generation;
+    generation.itsShields = aShields;
+    generation.itsSwords = aSwords;
+    generation.itsEntries = countEntries(aShields, aSwords);
+    generation.itsValues.reset(new atomic<uint8_t>[generation.itsEntries]);
+    generation.itsSubTables = &subTables;
+
+    runPass(generation, aThreads, 0);
+    int maxDistance = 0;
+    bool settled = false;
+    for (int d = 1; d <= MAX_DISTANCE; ++d)
+    {
+        runPass(generation, aThreads, d);
+        if (generation.itsResolved > 0)
+            maxDistance = d;
+        else if (d > maxSubDistance)
+        {
+            settled = true; // plus rien ne peut être résolu
+            break;
+        }
+    }
+
+    // des positions se résolvaient encore à la dernière distance codable : les restes ne sont
+    // pas des nulles, la table serait fausse
+    bool written = settled && writeTablebase(generation, path, maxDistance);
+    closeTablebases(subTables);
+    return written;
+}
+
+int openTablebases(TablebaseSet& aSet, const string& aDirectory)
+{
+    aSet.itsCount = 0;
+    for (int s = 0; s <= TABLEBASE_MAX_SHIELDS; ++s)
+        for (int w = 0; w <= TABLEBASE_MAX_SWORDS; ++w)
+            if (countEntries(s, w) <= TABLEBASE_MAX_ENTRIES
+                && openTablebase(aSet.itsTables[s][w], aDirectory + "/" + getTablebaseName(s, w), s, w))
+                aSet.itsCount++;
+    return aSet.itsCount;
+}
+
+void closeTablebases(TablebaseSet& aSet)
+{
+    for (int s = 0; s <= TABLEBASE_MAX_SHIELDS; ++s)
+        for (int w = 0; w <= TABLEBASE_MAX_SWORDS; ++w)
+            if (aSet.itsTables[s][w].itsData != nullptr)
+            {
+                closeMappedFile(aSet.itsTables[s][w].itsFile);
+                aSet.itsTables[s][w] = Tablebase();
+            }
+    aSet.itsCount = 0;
+}
+
+bool probeTablebase(const TablebaseSet& aSet, const Game& aGame, TablebaseResult& aResult)
+{
+    if (aSet.itsCount == 0 || aGame.itsBoard.itsSize != LITTLE)
+        return false;
+
+    PieceSet set;
+    set.itsSide = aGame.itsCurrentPlayer->itsRole;
+    set.itsKing = -1;
+    set.itsShieldCount = 0;
+    set.itsSwordCount = 0;
+    for (int i = 0; i < LITTLE; ++i)
+    {
+        for (int j = 0; j < LITTLE; ++j)
+        {
+            switch (aGame.itsBoard.itsCells[i][j].itsPieceType)
+            {
+            case KING:
+                set.itsKing = i * LITTLE + j;
+                break;
+            case SHIELD:
+                if (set.itsShieldCount == TABLEBASE_MAX_SHIELDS)
+                    return false;
+                set.itsShields[set.itsShieldCount++] = i * LITTLE + j;
+                break;
+            case SWORD:
+                if (set.itsSwordCount == TABLEBASE_MAX_SWORDS)
+                    return false;
+                set.itsSwords[set.itsSwordCount++] = i * LITTLE + j;
+                break;
+            default:
+                break;
+            }
+        }
+    }
+    const Tablebase& table = aSet.itsTables[set.itsShieldCount][set.itsSwordCount];
+    if (set.itsKing == -1 || table.itsData == nullptr)
+        return false;
+
+    uint8_t value = readValue(table, getIndex(set));
+    if (value == VALUE_UNKNOWN || value == VALUE_INVALID)
+        aResult = {TB_DRAW, 0};
+    else
+        aResult = {isWinValue(value) ? TB_WIN : TB_LOSS, getDistance(value)};
+    return true;
+}
@@ -0,0 +1,146 @@
+/**
+ * @file tablebase.h
+ *
+ * @brief Endgame tablebases for the 11x11 board, built by retrograde analysis.
+ *
+ * A table holds every position of one material configuration (the king, `s` shields and
+ * `w` swords, with either side to move) and its exact value: win or loss for the side to move
+ * with the number of plies to the end, or draw. Tables are built by successive passes: pass `d`
+ * marks the positions won in `d` plies (a move reaches a position lost in `d-1`) and lost in `d`
+ * plies (every move reaches a position won in less than `d`). Moves are played with `makeMove`,
+ * so captures follow `capturePieces`, and the end of a game is found with `isGameFinished`
+ * (`isKingCaptured`, `isKingEscaped`, `isSwordLeft`). A capture leads to a smaller
+ * configuration, whose table is built first.
+ *
+ * A position index is (side, king cell, shield cells, sword cells), the cells of identical pieces
+ * being ranked as a combination. The table file is made of a header, the offsets of its blocks of
+ * `TABLEBASE_BLOCK` positions, then the blocks compressed as (run length, value) byte pairs.
+ * It is read through a memory mapping, and a probe only decodes one block.
+ *
+ * @note The size of a table grows as 121^(pieces), so in practice the generator is limited to
+ *       about 4 pieces with the king (a few hundred MB of memory while building).
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+#include <cstdint>
+#include "typeDef.h"
+#include "mappedfile.h"
+
+/**
+ * @brief Largest number of shields of a table.
+ */
+const int TABLEBASE_MAX_SHIELDS = 4;
+
+/**
+ * @brief Largest number of swords of a table.
+ */
+const int TABLEBASE_MAX_SWORDS = 5;
+
+/**
+ * @brief Number of positions per compressed block.
+ */
+const int TABLEBASE_BLOCK = 128;
+
+/**
+ * @brief Largest table the generator accepts (entries, one byte each while building).
+ */
+const uint64_t TABLEBASE_MAX_ENTRIES = uint64_t(1) << 32;
+
+/**
+ * @enum TablebaseValue
+ * @brief Value of a position for the side to move.
+ */
+enum TablebaseValue
+{
+    TB_DRAW,  /**< Neither side can force the end of the game. */
+    TB_WIN,   /**< The side to move wins. */
+    TB_LOSS   /**< The side to move loses. */
+};
+
+/**
+ * @struct TablebaseResult
+ * @brief Result of a probe.
+ */
+struct TablebaseResult
+{
+    TablebaseValue itsValue; /**< Win, loss or draw for the side to move. */
+    int itsDistance;         /**< Number of plies to the end of the game with best play (0 for a draw). */
+};
+
+/**
+ * @struct Tablebase
+ * @brief One table file mapped in memory.
+ */
+struct Tablebase
+{
+    MappedFile itsFile;                 /**< The mapped file. */
+    uint64_t itsEntries = 0;            /**< Number of positions. */
+    const uint64_t* itsOffsets = nullptr; /**< Start of each block in `itsData` (one more for the end). */
+    const uint8_t* itsData = nullptr;   /**< Compressed blocks. */
+};
+
+/**
+ * @struct TablebaseSet
+ * @brief All the tables available in a directory.
+ */
+struct TablebaseSet
+{
+    Tablebase itsTables[TABLEBASE_MAX_SHIELDS + 1][TABLEBASE_MAX_SWORDS + 1]; /**< Tables by number of shields and swords. */
+    int itsCount = 0;                                                         /**< Number of tables loaded. */
+};
+
+/**
+ * @brief Returns the file name of a table, e.g. "tb_1_3.htb" for the king, 1 shield and 3 swords.
+ *
+ * @param aShields The number of shields.
+ * @param aSwords The number of swords.
+ * @return The file name.
+ */
+string getTablebaseName(int aShields, int aSwords);
+
+/**
+ * @brief Builds a table and, first, every smaller table it depends on that is not in the directory yet.
+ *
+ * Each pass is shared between `aThreads` threads working on ranges of position indices.
+ *
+ * @param aShields The number of shields.
+ * @param aSwords The number of swords.
+ * @param aDirectory The directory of the table files.
+ * @param aThreads The number of threads (0 to use one per core).
+ * @return `true` if the table file was written (or already existed); `false` if positions were still
+ *         being resolved at the longest distance a value can hold, and no file is written then.
+ */
+bool generateTablebase(int aShields, int aSwords, const string& aDirectory, int aThreads = 0);
+
+/**
+ * @brief Maps every table file found in a directory.
+ *
+ * @param aSet The set to fill.
+ * @param aDirectory The directory of the table files.
+ * @return The number of tables loaded.
+ */
+int openTablebases(TablebaseSet& aSet, const string& aDirectory);
+
+/**
+ * @brief Unmaps every table of a set.
+ *
+ * @param aSet The set to close.
+ */
+void closeTablebases(TablebaseSet& aSet);
+
+/**
+ * @brief Looks a position up in the tables.
+ *
+ * @param aSet The open tables.
+ * @param aGame The position (11x11 board).
+ * @param aResult Receives the value and the distance.
+ * @return `false` if no table covers the position (board size or material).
+ */
+bool probeTablebase(const TablebaseSet& aSet, const Game& aGame, TablebaseResult& aResult);
+
+#endif // TABLEBASE_H
@@ -19,11 +19,54 @@
  * @date 24/11/2024
  */
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "typeDef.h"
 #include "functions.h"
+#include "batch.h"
+#include "broadcast.h"
+#include "book.h"
+#include "clock.h"
+#include "engine.h"
+#include "evaluation.h"
+#include "gameflow.h"
+#include "hash.h"
+#include "journal.h"
+#include "movegen.h"
+#include "nnue.h"
+#include "notation.h"
+#include "pool.h"
+#include "posindex.h"
+#include "record.h"
+#include "render.h"
+#include "search.h"
+#include "searchpool.h"
+#include "selfplay.h"
+#include "server.h"
+#include "stats.h"
+#include "symmetry.h"
+#include "tablebase.h"
+#include "timeline.h"
+#include "tuner.h"
+#include "validator.h"
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 
@@ -2052,6 +2095,2686 @@ void test_isKingCapturedV2()
 }
 
 
+/**
+ * @brief Test function for the compact notation (formatPosition, parsePosition, formatMove, parseMove).
+ *
+ * This function checks the position strings of both starting boards, reads them back,
+ * rejects malformed strings and round-trips a few moves.
+ */
+void test_notation()
+{
+    cout << "********* Start testing of notation *********" << endl;
+    int pass = 0;
+    int failed = 0;
+
+    struct TestCase {
+        BoardSize size;
+        string expected;
+    };
+
+    TestCase testCases[] = {
+        {LITTLE, "3XXXXX3/5X5/11/X4U4X/X3UUU3X/XX1UUKUU1XX/X3UUU3X/X4U4X/11/5X5/3XXXXX3 a 11"},
+        {BIG, "4XXXXX4/6X6/13/6U6/X5U5X/X5U5X/XX1UUUKUUU1XX/X5U5X/X5U5X/6U6/13/6X6/4XXXXX4 a 13"},
+    };
+
+    for (const TestCase& testCase : testCases) {
+        Board b = {nullptr, testCase.size};
+        createBoard(b);
+        initializeBoard(b);
+        Game game;
+        game.itsBoard = b;
+
+        char text[POSITION_STRING_SIZE];
+        formatPosition(game, text, POSITION_STRING_SIZE);
+        if (testCase.expected == text) {
+            cout << "PASS \t: " << text << endl;
+            pass++;
+        } else {
+            cout << "FAIL! \t: " << "\n\tActual " << text << "\n\texpected " << testCase.expected << endl;
+            failed++;
+        }
+
+        // relecture dans un plateau pas encore créé, côté défense
+        Game other;
+        string defense = testCase.expected;
+        defense[defense.size() - 4] = 'd';
+        bool same = parsePosition(defense.c_str(), other) && other.itsBoard.itsSize == testCase.size
+                    && other.itsCurrentPlayer == &other.itsPlayer2;
+        for (int i = 0; same && i < testCase.size; ++i)
+            for (int j = 0; same && j < testCase.size; ++j)
+                same = (other.itsBoard.itsCells[i][j].itsPieceType == b.itsCells[i][j].itsPieceType)
+                       && (other.itsBoard.itsCells[i][j].itsCellType == b.itsCells[i][j].itsCellType);
+        if (same) {
+            cout << "PASS \t: position read back" << endl;
+            pass++;
+        } else {
+            cout << "FAIL! \t: position read back differs" << endl;
+            failed++;
+        }
+        db(b.itsCells, testCase.size);
+        db(other.itsBoard.itsCells, testCase.size);
+    }
+
+    // Chaînes invalides
+    string invalids[] = {
+        "3XXXXX3/5X5 a 11",                                                          // missing rows
+        "3XXXXX3/5X5/11/X4U4X/X3UUU3X/XX1UUKUU1XX/X3UUU3X/X4U4X/11/5X5/3XXXXX4 a 11", // row too long
+        "3XXXXX3/5X5/11/X4U4X/X3UUU3X/XX1UUKUU1XX/X3UUU3X/X4U4X/11/5X5/3XXXXX3 a 13", // wrong size
+        "3XXXXX3/5X5/11/X4U4X/X3UUU3X/XX1UUKUU1XX/X3UUU3X/X4U4X/11/5X5/3XXXXX3 w 11", // wrong side
+        "3XXXXX3/5X5/11/X4U4X/X3UUU3X/XX1UKKUU1XX/X3UUU3X/X4U4X/11/5X5/3XXXXX3 a 11", // two kings
+    };
+    for (const string& invalid : invalids) {
+        Game game;
+        if (!parsePosition(invalid.c_str(), game)) {
+            cout << "PASS \t: rejected " << invalid << endl;
+            pass++;
+        } else {
+            cout << "FAIL! \t: accepted " << invalid << endl;
+            failed++;
+        }
+        if (game.itsBoard.itsCells != nullptr)
+            db(game.itsBoard.itsCells, game.itsBoard.itsSize);
+    }
+
+    // Coups
+    Board little = {nullptr, LITTLE};
+    Move move;
+    char text[MOVE_STRING_SIZE];
+    if (parseMove("e1-E4", little, move) && move.itsStartPosition.itsRow == 4 && move.itsStartPosition.itsCol == 0
+        && move.itsEndPosition.itsRow == 4 && move.itsEndPosition.itsCol == 3
+        && formatMove(move, text, MOVE_STRING_SIZE) == 5 && string(text) == "e1-e4") {
+        cout << "PASS \t: e1-E4" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: e1-E4" << endl;
+        failed++;
+    }
+    if (parseMove("a10-k10", little, move) && formatMove(move, text, MOVE_STRING_SIZE) == 7 && string(text) == "a10-k10") {
+        cout << "PASS \t: a10-k10" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: a10-k10" << endl;
+        failed++;
+    }
+    if (!parseMove("a12-a1", little, move) && !parseMove("l1-a1", little, move) && !parseMove("a1a2", little, move)) {
+        cout << "PASS \t: invalid moves rejected" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: invalid moves accepted" << endl;
+        failed++;
+    }
+
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of notation *********" << endl << endl;
+}
+
+
+/**
+ * @brief Test function for the generateMoves function.
+ *
+ * This function plays random games and checks, in every position, that the generated list
+ * holds exactly the moves accepted by isValidMovement.
+ */
+void test_generateMoves()
+{
+    cout << "********* Start testing of generateMoves *********" << endl;
+    int pass = 0;
+    int failed = 0;
+
+    srand(26);
+    BoardSize sizes[] = {LITTLE, BIG};
+    for (BoardSize size : sizes) {
+        Game game;
+        game.itsBoard.itsSize = size;
+        createBoard(game.itsBoard);
+        initializeBoard(game.itsBoard);
+
+        bool same = true;
+        for (int ply = 0; ply < 60 && same && !isGameFinished(game); ++ply) {
+            Move moves[MAX_MOVES];
+            int count = generateMoves(game, moves);
+
+            // toutes les paires (départ, arrivée) acceptées par isValidMovement
+            int valid = 0;
+            for (int a = 0; a < size * size; ++a)
+                for (int b = 0; b < size * size; ++b) {
+                    Move move = {{a / size, a % size}, {b / size, b % size}};
+                    if ((move.itsStartPosition.itsRow == move.itsEndPosition.itsRow
+                         || move.itsStartPosition.itsCol == move.itsEndPosition.itsCol)
+                        && isValidMovement(game, move)) {
+                        valid++;
+                        if (getMoveIndex(game, move) == -1)
+                            same = false;
+                    }
+                }
+            if (valid != count)
+                same = false;
+
+            Move move = moves[rand() % count];
+            movePiece(game, move);
+            capturePieces(game, move);
+            switchCurrentPlayer(game);
+        }
+        if (same) {
+            cout << "PASS \t: " << size << "x" << size << " random game" << endl;
+            pass++;
+        } else {
+            cout << "FAIL! \t: " << size << "x" << size << " generated moves differ from isValidMovement" << endl;
+            failed++;
+        }
+        db(game.itsBoard.itsCells, size);
+    }
+
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of generateMoves *********" << endl << endl;
+}
+
+
+/**
+ * @brief Test function for the game records (RecordWriter and RecordReader).
+ *
+ * This function writes two random games into a temporary record file, reads them back
+ * and compares the moves, the names and the results.
+ */
+void test_record()
+{
+    cout << "********* Start testing of record *********" << endl;
+    int pass = 0;
+    int failed = 0;
+    const string path = "test_record.hrec";
+    remove(path.c_str());
+
+    srand(27);
+    BoardSize sizes[] = {LITTLE, BIG};
+    Move played[2][200];
+    int plies[2];
+    RecordResult results[2];
+
+    RecordWriter writer;
+    openRecordWriter(writer, path);
+    for (int g = 0; g < 2; ++g) {
+        Game game;
+        game.itsBoard.itsSize = sizes[g];
+        game.itsPlayer1.itsName = "Alice";
+        game.itsPlayer2.itsName = (g == 0) ? "Bob" : "";
+        createBoard(game.itsBoard);
+        initializeBoard(game.itsBoard);
+        beginRecord(writer, game);
+        plies[g] = 0;
+        while (plies[g] < 200 && !isGameFinished(game)) {
+            Move moves[MAX_MOVES];
+            Move move = moves[rand() % generateMoves(game, moves)];
+            writeRecordMove(writer, game, move);
+            played[g][plies[g]++] = move;
+            movePiece(game, move);
+            capturePieces(game, move);
+            switchCurrentPlayer(game);
+        }
+        endRecord(writer, game);
+        results[g] = getRecordResult(game);
+        db(game.itsBoard.itsCells, sizes[g]);
+    }
+    closeRecordWriter(writer);
+
+    RecordReader reader;
+    openRecordReader(reader, path);
+    Game game;
+    for (int g = 0; g < 2; ++g) {
+        bool same = readRecordHeader(reader, game) && game.itsBoard.itsSize == sizes[g]
+                    && game.itsPlayer1.itsName == "Alice" && game.itsPlayer2.itsName == ((g == 0) ? "Bob" : "");
+        int ply = 0;
+        Move move;
+        RecordStatus status;
+        while (same && (status = replayRecordMove(reader, game, move)) == RECORD_MOVE) {
+            same = ply < plies[g]
+                   && move.itsStartPosition.itsRow == played[g][ply].itsStartPosition.itsRow
+                   && move.itsStartPosition.itsCol == played[g][ply].itsStartPosition.itsCol
+                   && move.itsEndPosition.itsRow == played[g][ply].itsEndPosition.itsRow
+                   && move.itsEndPosition.itsCol == played[g][ply].itsEndPosition.itsCol;
+            ply++;
+        }
+        if (same && status == RECORD_END && ply == plies[g] && reader.itsResult == results[g]
+            && getRecordResult(game) == results[g]) {
+            cout << "PASS \t: game " << g + 1 << " read back (" << ply << " plies)" << endl;
+            pass++;
+        } else {
+            cout << "FAIL! \t: game " << g + 1 << " differs" << endl;
+            failed++;
+        }
+    }
+    if (!readRecordHeader(reader, game)) {
+        cout << "PASS \t: end of file" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: unexpected third game" << endl;
+        failed++;
+    }
+    closeRecordReader(reader);
+    remove(path.c_str());
+
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of record *********" << endl << endl;
+}
+
+
+/**
+ * @brief Test function for the validateArchive function.
+ *
+ * This function writes an archive of random games where two games are damaged (a wrong result
+ * and an illegal move index) and checks that exactly these games are reported, at the right ply.
+ */
+void test_validateArchive()
+{
+    cout << "********* Start testing of validateArchive *********" << endl;
+    int pass = 0;
+    int failed = 0;
+    const string path = "test_validate.hrec";
+    remove(path.c_str());
+
+    srand(28);
+    RecordWriter writer;
+    openRecordWriter(writer, path);
+    for (int g = 1; g <= 40; ++g) {
+        Game game;
+        game.itsBoard.itsSize = (g % 2 == 0) ? BIG : LITTLE;
+        createBoard(game.itsBoard);
+        initializeBoard(game.itsBoard);
+        beginRecord(writer, game);
+        for (int ply = 1; ply <= 100 && !isGameFinished(game); ++ply) {
+            if (g == 17 && ply == 3) {
+                writer.itsStream.put(char(0xDA)); // indice 1241 : hors de la liste
+                writer.itsStream.put(char(0x09));
+            }
+            Move moves[MAX_MOVES];
+            Move move = moves[rand() % generateMoves(game, moves)];
+            writeRecordMove(writer, game, move);
+            movePiece(game, move);
+            capturePieces(game, move);
+            switchCurrentPlayer(game);
+        }
+        if (g == 9) { // résultat falsifié
+            writer.itsStream.put(0);
+            writer.itsStream.put(char(getRecordResult(game) == RECORD_PLAYER1 ? RECORD_PLAYER2 : RECORD_PLAYER1));
+        }
+        else
+            endRecord(writer, game);
+        db(game.itsBoard.itsCells, game.itsBoard.itsSize);
+    }
+    closeRecordWriter(writer);
+
+    ValidationReport report;
+    bool opened = validateArchive(path, 4, report);
+    displayValidationReport(report);
+    if (opened && report.itsGames == 40 && !report.itsTruncated && report.itsFailures.size() == 2
+        && report.itsFailures[0].itsGameNumber == 9 && report.itsFailures[1].itsGameNumber == 17
+        && report.itsFailures[1].itsPly == 3) {
+        cout << "PASS \t: damaged games 9 and 17 found" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: damaged games not reported correctly" << endl;
+        failed++;
+    }
+
+    // archive tronquée au milieu de la dernière partie
+    ifstream in(path, ios::binary);
+    string content((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    in.close();
+    ofstream out(path, ios::binary | ios::trunc);
+    out.write(content.data(), content.size() - 5);
+    out.close();
+    if (validateArchive(path, 2, report) && report.itsTruncated && report.itsFailures.size() == 3
+        && report.itsFailures[2].itsGameNumber == 40) {
+        cout << "PASS \t: truncated archive" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: truncated archive not reported" << endl;
+        failed++;
+    }
+    remove(path.c_str());
+
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of validateArchive *********" << endl << endl;
+}
+
+
+/**
+ * @brief Test function for the position index (buildPositionIndex, findPosition).
+ *
+ * This function indexes an archive of random games with very small runs (to exercise the merge),
+ * then checks that every position of every game is found with the right game and result,
+ * and that an unknown position is not.
+ */
+void test_positionIndex()
+{
+    cout << "********* Start testing of positionIndex *********" << endl;
+    int pass = 0;
+    int failed = 0;
+    const string archive = "test_index.hrec";
+    const string indexPath = "test_index.hidx";
+    remove(archive.c_str());
+
+    srand(29);
+    const int GAMES = 30;
+    vector<uint64_t> hashes[GAMES];
+    RecordResult results[GAMES];
+    RecordWriter writer;
+    openRecordWriter(writer, archive);
+    for (int g = 0; g < GAMES; ++g) {
+        Game game;
+        game.itsBoard.itsSize = (g % 3 == 0) ? BIG : LITTLE;
+        createBoard(game.itsBoard);
+        initializeBoard(game.itsBoard);
+        beginRecord(writer, game);
+        hashes[g].push_back(hashPosition(game));
+        for (int ply = 0; ply < 80 && !isGameFinished(game); ++ply) {
+            Move moves[MAX_MOVES];
+            Move move = moves[rand() % generateMoves(game, moves)];
+            writeRecordMove(writer, game, move);
+            movePiece(game, move);
+            capturePieces(game, move);
+            switchCurrentPlayer(game);
+            hashes[g].push_back(hashPosition(game));
+        }
+        endRecord(writer, game);
+        results[g] = getRecordResult(game);
+        db(game.itsBoard.itsCells, game.itsBoard.itsSize);
+    }
+    closeRecordWriter(writer);
+
+    PositionIndex index;
+    if (buildPositionIndex(archive, indexPath, 500) && openPositionIndex(index, indexPath)) {
+        cout << "PASS \t: index built (" << index.itsCount << " entries)" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: index not built" << endl;
+        failed++;
+    }
+
+    bool found = true;
+    for (int g = 0; g < GAMES && found; ++g) {
+        for (uint64_t hash : hashes[g]) {
+            const IndexEntry* first;
+            uint64_t count = findPosition(index, hash, first);
+            bool hasGame = false;
+            for (uint64_t i = 0; i < count; ++i) {
+                if (first[i].itsHash != hash || (i > 0 && first[i].itsGame <= first[i - 1].itsGame))
+                    found = false;
+                if (first[i].itsGame == uint32_t(g + 1) && first[i].itsResult == results[g])
+                    hasGame = true;
+            }
+            found = found && hasGame;
+        }
+    }
+    if (found) {
+        cout << "PASS \t: every position found once per game" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: missing or duplicated position" << endl;
+        failed++;
+    }
+
+    // position de départ 11x11 : toutes les parties sur le petit plateau
+    const IndexEntry* first;
+    uint64_t start = findPosition(index, hashes[1][0], first);
+    if (start == uint64_t(GAMES - GAMES / 3) && findPosition(index, 0x123456789ULL, first) == 0) {
+        cout << "PASS \t: start position and unknown position" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: start position found in " << start << " games" << endl;
+        failed++;
+    }
+    closePositionIndex(index);
+    remove(archive.c_str());
+    remove(indexPath.c_str());
+
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of positionIndex *********" << endl << endl;
+}
+
+
+/**
+ * @brief Test function for the symmetries (transformPacked, canonicalizePacked, getCanonicalKey).
+ *
+ * This function compares the row-wise symmetries with a cell-by-cell transformation on random
+ * positions, and checks that the 8 variants of a position share the same canonical key.
+ */
+void test_symmetry()
+{
+    cout << "********* Start testing of symmetry *********" << endl;
+    int pass = 0;
+    int failed = 0;
+
+    srand(30);
+    BoardSize sizes[] = {LITTLE, BIG};
+    for (BoardSize size : sizes) {
+        Game game;
+        game.itsBoard.itsSize = size;
+        createBoard(game.itsBoard);
+        initializeBoard(game.itsBoard);
+        Game variant;
+        bool transforms = true;
+        bool keys = true;
+        bool movesOk = true;
+
+        for (int ply = 0; ply < 40 && !isGameFinished(game); ++ply) {
+            PackedBoard packed;
+            packPosition(game, packed);
+            if (hashPacked(packed) != hashPosition(game))
+                keys = false;
+            int canonicalTransform;
+            uint64_t key = getCanonicalKey(game, &canonicalTransform);
+            Move moves[MAX_MOVES];
+            int count = generateMoves(game, moves);
+
+            for (int t = 0; t < SYMMETRY_COUNT; ++t) {
+                PackedBoard transformed;
+                PackedBoard back;
+                transformPacked(packed, t, transformed);
+                transformPacked(transformed, getInverseTransform(t), back);
+                unpackPosition(transformed, variant);
+
+                // comparaison case par case
+                for (int i = 0; i < size; ++i)
+                    for (int j = 0; j < size; ++j) {
+                        Position p = transformPosition({i, j}, t, size);
+                        if (variant.itsBoard.itsCells[p.itsRow][p.itsCol].itsPieceType != game.itsBoard.itsCells[i][j].itsPieceType)
+                            transforms = false;
+                    }
+                for (int r = 0; r < 16; ++r)
+                    if (back.itsSwords[r] != packed.itsSwords[r] || back.itsShields[r] != packed.itsShields[r] || back.itsKing[r] != packed.itsKing[r])
+                        transforms = false;
+                if (getCanonicalKey(variant) != key)
+                    keys = false;
+                if (getMoveIndex(variant, transformMove(moves[ply % count], t, size)) == -1)
+                    movesOk = false;
+            }
+
+            Move move = moves[rand() % count];
+            movePiece(game, move);
+            capturePieces(game, move);
+            switchCurrentPlayer(game);
+        }
+
+        if (transforms && keys && movesOk) {
+            cout << "PASS \t: " << size << "x" << size << " symmetries" << endl;
+            pass++;
+        } else {
+            cout << "FAIL! \t: " << size << "x" << size << " transforms " << transforms << " keys " << keys << " moves " << movesOk << endl;
+            failed++;
+        }
+        db(game.itsBoard.itsCells, size);
+        db(variant.itsBoard.itsCells, size);
+    }
+
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of symmetry *********" << endl << endl;
+}
+
+
+void test_tablebase()
+{
+    cout << "********* Start testing of tablebase *********" << endl;
+    int pass = 0;
+    int failed = 0;
+
+    // table du roi contre deux épées (et les tables plus petites dont elle dépend)
+    string directory = ".";
+    bool generated = generateTablebase(0, 2, directory, 2);
+    TablebaseSet tables;
+    int loaded = openTablebases(tables, directory);
+    if (generated && loaded == 3) {
+        cout << "PASS \t: generation of king + 2 swords and its subtables" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: generation " << generated << ", " << loaded << " tables loaded" << endl;
+        failed++;
+    }
+
+    // chaque valeur doit être cohérente avec celles des positions atteintes en un coup
+    srand(31);
+    Game game;
+    game.itsBoard.itsSize = LITTLE;
+    createBoard(game.itsBoard);
+    initializeBoard(game.itsBoard);
+    game.itsPlayer1.itsRole = ATTACK;
+    game.itsPlayer2.itsRole = DEFENSE;
+    int wins = 0;
+    int losses = 0;
+    int inconsistent = 0;
+    for (int n = 0; n < 2000; ++n) {
+        for (int i = 0; i < LITTLE; ++i)
+            for (int j = 0; j < LITTLE; ++j)
+                game.itsBoard.itsCells[i][j].itsPieceType = NONE;
+        game.itsBoard.itsCells[rand() % LITTLE][rand() % LITTLE].itsPieceType = KING;
+        for (int placed = 0; placed < 2;) {
+            Cell& cell = game.itsBoard.itsCells[rand() % LITTLE][rand() % LITTLE];
+            if (cell.itsCellType == NORMAL && cell.itsPieceType == NONE) {
+                cell.itsPieceType = SWORD;
+                placed++;
+            }
+        }
+        game.itsCurrentPlayer = (n % 2 == 0) ? &game.itsPlayer1 : &game.itsPlayer2;
+
+        TablebaseResult result;
+        if (!probeTablebase(tables, game, result)) {
+            inconsistent++;
+            continue;
+        }
+        if ((result.itsDistance == 0 && result.itsValue != TB_DRAW) != isGameFinished(game)) {
+            inconsistent++;
+            continue;
+        }
+        if (result.itsValue == TB_DRAW || result.itsDistance == 0)
+            continue;
+        (result.itsValue == TB_WIN) ? wins++ : losses++;
+
+        // gain : un coup mène à une perte en d-1 ; perte : tous les coups mènent à un gain en d-1 au plus
+        Move moves[MAX_MOVES];
+        int count = generateMoves(game, moves);
+        bool best = false;
+        bool refuted = false;
+        for (int m = 0; m < count; ++m) {
+            MoveUndo undo;
+            makeMove(game, moves[m], undo);
+            TablebaseResult next;
+            probeTablebase(tables, game, next);
+            unmakeMove(game, moves[m], undo);
+            if (result.itsValue == TB_WIN && next.itsValue == TB_LOSS && next.itsDistance == result.itsDistance - 1)
+                best = true;
+            if (result.itsValue == TB_LOSS) {
+                if (next.itsValue != TB_WIN || next.itsDistance > result.itsDistance - 1)
+                    refuted = true;
+                else if (next.itsDistance == result.itsDistance - 1)
+                    best = true;
+            }
+        }
+        if (!best || refuted)
+            inconsistent++;
+    }
+    if (inconsistent == 0 && wins > 0) {
+        cout << "PASS \t: values consistent with one ply search (" << wins << " wins, " << losses << " losses)" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: " << inconsistent << " inconsistent values (" << wins << " wins, " << losses << " losses)" << endl;
+        failed++;
+    }
+
+    // position hors des tables : trop de pièces
+    initializeBoard(game.itsBoard);
+    TablebaseResult result;
+    if (!probeTablebase(tables, game, result)) {
+        cout << "PASS \t: probe of the starting position refused" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: probe of the starting position accepted" << endl;
+        failed++;
+    }
+
+    closeTablebases(tables);
+    for (int w = 0; w <= 2; ++w)
+        remove((directory + "/" + getTablebaseName(0, w)).c_str());
+    db(game.itsBoard.itsCells, LITTLE);
+
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of tablebase *********" << endl << endl;
+}
+
+
+void test_openingBook()
+{
+    cout << "********* Start testing of openingBook *********" << endl;
+    int pass = 0;
+    int failed = 0;
+    const string archive = "test_book.hrec";
+    const string bookPath = "test_book.hbook";
+    remove(archive.c_str());
+
+    // deux premiers coups, joués sous les 8 symétries de la position de départ
+    srand(32);
+    const int GAMES = 24;
+    Move second[GAMES];
+    Game start;
+    start.itsBoard.itsSize = LITTLE;
+    createBoard(start.itsBoard);
+    initializeBoard(start.itsBoard);
+    Move startMoves[MAX_MOVES];
+    generateMoves(start, startMoves);
+
+    RecordWriter writer;
+    openRecordWriter(writer, archive);
+    for (int g = 0; g < GAMES; ++g) {
+        Game game;
+        game.itsBoard.itsSize = LITTLE;
+        createBoard(game.itsBoard);
+        initializeBoard(game.itsBoard);
+        beginRecord(writer, game);
+        for (int ply = 0; ply < 30 && !isGameFinished(game); ++ply) {
+            Move moves[MAX_MOVES];
+            Move move = moves[rand() % generateMoves(game, moves)];
+            if (ply == 0)
+                move = transformMove(startMoves[g % 2], g % SYMMETRY_COUNT, LITTLE);
+            if (ply == 1)
+                second[g] = move;
+            writeRecordMove(writer, game, move);
+            movePiece(game, move);
+            capturePieces(game, move);
+            switchCurrentPlayer(game);
+        }
+        endRecord(writer, game);
+        db(game.itsBoard.itsCells, LITTLE);
+    }
+    closeRecordWriter(writer);
+
+    OpeningBook book;
+    if (buildOpeningBook(archive, bookPath, 4) && openOpeningBook(book, bookPath)) {
+        cout << "PASS \t: book built (" << book.itsCount << " entries)" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: book not built" << endl;
+        failed++;
+    }
+
+    // les 8 variantes de chaque premier coup sont confondues
+    BookMove moves[BOOK_MAX_MOVES];
+    int count = probeOpeningBook(book, start, moves);
+    if (count == 2 && moves[0].itsGames == GAMES / 2 && moves[1].itsGames == GAMES / 2) {
+        cout << "PASS \t: symmetric first moves folded together" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: " << count << " first moves" << endl;
+        failed++;
+    }
+
+    // chaque second coup est retrouvé dans le repère de sa partie
+    bool found = true;
+    for (int g = 0; g < GAMES; ++g) {
+        Game game;
+        game.itsBoard.itsSize = LITTLE;
+        createBoard(game.itsBoard);
+        initializeBoard(game.itsBoard);
+        Move first = transformMove(startMoves[g % 2], g % SYMMETRY_COUNT, LITTLE);
+        movePiece(game, first);
+        capturePieces(game, first);
+        switchCurrentPlayer(game);
+        int n = probeOpeningBook(book, game, moves);
+        bool hasMove = false;
+        for (int i = 0; i < n; ++i)
+            hasMove = hasMove || getMoveIndex(game, moves[i].itsMove) == getMoveIndex(game, second[g]);
+        found = found && hasMove;
+
+        Move picked;
+        found = found && (!pickBookMove(book, game, picked) || getMoveIndex(game, picked) != -1);
+        db(game.itsBoard.itsCells, LITTLE);
+    }
+    if (found) {
+        cout << "PASS \t: second moves found in the frame of each game" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: second move missing" << endl;
+        failed++;
+    }
+
+    // position absente du livre
+    start.itsBoard.itsCells[0][3].itsPieceType = NONE;
+    Move picked;
+    if (probeOpeningBook(book, start, moves) == 0 && !pickBookMove(book, start, picked)) {
+        cout << "PASS \t: unknown position" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: unknown position found" << endl;
+        failed++;
+    }
+
+    closeOpeningBook(book);
+    db(start.itsBoard.itsCells, LITTLE);
+    remove(archive.c_str());
+    remove(bookPath.c_str());
+
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of openingBook *********" << endl << endl;
+}
+
+
+void test_evaluation()
+{
+    cout << "********* Start testing of evaluation *********" << endl;
+    int pass = 0;
+    int failed = 0;
+
+    srand(33);
+    BoardSize sizes[] = {LITTLE, BIG};
+    for (BoardSize size : sizes) {
+        Game game;
+        game.itsBoard.itsSize = size;
+        createBoard(game.itsBoard);
+        initializeBoard(game.itsBoard);
+        Evaluator evaluator;
+        attachEvaluator(evaluator, game);
+        int start[EVAL_FEATURE_COUNT];
+        computeFeatures(evaluator, game, start);
+
+        // termes incrémentaux identiques au calcul complet, avec movePiece/capturePieces et makeMove/unmakeMove
+        bool same = true;
+        for (int ply = 0; ply < 150 && !isGameFinished(game); ++ply) {
+            Move moves[MAX_MOVES];
+            int count = generateMoves(game, moves);
+            Move probe = moves[rand() % count];
+            MoveUndo undo;
+            makeMove(game, probe, undo);
+            same = same && evaluate(evaluator, game) == evaluatePosition(game);
+            unmakeMove(game, probe, undo);
+            same = same && evaluate(evaluator, game) == evaluatePosition(game);
+
+            Move move = moves[rand() % count];
+            movePiece(game, move);
+            capturePieces(game, move);
+            switchCurrentPlayer(game);
+            same = same && evaluate(evaluator, game) == evaluatePosition(game);
+        }
+        int features[EVAL_FEATURE_COUNT];
+        computeFeatures(evaluator, game, features);
+        if (same && start[EVAL_SWORDS] == 24 && start[EVAL_KING_CORNER_DISTANCE] == size - 1
+            && features[EVAL_SWORDS] <= start[EVAL_SWORDS]) {
+            cout << "PASS \t: " << size << "x" << size << " incremental features match a full scan" << endl;
+            pass++;
+        } else {
+            cout << "FAIL! \t: " << size << "x" << size << " same " << same << " swords " << start[EVAL_SWORDS] << endl;
+            failed++;
+        }
+        detachEvaluator(evaluator, game);
+        db(game.itsBoard.itsCells, size);
+    }
+
+    // roi à un coup d'une forteresse : bon pour la défense
+    Game game;
+    game.itsBoard.itsSize = LITTLE;
+    createBoard(game.itsBoard);
+    parsePosition("11/11/11/11/11/10K/11/11/11/11/3X7 d 11", game);
+    int features[EVAL_FEATURE_COUNT];
+    Evaluator evaluator;
+    attachEvaluator(evaluator, game);
+    computeFeatures(evaluator, game, features);
+    if (features[EVAL_KING_ROUTES_1] == 2 && features[EVAL_KING_HOSTILE_SIDES] == 1 && evaluate(evaluator, game) > 0) {
+        cout << "PASS \t: king with open lines to two fortresses" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: routes " << features[EVAL_KING_ROUTES_1] << " hostile sides " << features[EVAL_KING_HOSTILE_SIDES] << endl;
+        failed++;
+    }
+
+    // bouclier pris au prochain coup de l'attaque
+    parsePosition("11/11/11/11/11/5K5/11/2X8/11/2U8/2X1X6 a 11", game);
+    attachEvaluator(evaluator, game);
+    computeFeatures(evaluator, game, features);
+    if (features[EVAL_THREATENED_SHIELDS] == 1 && features[EVAL_THREATENED_SWORDS] == 0) {
+        cout << "PASS \t: threatened shield" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: threatened shields " << features[EVAL_THREATENED_SHIELDS] << " swords " << features[EVAL_THREATENED_SWORDS] << endl;
+        failed++;
+    }
+    detachEvaluator(evaluator, game);
+    db(game.itsBoard.itsCells, LITTLE);
+
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of evaluation *********" << endl << endl;
+}
+
+
+void test_nnue()
+{
+    cout << "********* Start testing of nnue *********" << endl;
+    int pass = 0;
+    int failed = 0;
+    const string path = "test_network.hnn";
+
+    NnueNetwork network;
+    if (createNnueNetwork(path, 34) && openNnueNetwork(network, path)) {
+        cout << "PASS \t: random network written and mapped" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: network not opened" << endl;
+        failed++;
+    }
+
+    // accumulateur incrémental identique à un calcul complet ; code vectoriel identique aux boucles
+    srand(34);
+    BoardSize sizes[] = {LITTLE, BIG};
+    for (BoardSize size : sizes) {
+        Game game;
+        game.itsBoard.itsSize = size;
+        createBoard(game.itsBoard);
+        initializeBoard(game.itsBoard);
+        NnueEvaluator evaluator;
+        attachNnue(evaluator, network, game);
+        bool same = true;
+        bool varied = false;
+        int first = evaluateNnue(evaluator, game);
+        for (int ply = 0; ply < 150 && !isGameFinished(game); ++ply) {
+            Move moves[MAX_MOVES];
+            int count = generateMoves(game, moves);
+            Move probe = moves[rand() % count];
+            MoveUndo undo;
+            makeMove(game, probe, undo);
+            unmakeMove(game, probe, undo);
+
+            Move move = moves[rand() % count];
+            movePiece(game, move);
+            capturePieces(game, move);
+            switchCurrentPlayer(game);
+
+            NnueEvaluator fresh;
+            attachNnue(fresh, network, game);
+            int score = evaluateNnue(fresh, game);
+            game.itsHooks = &evaluator.itsHooks; // l'évaluateur suivi reste branché
+            same = same && equal(fresh.itsAccumulator, fresh.itsAccumulator + NNUE_L1, evaluator.itsAccumulator)
+                   && score == evaluateNnueScalar(fresh, game);
+            varied = varied || score != first;
+        }
+        if (same && varied) {
+            cout << "PASS \t: " << size << "x" << size << " incremental accumulator and " << (hasNnueAvx2() ? "AVX2" : "scalar") << " code" << endl;
+            pass++;
+        } else {
+            cout << "FAIL! \t: " << size << "x" << size << " same " << same << " varied " << varied << endl;
+            failed++;
+        }
+        detachNnue(evaluator, game);
+        db(game.itsBoard.itsCells, size);
+    }
+    closeNnueNetwork(network);
+
+    // fichier tronqué refusé
+    {
+        ofstream file(path, ios::binary | ios::trunc);
+        file << "HFATNNU1";
+    }
+    if (!openNnueNetwork(network, path)) {
+        cout << "PASS \t: truncated network refused" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: truncated network accepted" << endl;
+        closeNnueNetwork(network);
+        failed++;
+    }
+    remove(path.c_str());
+
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of nnue *********" << endl << endl;
+}
+
+
+void test_selfPlay()
+{
+    cout << "********* Start testing of selfPlay *********" << endl;
+    int pass = 0;
+    int failed = 0;
+
+    SelfPlayConfig config;
+    config.itsGames = 6;
+    config.itsThreads = 2;
+    config.itsMaxPlies = 60;
+    config.itsSamplesPerShard = 100;
+    config.itsDedupBits = 12;
+    config.itsSeed = 35;
+    config.itsPrefix = "test_selfplay";
+    SelfPlayReport report;
+    bool generated = generateSelfPlay(config, report);
+    if (generated && report.itsSamples > 0 && report.itsShards == int((report.itsSamples + 99) / 100)
+        && report.itsDuplicates >= config.itsGames - 1) {
+        cout << "PASS \t: " << report.itsSamples << " samples in " << report.itsShards << " shards, "
+             << report.itsDuplicates << " duplicates dropped" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: generation " << generated << ", " << report.itsSamples << " samples in " << report.itsShards << " shards" << endl;
+        failed++;
+    }
+
+    // chaque échantillon est une position valide, unique à une symétrie près, avec un résultat
+    vector<uint64_t> keys;
+    bool valid = true;
+    uint64_t total = 0;
+    Game game;
+    for (int s = 0; s < report.itsShards; ++s) {
+        SampleShard shard;
+        if (!openSampleShard(shard, getShardName(config.itsPrefix, s))) {
+            valid = false;
+            continue;
+        }
+        total += shard.itsCount;
+        for (uint64_t i = 0; i < shard.itsCount; ++i) {
+            const TrainingSample& sample = shard.itsSamples[i];
+            valid = valid && unpackPosition(sample.itsPosition, game) && sample.itsResult >= -1 && sample.itsResult <= 1;
+            keys.push_back(getCanonicalKey(game));
+        }
+        closeSampleShard(shard);
+        remove(getShardName(config.itsPrefix, s).c_str());
+    }
+    sort(keys.begin(), keys.end());
+    if (valid && total == report.itsSamples && adjacent_find(keys.begin(), keys.end()) == keys.end()) {
+        cout << "PASS \t: shards read back without duplicate position" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: valid " << valid << ", " << total << " samples read" << endl;
+        failed++;
+    }
+    deleteBoard(game.itsBoard);
+
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of selfPlay *********" << endl << endl;
+}
+
+
+void test_tuner()
+{
+    cout << "********* Start testing of tuner *********" << endl;
+    int pass = 0;
+    int failed = 0;
+
+    SelfPlayConfig config;
+    config.itsGames = 40;
+    config.itsThreads = 2;
+    config.itsMaxPlies = 120;
+    config.itsSeed = 36;
+    config.itsPrefix = "test_tuner";
+    SelfPlayReport report;
+    generateSelfPlay(config, report);
+    vector<string> paths;
+    for (int s = 0; s < report.itsShards; ++s)
+        paths.push_back(getShardName(config.itsPrefix, s));
+
+    TunerData data;
+    if (loadTunerData(paths, data, 2) && data.itsTargets.size() == report.itsSamples
+        && data.itsOffsets.size() == data.itsTargets.size() + 1 && data.itsOffsets.back() == data.itsFeatures.size()) {
+        cout << "PASS \t: " << data.itsTargets.size() << " positions loaded (" << data.itsFeatures.size() << " features)" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: " << data.itsTargets.size() << " positions loaded for " << report.itsSamples << " samples" << endl;
+        failed++;
+    }
+
+    // la perte doit baisser en partant des poids par défaut
+    TunerConfig tuning;
+    tuning.itsEpochs = 20;
+    tuning.itsBatch = 512;
+    tuning.itsThreads = 2;
+    EvalWeights weights = DEFAULT_EVAL_WEIGHTS;
+    double before = getTunerLoss(data, weights, tuning);
+    double after = tuneEvalWeights(data, tuning, weights);
+    if (after < before) {
+        cout << "PASS \t: loss " << before << " -> " << after << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: loss " << before << " -> " << after << endl;
+        failed++;
+    }
+
+    EvalWeights loaded;
+    bool same = saveEvalWeights(weights, "test_tuner.weights") && loadEvalWeights(loaded, "test_tuner.weights");
+    for (int f = 0; f < EVAL_FEATURE_COUNT && same; ++f)
+        same = loaded.itsValues[f] == weights.itsValues[f];
+    if (same && !loadEvalWeights(loaded, "test_tuner_missing.weights")) {
+        cout << "PASS \t: weights saved and loaded" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: weights not saved or loaded" << endl;
+        failed++;
+    }
+
+    for (const string& path : paths)
+        remove(path.c_str());
+    remove("test_tuner.weights");
+
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of tuner *********" << endl << endl;
+}
+
+
+void test_search()
+{
+    cout << "********* Start testing of search *********" << endl;
+    int pass = 0;
+    int failed = 0;
+
+    Game game;
+    game.itsBoard.itsSize = LITTLE;
+    createBoard(game.itsBoard);
+    initializeBoard(game.itsBoard);
+
+    // plusieurs lignes distinctes, triées, dont les variantes sont jouables
+    AnalysisConfig config;
+    config.itsLines = 3;
+    config.itsMaxDepth = 3;
+    AnalysisInfo info = analysePosition(game, config, AnalysisCallback());
+    bool valid = info.itsDepth == 3 && info.itsLines.size() == 3;
+    for (size_t k = 0; k < info.itsLines.size() && valid; ++k) {
+        const AnalysisLine& line = info.itsLines[k];
+        valid = !line.itsPv.empty() && getMoveIndex(game, line.itsPv[0]) == getMoveIndex(game, line.itsMove)
+                && (k == 0 || (line.itsScore <= info.itsLines[k - 1].itsScore
+                               && getMoveIndex(game, line.itsMove) != getMoveIndex(game, info.itsLines[0].itsMove)));
+        Game replay;
+        PackedBoard packed;
+        packPosition(game, packed);
+        unpackPosition(packed, replay);
+        for (const Move& move : line.itsPv) {
+            valid = valid && isValidMovement(replay, move);
+            MoveUndo undo;
+            makeMove(replay, move, undo);
+        }
+        db(replay.itsBoard.itsCells, replay.itsBoard.itsSize);
+    }
+    if (valid) {
+        cout << "PASS \t: " << formatAnalysisJson(info) << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: " << formatAnalysisJson(info) << endl;
+        failed++;
+    }
+
+    // le roi s'échappe en un coup
+    for (int i = 0; i < game.itsBoard.itsSize; ++i)
+        for (int j = 0; j < game.itsBoard.itsSize; ++j)
+            game.itsBoard.itsCells[i][j].itsPieceType = NONE;
+    game.itsBoard.itsCells[0][3].itsPieceType = KING;
+    game.itsBoard.itsCells[10][5].itsPieceType = SWORD;
+    game.itsBoard.itsCells[5][5].itsPieceType = SWORD;
+    game.itsCurrentPlayer = &game.itsPlayer2;
+    config.itsLines = 1;
+    config.itsMaxDepth = 6;
+    info = analysePosition(game, config, AnalysisCallback());
+    if (info.itsLines.size() == 1 && getWinDistance(info.itsLines[0].itsScore) == 1
+        && info.itsLines[0].itsMove.itsEndPosition.itsCol % 10 == 0 && info.itsDepth < 6) {
+        cout << "PASS \t: " << formatAnalysisJson(info) << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: " << formatAnalysisJson(info) << endl;
+        failed++;
+    }
+
+    // analyse sur le thread de travail : une ligne JSON par profondeur
+    initializeBoard(game.itsBoard);
+    game.itsCurrentPlayer = &game.itsPlayer1;
+    Analysis analysis;
+    mutex received;
+    vector<string> json;
+    config.itsLines = 2;
+    config.itsMaxDepth = 4;
+    startAnalysis(analysis, game, config, [&](const AnalysisInfo& aInfo) {
+        lock_guard<mutex> lock(received);
+        json.push_back(formatAnalysisJson(aInfo));
+    });
+    waitAnalysis(analysis);
+    bool ordered = json.size() == 4 && !analysis.itsRunning;
+    for (size_t d = 0; d < json.size() && ordered; ++d)
+        ordered = json[d].compare(0, 10, "{\"depth\":" + to_string(d + 1)) == 0;
+    if (ordered) {
+        cout << "PASS \t: " << json.size() << " depths reported by the worker" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: " << json.size() << " depths reported by the worker" << endl;
+        failed++;
+    }
+
+    // arrêt d'une analyse sans limite
+    config.itsMaxDepth = SEARCH_MAX_PLY;
+    startAnalysis(analysis, game, config, AnalysisCallback());
+    this_thread::sleep_for(chrono::milliseconds(50));
+    stopAnalysis(analysis);
+    if (!analysis.itsRunning && !analysis.itsThread.joinable()) {
+        cout << "PASS \t: analysis stopped" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: analysis not stopped" << endl;
+        failed++;
+    }
+
+    db(game.itsBoard.itsCells, game.itsBoard.itsSize);
+
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of search *********" << endl << endl;
+}
+
+
+void test_clock()
+{
+    cout << "********* Start testing of clock *********" << endl;
+    int pass = 0;
+    int failed = 0;
+
+    TimeControl fischer, byoyomi, none, invalid;
+    if (parseTimeControl("300+5", fischer) && fischer.itsMode == CLOCK_FISCHER && fischer.itsMainTime == 300 * CLOCK_SECOND
+        && fischer.itsIncrement == 5 * CLOCK_SECOND && parseTimeControl("10/30x3", byoyomi) && byoyomi.itsMode == CLOCK_BYOYOMI
+        && byoyomi.itsPeriod == 30 * CLOCK_SECOND && byoyomi.itsPeriods == 3 && parseTimeControl("0", none) && none.itsMode == CLOCK_NONE
+        && !parseTimeControl("abc", invalid) && !parseTimeControl("300+", invalid) && !parseTimeControl("600/30x0", invalid)
+        && formatClockTime(247300000) == "4:07.3" && formatClockTime(-5) == "0:00.0") {
+        cout << "PASS \t: time controls read and times written" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: time controls read and times written" << endl;
+        failed++;
+    }
+
+    // Fischer : temps consommé puis incrément ; drapeau si le temps principal est dépassé
+    GameClock clock;
+    initializeClock(clock, fischer);
+    startClock(clock, ATTACK, 1000);
+    bool kept = stopClock(clock, 1000 + 10 * CLOCK_SECOND) && clock.itsMainTime[ATTACK] == 295 * CLOCK_SECOND;
+    startClock(clock, DEFENSE, 0);
+    int64_t toFlag = getTimeToFlag(clock, DEFENSE, 100 * CLOCK_SECOND);
+    bool flagged = !stopClock(clock, 301 * CLOCK_SECOND) && clock.itsFlagged[DEFENSE] && getTimeToFlag(clock, DEFENSE, 0) == 0;
+    if (kept && flagged && toFlag == 200 * CLOCK_SECOND) {
+        cout << "PASS \t: Fischer clock" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: Fischer clock" << endl;
+        failed++;
+    }
+
+    // byo-yomi : temps principal, puis périodes perdues quand elles sont entièrement consommées
+    initializeClock(clock, byoyomi);
+    bool ok = true;
+    startClock(clock, ATTACK, 0);
+    ok = ok && stopClock(clock, 15 * CLOCK_SECOND) && clock.itsMainTime[ATTACK] == 0 && clock.itsPeriods[ATTACK] == 3;
+    startClock(clock, ATTACK, 0);
+    ok = ok && stopClock(clock, 65 * CLOCK_SECOND) && clock.itsPeriods[ATTACK] == 1;
+    startClock(clock, ATTACK, 0);
+    ok = ok && getTimeToFlag(clock, ATTACK, 10 * CLOCK_SECOND) == 20 * CLOCK_SECOND;
+    ok = ok && stopClock(clock, 29 * CLOCK_SECOND) && clock.itsPeriods[ATTACK] == 1;
+    startClock(clock, ATTACK, 0);
+    ok = ok && !stopClock(clock, 30 * CLOCK_SECOND) && clock.itsFlagged[ATTACK];
+    if (ok) {
+        cout << "PASS \t: byo-yomi clock" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: byo-yomi clock" << endl;
+        failed++;
+    }
+
+    // répartition : plus de temps pour une position ouverte, jamais au-delà du drapeau
+    TimeControl blitz;
+    parseTimeControl("60+1", blitz);
+    initializeClock(clock, blitz);
+    MoveBudget narrow = allocateTime(clock, ATTACK, 10, 0);
+    MoveBudget wide = allocateTime(clock, ATTACK, 150, 0);
+    clock.itsMainTime[ATTACK] = 20000;
+    MoveBudget empty = allocateTime(clock, ATTACK, 150, 0);
+    initializeClock(clock, byoyomi);
+    clock.itsMainTime[ATTACK] = 0;
+    MoveBudget period = allocateTime(clock, ATTACK, 80, 40);
+    if (narrow.itsSoft > 0 && narrow.itsSoft < wide.itsSoft && wide.itsHard >= wide.itsSoft
+        && wide.itsHard <= 60 * CLOCK_SECOND - CLOCK_OVERHEAD && empty.itsHard == 0
+        && period.itsHard <= byoyomi.itsPeriod - CLOCK_OVERHEAD && period.itsSoft <= period.itsHard
+        && !isSoftDeadlineReached(wide, wide.itsSoft, 0) && isSoftDeadlineReached(wide, wide.itsSoft, 3)
+        && isSoftDeadlineReached(wide, wide.itsHard, 0)) {
+        cout << "PASS \t: budgets " << formatClockTime(narrow.itsSoft) << " / " << formatClockTime(wide.itsSoft)
+             << " (hard " << formatClockTime(wide.itsHard) << ")" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: budgets " << narrow.itsSoft << " / " << wide.itsSoft << " (hard " << wide.itsHard << ")" << endl;
+        failed++;
+    }
+
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of clock *********" << endl << endl;
+}
+
+
+void test_searchStats()
+{
+    cout << "********* Start testing of searchStats *********" << endl;
+    int pass = 0;
+    int failed = 0;
+
+    Game game;
+    game.itsBoard.itsSize = LITTLE;
+    createBoard(game.itsBoard);
+    initializeBoard(game.itsBoard);
+    AnalysisConfig config;
+    config.itsLines = 2;
+    config.itsMaxDepth = 4;
+    config.itsTiming = true;
+    AnalysisInfo info = analysePosition(game, config, AnalysisCallback());
+    const SearchStats& stats = info.itsStats;
+
+    uint64_t depthNodes = 0;
+    for (int d = 0; d < STATS_MAX_DEPTH; ++d)
+        depthNodes += stats.itsDepthNodes[d];
+    if (stats.itsNodes == info.itsNodes && depthNodes == stats.itsNodes && stats.itsMaxDepth == 4
+        && stats.itsQuiescenceNodes > 0 && stats.itsQuiescenceNodes < stats.itsNodes
+        && stats.itsCutoffs > 0 && stats.itsFirstMoveCutoffs <= stats.itsCutoffs
+        && stats.itsTableHits + stats.itsTableCollisions <= stats.itsTableProbes && stats.itsTableHits > 0
+        && getBranchingFactor(stats, 2) > 1 && getBranchingFactor(stats, 1) == 0
+        && stats.itsMoveGenTime > 0 && stats.itsCaptureTime > 0 && stats.itsEvalTime > 0) {
+        cout << "PASS \t: " << formatStatsJson(stats) << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: " << formatStatsJson(stats) << endl;
+        failed++;
+    }
+
+    // les compteurs d'un autre thread ne touchent pas ceux de ce thread ; sans demande, pas de chronométrage
+    config.itsTiming = false;
+    Analysis analysis;
+    SearchStats workerStats;
+    startAnalysis(analysis, game, config, [&workerStats](const AnalysisInfo& aInfo) { workerStats = aInfo.itsStats; });
+    waitAnalysis(analysis);
+    SearchStats total;
+    mergeSearchStats(total, threadStats);
+    mergeSearchStats(total, workerStats);
+    if (threadStats.itsNodes == stats.itsNodes && !threadStats.itsTiming && workerStats.itsNodes > 0
+        && !workerStats.itsTiming && workerStats.itsMoveGenTime == 0 && workerStats.itsEvalTime == 0
+        && total.itsNodes == stats.itsNodes + workerStats.itsNodes && total.itsMaxDepth == 4
+        && total.itsDepthNodes[4] == stats.itsDepthNodes[4] + workerStats.itsDepthNodes[4]) {
+        cout << "PASS \t: thread counters merged" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: thread counters merged" << endl;
+        failed++;
+    }
+
+    string json = formatStatsJson(total);
+    string summary = formatStatsSummary(total);
+    if (json.compare(0, 9, "{\"nodes\":") == 0 && json.find("\"ebf\":[0,") != string::npos && json.back() == '}'
+        && count(summary.begin(), summary.end(), '\n') == 5) {
+        cout << "PASS \t: JSON and summary written" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: JSON and summary written" << endl;
+        failed++;
+    }
+
+    resetThreadStats();
+    db(game.itsBoard.itsCells, game.itsBoard.itsSize);
+
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of searchStats *********" << endl << endl;
+}
+
+
+void test_pondering()
+{
+    cout << "********* Start testing of pondering *********" << endl;
+    int pass = 0;
+    int failed = 0;
+
+    Game game;
+    game.itsBoard.itsSize = LITTLE;
+    createBoard(game.itsBoard);
+    initializeBoard(game.itsBoard);
+    TranspositionTable table;
+    createTranspositionTable(table, 18);
+
+    // recherche sur le temps de l'adversaire, puis coup de l'ordinateur après la réponse attendue
+    AnalysisConfig ponder;
+    ponder.itsLines = 1;
+    ponder.itsMaxDepth = 5;
+    ponder.itsTable = &table;
+    AnalysisInfo pondered = analysePosition(game, ponder, AnalysisCallback());
+    Move reply = pondered.itsLines[0].itsMove;
+    MoveUndo undo;
+    makeMove(game, reply, undo);
+    MoveBudget unlimited = {INT64_MAX, INT64_MAX};
+    Move warmMove, coldMove;
+    AnalysisInfo warm, cold;
+    bool found = searchMove(game, unlimited, &table, warmMove, &warm, 4) && searchMove(game, unlimited, nullptr, coldMove, &cold, 4);
+    if (found && warm.itsDepth == 4 && cold.itsDepth == 4 && warm.itsNodes < cold.itsNodes && isValidMovement(game, warmMove)) {
+        cout << "PASS \t: " << warm.itsNodes << " nodes after pondering instead of " << cold.itsNodes << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: " << warm.itsNodes << " nodes after pondering instead of " << cold.itsNodes << endl;
+        failed++;
+    }
+
+    // la recherche de fond s'arrête dès que la saisie est faite
+    Analysis analysis;
+    ponder.itsMaxDepth = SEARCH_MAX_PLY - 1;
+    startAnalysis(analysis, game, ponder, AnalysisCallback());
+    this_thread::sleep_for(chrono::milliseconds(100));
+    int64_t start = getClockTime();
+    stopAnalysis(analysis);
+    int64_t stopTime = getClockTime() - start;
+    if (!analysis.itsRunning && stopTime < CLOCK_SECOND / 10) {
+        cout << "PASS \t: pondering stopped in " << stopTime << " us" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: pondering stopped in " << stopTime << " us" << endl;
+        failed++;
+    }
+
+    // le coup est rendu dans le délai dur
+    MoveBudget budget = {CLOCK_SECOND / 20, CLOCK_SECOND / 5};
+    start = getClockTime();
+    Move move;
+    AnalysisInfo info;
+    bool moved = searchMove(game, budget, &table, move, &info);
+    int64_t moveTime = getClockTime() - start;
+    if (moved && isValidMovement(game, move) && moveTime < CLOCK_SECOND / 2) {
+        cout << "PASS \t: move found at depth " << info.itsDepth << " in " << moveTime << " us" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: move found at depth " << info.itsDepth << " in " << moveTime << " us" << endl;
+        failed++;
+    }
+
+    db(game.itsBoard.itsCells, game.itsBoard.itsSize);
+
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of pondering *********" << endl << endl;
+}
+
+
+void test_render()
+{
+    cout << "********* Start testing of render *********" << endl;
+    int pass = 0;
+    int failed = 0;
+
+    Board board = {nullptr, LITTLE};
+    createBoard(board);
+    initializeBoard(board);
+    BoardRenderer renderer;
+
+    // image complète : même disposition que l'ancien affichage, couleurs ANSI
+    composeFrame(renderer, board, false);
+    string frame = renderer.itsFrame;
+    int lines = 0;
+    for (char c : frame)
+        lines += (c == '\n');
+    if (lines == 2 * LITTLE + 3 && frame.find("\x1b[H") == string::npos && frame.find("| \x1b[91mX\x1b[0m |") != string::npos
+        && frame.find("| K ") == string::npos && frame.find("\x1b[31mK") != string::npos && getAnsiColor(4, 0) == "\x1b[31;40m"
+        && getAnsiColor(12, 0) == "\x1b[91;40m" && getAnsiColor(0, 0) == "\x1b[0m" && composeChanges(renderer, board) == -1) {
+        cout << "PASS \t: full frame of " << frame.size() << " bytes" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: full frame of " << frame.size() << " bytes" << endl;
+        failed++;
+    }
+
+    // après une image ancrée, un coup ne redessine que ses deux cases, dans le même tampon
+    composeFrame(renderer, board, true);
+    const char* buffer = renderer.itsFrame.data();
+    bool anchored = renderer.itsFrame.compare(0, 7, "\x1b[H\x1b[2J") == 0;
+    board.itsCells[0][3].itsPieceType = NONE;
+    board.itsCells[1][3].itsPieceType = SWORD;
+    int changes = composeChanges(renderer, board);
+    string diff = renderer.itsFrame;
+    if (anchored && changes == 2 && diff.find("\x1b[4;19H \x1b[6;19H\x1b[91mX") == 0 && diff.size() < 64
+        && renderer.itsFrame.data() == buffer && composeChanges(renderer, board) == 0) {
+        cout << "PASS \t: move redrawn in " << diff.size() << " bytes" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: move redrawn in " << diff.size() << " bytes" << endl;
+        failed++;
+    }
+
+    db(board.itsCells, board.itsSize);
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of render *********" << endl << endl;
+}
+
+
+void test_batch()
+{
+    cout << "********* Start testing of batch *********" << endl;
+    int pass = 0;
+    int failed = 0;
+
+    // partie jouée au hasard parmi les coups générés, jusqu'à sa fin
+    Game game;
+    game.itsPlayer1.itsName = "alice";
+    game.itsPlayer2.itsName = "bob";
+    game.itsBoard.itsSize = LITTLE;
+    createBoard(game.itsBoard);
+    initializeBoard(game.itsBoard);
+    string line = "11 alice bob";
+    unsigned seed = 7;
+    int plies = 0;
+    while (!isGameFinished(game) && plies < 2000) {
+        Move moves[MAX_MOVES];
+        int count = generateMoves(game, moves);
+        if (count == 0)
+            break;
+        seed = seed * 1103515245 + 12345;
+        Move move = moves[(seed >> 16) % count];
+        char text[MOVE_STRING_SIZE];
+        formatMove(move, text, MOVE_STRING_SIZE);
+        line += string(" ") + text;
+        movePiece(game, move);
+        capturePieces(game, move);
+        switchCurrentPlayer(game);
+        plies++;
+    }
+    bool over = isGameFinished(game);
+    const Player* winner = whoWon(game);
+    string expected = over ? "1 victoire " + to_string(plies) + " " + winner->itsName
+                                               + (winner->itsRole == ATTACK ? " attaque" : " defense")
+                                           : "1 inachevee " + to_string(plies) + " -";
+    db(game.itsBoard.itsCells, game.itsBoard.itsSize);
+
+    istringstream input(line + "\n\n# commentaire\n13 carol dave\n11 erin frank a4-c4 a4-a5\n12 x y\n"
+                        "11 gina hugo a4-c4 zz\n" + line + " a4-c4\n");
+    ostringstream output;
+    BatchReport report;
+    runBatch(input, output, report);
+    string results = output.str();
+    string lines[6];
+    istringstream reader(results);
+    for (int i = 0; i < 6; ++i)
+        getline(reader, lines[i]);
+    if (lines[0] == expected && lines[1] == "2 inachevee 0 -" && lines[2] == "3 illegal 1 a4-a5" && lines[3] == "4 invalide 0 12"
+        && lines[4] == "5 invalide 1 zz" && report.itsGames == 6 && report.itsCounts[BATCH_INVALID] == 2) {
+        cout << "PASS \t: results of the games read" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: results of the games read" << endl << results;
+        failed++;
+    }
+
+    // des coups après la fin de la partie sont refusés
+    bool afterEnd = over ? lines[5] == "6 illegal " + to_string(plies) + " a4-c4" : lines[5].compare(0, 2, "6 ") == 0;
+    if (afterEnd) {
+        cout << "PASS \t: move after the end of the game" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: move after the end of the game : " << lines[5] << endl;
+        failed++;
+    }
+
+    // débit : la même partie rejouée en boucle
+    string many;
+    for (int i = 0; i < 2000; ++i)
+        many += line + "\n";
+    istringstream manyInput(many);
+    ostringstream manyOutput;
+    runBatch(manyInput, manyOutput, report);
+    if (report.itsGames == 2000 && report.itsCounts[over ? BATCH_FINISHED : BATCH_UNFINISHED] == 2000) {
+        cout << "PASS \t: " << int(report.itsGames / max(report.itsSeconds, 1e-6)) << " games per second (" << plies << " plies each)" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: 2000 games replayed" << endl;
+        failed++;
+    }
+
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of batch *********" << endl << endl;
+}
+
+
+void test_engine()
+{
+    cout << "********* Start testing of engine *********" << endl;
+    int pass = 0;
+    int failed = 0;
+
+    ostringstream output;
+    Engine engine;
+    initializeEngine(engine, output);
+
+    // position, coups et recherche bornée
+    handleEngineCommand(engine, "hnef");
+    handleEngineCommand(engine, "position startpos moves a4-c4");
+    handleEngineCommand(engine, "print");
+    handleEngineCommand(engine, "moves a1-a2");
+    handleEngineCommand(engine, "go depth 3");
+    waitEngine(engine);
+    string text = output.str();
+    size_t best = text.find("bestmove ");
+    Move move;
+    bool legal = best != string::npos && parseMove(text.c_str() + best + 9, engine.itsGame.itsBoard, move)
+                 && isValidMovement(engine.itsGame, move);
+    if (text.find("hnefok") != string::npos && text.find("position 4XXXX3/5X5/3X7/") != string::npos
+        && text.find("info string illegal move a1-a2") != string::npos && text.find("info depth 3 ") != string::npos
+        && legal && engine.itsGame.itsCurrentPlayer->itsRole == DEFENSE) {
+        cout << "PASS \t: position set and move searched" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: position set and move searched" << endl << text;
+        failed++;
+    }
+
+    // les commandes restent lues pendant la recherche, et stop l'interrompt aussitôt
+    output.str("");
+    handleEngineCommand(engine, "go infinite");
+    this_thread::sleep_for(chrono::milliseconds(100));
+    {
+        lock_guard<mutex> lock(engine.itsOutputLock);
+        output.str("");
+    }
+    handleEngineCommand(engine, "isready");
+    bool ready = false;
+    {
+        lock_guard<mutex> lock(engine.itsOutputLock);
+        ready = output.str().find("readyok") != string::npos;
+    }
+    int64_t start = getClockTime();
+    handleEngineCommand(engine, "stop");
+    int64_t stopTime = getClockTime() - start;
+    if (ready && !engine.itsSearching && stopTime < CLOCK_SECOND / 100 && output.str().find("bestmove ") != string::npos) {
+        cout << "PASS \t: search stopped in " << stopTime << " us" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: search stopped in " << stopTime << " us" << endl;
+        failed++;
+    }
+
+    // fin de partie : aucun coup
+    output.str("");
+    handleEngineCommand(engine, "position 11/11/11/11/11/5K5/11/11/11/11/11 a 11");
+    handleEngineCommand(engine, "go depth 2");
+    waitEngine(engine);
+    bool quit = !handleEngineCommand(engine, "quit");
+    if (output.str() == "bestmove none\n" && quit) {
+        cout << "PASS \t: finished game and quit" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: finished game and quit" << endl << output.str();
+        failed++;
+    }
+
+    releaseEngine(engine);
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of engine *********" << endl << endl;
+}
+
+
+#ifdef __linux__
+struct TestClient
+{
+    int itsFd = -1;
+    string itsInput;
+};
+
+static bool connectClient(TestClient& aClient, int aPort)
+{
+    aClient.itsFd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(uint16_t(aPort));
+    int on = 1;
+    setsockopt(aClient.itsFd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    return connect(aClient.itsFd, (sockaddr*)&address, sizeof(address)) == 0;
+}
+
+static void sendClient(TestClient& aClient, const string& aLine)
+{
+    string line = aLine + "\n";
+    ssize_t written = send(aClient.itsFd, line.data(), line.size(), MSG_NOSIGNAL);
+    (void)written;
+}
+
+// ligne suivante du serveur, ou "" après deux secondes sans réponse
+static string readClient(TestClient& aClient)
+{
+    size_t end;
+    while ((end = aClient.itsInput.find('\n')) == string::npos) {
+        pollfd ready = {aClient.itsFd, POLLIN, 0};
+        char buffer[1024];
+        ssize_t got = (poll(&ready, 1, 2000) > 0) ? recv(aClient.itsFd, buffer, sizeof(buffer), 0) : 0;
+        if (got <= 0)
+            return "";
+        aClient.itsInput.append(buffer, size_t(got));
+    }
+    string line = aClient.itsInput.substr(0, end);
+    aClient.itsInput.erase(0, end + 1);
+    return line;
+}
+#endif
+
+void test_server()
+{
+    cout << "********* Start testing of server *********" << endl;
+    int pass = 0;
+    int failed = 0;
+
+#ifdef __linux__
+    Server server;
+    ServerConfig config;
+    config.itsPort = 0;
+    config.itsThreads = 2;
+    if (!startServer(server, config)) {
+        cout << "FAIL! \t: server started" << endl;
+        cout << "Totals: 0 passed, 1 failed" << endl;
+        return;
+    }
+
+    // création, arrivée de l'adversaire, coups refusés puis joué, abandon
+    TestClient alice, bob;
+    connectClient(alice, server.itsPort);
+    connectClient(bob, server.itsPort);
+    sendClient(alice, "create 11 alice");
+    string created = readClient(alice);
+    string id = created.substr(created.find(' ') + 1);
+    sendClient(bob, "join " + id + " bob");
+    bool started = readClient(alice) == "start " + id + " attaque bob" && readClient(bob) == "start " + id + " defense alice";
+    sendClient(bob, "move a4-c4");
+    bool notTurn = readClient(bob) == "error not your turn";
+    sendClient(alice, "move a4-a5");
+    bool illegal = readClient(alice) == "error illegal move";
+    sendClient(alice, "move a4-c4");
+    bool moved = readClient(alice) == "moved a4-c4" && readClient(bob) == "moved a4-c4";
+    sendClient(bob, "resign");
+    bool resigned = readClient(alice) == "end attaque alice 1 abandon" && readClient(bob) == "end attaque alice 1 abandon";
+    if (created.compare(0, 8, "created ") == 0 && started && notTurn && illegal && moved && resigned) {
+        cout << "PASS \t: game played over the protocol" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: game played over the protocol" << endl;
+        failed++;
+    }
+    close(alice.itsFd);
+    close(bob.itsFd);
+
+    // nombreux joueurs : parties réparties sur les boucles, latence de chaque coup
+    const int GAMES = 200;
+    const int PLIES = 10;
+    vector<TestClient> clients(2 * GAMES);
+    vector<Game> mirrors(GAMES);
+    bool ready = true;
+    for (int g = 0; g < GAMES; ++g) {
+        TestClient& attacker = clients[2 * g];
+        TestClient& defender = clients[2 * g + 1];
+        connectClient(attacker, server.itsPort);
+        connectClient(defender, server.itsPort);
+        sendClient(attacker, "create 11 a" + to_string(g));
+        string answer = readClient(attacker);
+        sendClient(defender, "join " + answer.substr(answer.find(' ') + 1) + " d" + to_string(g));
+        ready = ready && readClient(attacker).compare(0, 6, "start ") == 0 && readClient(defender).compare(0, 6, "start ") == 0;
+        mirrors[g].itsBoard.itsSize = LITTLE;
+        createBoard(mirrors[g].itsBoard);
+        initializeBoard(mirrors[g].itsBoard);
+    }
+    bool games = getServerGames(server) == GAMES;
+    vector<int64_t> latencies;
+    for (int ply = 0; ply < PLIES; ++ply) {
+        for (int g = 0; g < GAMES; ++g) {
+            Game& mirror = mirrors[g];
+            if (isGameFinished(mirror))
+                continue;
+            Move moves[MAX_MOVES];
+            int count = generateMoves(mirror, moves);
+            Move move = moves[(ply * 7 + g) % count];
+            char text[MOVE_STRING_SIZE];
+            formatMove(move, text, MOVE_STRING_SIZE);
+            int mover = (mirror.itsCurrentPlayer->itsRole == ATTACK) ? 2 * g : 2 * g + 1;
+            int64_t start = getClockTime();
+            sendClient(clients[mover], string("move ") + text);
+            ready = ready && readClient(clients[mover]) == string("moved ") + text;
+            latencies.push_back(getClockTime() - start);
+            ready = ready && readClient(clients[mover ^ 1]) == string("moved ") + text;
+            movePiece(mirror, move);
+            capturePieces(mirror, move);
+            switchCurrentPlayer(mirror);
+            if (isGameFinished(mirror)) {
+                readClient(clients[mover]);
+                readClient(clients[mover ^ 1]);
+            }
+        }
+    }
+    sort(latencies.begin(), latencies.end());
+    int64_t p99 = latencies[latencies.size() * 99 / 100];
+    if (ready && games && p99 < CLOCK_SECOND / 100) {
+        cout << "PASS \t: " << GAMES << " games, " << latencies.size() << " moves, p99 latency " << p99 << " us" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: " << GAMES << " games, " << latencies.size() << " moves, p99 latency " << p99 << " us" << endl;
+        failed++;
+    }
+
+    // les joueurs qui partent terminent leurs parties
+    for (TestClient& client : clients)
+        close(client.itsFd);
+    for (Game& mirror : mirrors)
+        deleteBoard(mirror.itsBoard);
+    for (int wait = 0; wait < 200 && getServerGames(server) > 0; ++wait)
+        this_thread::sleep_for(chrono::milliseconds(5));
+    if (getServerGames(server) == 0 && getServerMoves(server) == uint64_t(latencies.size() + 1)) {
+        cout << "PASS \t: games closed with their connections" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: games closed with their connections" << endl;
+        failed++;
+    }
+    stopServer(server);
+#else
+    cout << "PASS \t: no epoll server on this system" << endl;
+    pass++;
+#endif
+
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of server *********" << endl << endl;
+}
+
+
+void test_gamePool()
+{
+    cout << "********* Start testing of game pool *********" << endl;
+    int pass = 0;
+    int failed = 0;
+
+    // parties prises sur la position de départ, poignées périmées après libération
+    GamePool pool;
+    vector<GameHandle> handles(300);
+    bool initialized = true;
+    for (GameHandle& handle : handles) {
+        initialized = initialized && acquireGame(pool, LITTLE, handle);
+        Game* game = getPooledGame(pool, handle);
+        initialized = initialized && game != nullptr && game->itsBoard.itsCells[5][5].itsPieceType == KING
+                      && game->itsCurrentPlayer == &game->itsPlayer1 && game->itsBoard.itsSize == LITTLE;
+    }
+    GameHandle stale = handles[10];
+    bool released = releaseGame(pool, stale) && !releaseGame(pool, stale) && getPooledGame(pool, stale) == nullptr;
+    GameHandle reused;
+    acquireGame(pool, BIG, reused);
+    bool reusedSlot = reused.itsSlot == stale.itsSlot && reused.itsGeneration != stale.itsGeneration
+                      && getPooledGame(pool, stale) == nullptr && getPooledGame(pool, reused)->itsBoard.itsCells[6][6].itsPieceType == KING;
+    if (initialized && released && reusedSlot && getPoolCapacity(pool) == 2 * POOL_SLAB_SLOTS && pool.itsLiveGames == 300) {
+        cout << "PASS \t: games acquired and released" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: games acquired and released" << endl;
+        failed++;
+    }
+    handles[10] = reused;
+    for (GameHandle& handle : handles)
+        releaseGame(pool, handle);
+
+    // renouvellement continu sur plusieurs fils : la réserve ne grandit plus
+    auto churn = [&pool]() {
+        vector<thread> threads;
+        for (int t = 0; t < 4; ++t)
+            threads.emplace_back([&pool]() {
+                GameHandle live[64];
+                for (int i = 0; i < 20000; ++i) {
+                    GameHandle& handle = live[i % 64];
+                    if (i >= 64)
+                        releaseGame(pool, handle);
+                    acquireGame(pool, (i & 1) ? BIG : LITTLE, handle);
+                    Move move = {{0, 3}, {2, 3}};
+                    movePiece(*getPooledGame(pool, handle), move);
+                }
+                for (GameHandle& handle : live)
+                    releaseGame(pool, handle);
+            });
+        for (thread& worker : threads)
+            worker.join();
+    };
+    auto start = chrono::steady_clock::now();
+    churn();
+    uint32_t capacity = getPoolCapacity(pool);
+    churn();
+    double pooled = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / 160000;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < 160000; ++i) {
+        Board board = {nullptr, (i & 1) ? BIG : LITTLE};
+        createBoard(board);
+        initializeBoard(board);
+        deleteBoard(board);
+    }
+    double allocated = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / 160000;
+    if (getPoolCapacity(pool) == capacity && pool.itsLiveGames == 0) {
+        cout << "PASS \t: " << capacity << " slots after churn, " << int(pooled) << " ns per game instead of "
+             << int(allocated) << " ns with createBoard" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: " << capacity << " then " << getPoolCapacity(pool) << " slots after churn" << endl;
+        failed++;
+    }
+
+    destroyGamePool(pool);
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of game pool *********" << endl << endl;
+}
+
+
+void test_broadcast()
+{
+    cout << "********* Start testing of broadcast *********" << endl;
+    int pass = 0;
+    int failed = 0;
+
+    // partie jouée et diffusée ; un spectateur arrive à chaque coup et la suit jusqu'au bout
+    Game game;
+    game.itsBoard.itsSize = LITTLE;
+    createBoard(game.itsBoard);
+    initializeBoard(game.itsBoard);
+    BroadcastChannel channel;
+    attachBroadcast(channel, game);
+    const int PLIES = 60;
+    vector<BroadcastFrame> played;
+    vector<vector<BroadcastFrame>> catchUps;
+    bool captured = false;
+    size_t longest = 0;
+    for (int ply = 0; ply < PLIES && !isGameFinished(game); ++ply) {
+        catchUps.push_back(getCatchUpFrames(channel));
+        longest = max(longest, catchUps.back().size());
+        Move moves[MAX_MOVES];
+        int count = generateMoves(game, moves);
+        Move move = moves[(ply * 13 + 5) % count];
+        movePiece(game, move);
+        capturePieces(game, move);
+        switchCurrentPlayer(game);
+        played.push_back(publishMove(channel, game, move));
+        captured = captured || played.back()->find(" x ") != string::npos;
+    }
+    char expected[POSITION_STRING_SIZE];
+    formatPosition(game, expected, POSITION_STRING_SIZE);
+
+    bool replayed = true;
+    for (size_t joined = 0; joined < catchUps.size(); ++joined) {
+        Game spectator;
+        int ply = -1;
+        for (const BroadcastFrame& frame : catchUps[joined])
+            replayed = replayed && applyFrame(*frame, spectator, ply);
+        replayed = replayed && ply == int(joined);
+        for (size_t next = joined; next < played.size(); ++next)
+            replayed = replayed && applyFrame(*played[next], spectator, ply);
+        char position[POSITION_STRING_SIZE];
+        formatPosition(spectator, position, POSITION_STRING_SIZE);
+        replayed = replayed && ply == int(played.size()) && string(position) == expected;
+        if (spectator.itsBoard.itsCells != nullptr)
+            deleteBoard(spectator.itsBoard);
+    }
+    if (replayed && captured && longest <= size_t(BROADCAST_KEYFRAME_PLIES)) {
+        cout << "PASS \t: " << catchUps.size() << " spectators joining late rebuild the game, catch-up of "
+             << longest << " frames at most" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: spectators joining late rebuild the game" << endl;
+        failed++;
+    }
+
+    // une trame est la même pour tous les spectateurs
+    const BroadcastFrame& last = getCatchUpFrames(channel).back();
+    long owners = last.use_count();
+    vector<BroadcastFrame> queues(1000, last);
+    if (last.use_count() == owners + 1000 && queues[999].get() == last.get() && getCatchUpFrames(channel).front()->compare(0, 4, "key ") == 0) {
+        cout << "PASS \t: one frame shared by 1000 spectators" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: one frame shared by 1000 spectators" << endl;
+        failed++;
+    }
+    detachBroadcast(channel, game);
+    deleteBoard(game.itsBoard);
+
+#ifdef __linux__
+    // spectateur sur le serveur : image clé, coups joués, fin de partie
+    Server server;
+    ServerConfig config;
+    config.itsPort = 0;
+    config.itsThreads = 2;
+    if (startServer(server, config)) {
+        TestClient alice, bob, carol;
+        connectClient(alice, server.itsPort);
+        connectClient(bob, server.itsPort);
+        connectClient(carol, server.itsPort);
+        sendClient(alice, "create 11 alice");
+        string created = readClient(alice);
+        string id = created.substr(created.find(' ') + 1);
+        sendClient(bob, "join " + id + " bob");
+        readClient(alice);
+        readClient(bob);
+        sendClient(alice, "move a4-c4");
+        readClient(alice);
+        readClient(bob);
+        sendClient(carol, "watch " + id);
+        bool watching = readClient(carol) == "watching " + id && readClient(carol).compare(0, 6, "key 0 ") == 0
+                        && readClient(carol) == "ply 1 a4-c4";
+        Game mirror;
+        mirror.itsBoard.itsSize = LITTLE;
+        createBoard(mirror.itsBoard);
+        initializeBoard(mirror.itsBoard);
+        Move opening = {{0, 3}, {2, 3}};
+        movePiece(mirror, opening);
+        switchCurrentPlayer(mirror);
+        Move moves[MAX_MOVES];
+        generateMoves(mirror, moves);
+        char text[MOVE_STRING_SIZE];
+        formatMove(moves[0], text, MOVE_STRING_SIZE);
+        deleteBoard(mirror.itsBoard);
+        sendClient(bob, string("move ") + text);
+        bool followed = readClient(carol) == string("ply 2 ") + text;
+        sendClient(alice, "resign");
+        bool ended = readClient(carol) == "end defense bob 2 abandon";
+        sendClient(carol, "watch " + id);
+        bool closed = readClient(carol) == "error no game to watch";
+        if (watching && followed && ended && closed) {
+            cout << "PASS \t: game watched on the server" << endl;
+            pass++;
+        } else {
+            cout << "FAIL! \t: game watched on the server" << endl;
+            failed++;
+        }
+        close(alice.itsFd);
+        close(bob.itsFd);
+        close(carol.itsFd);
+        stopServer(server);
+    } else {
+        cout << "FAIL! \t: server started" << endl;
+        failed++;
+    }
+#endif
+
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of broadcast *********" << endl << endl;
+}
+
+
+void test_journal()
+{
+    cout << "********* Start testing of journal *********" << endl;
+    int pass = 0;
+    int failed = 0;
+
+    const string path = "test_journal";
+    auto clean = [&path]() {
+        remove((path + ".snap").c_str());
+        remove((path + ".snap.tmp").c_str());
+        for (int generation = 0; generation < 64; ++generation)
+            remove((path + "." + to_string(generation) + ".log").c_str());
+    };
+    // les parties retrouvées ont la position, les noms et les coups des parties jouées
+    auto same = [](map<uint32_t, JournalGame>& aRecovered, map<uint32_t, Game>& aGames, map<uint32_t, int>& aPlies) {
+        bool equal = aRecovered.size() == aGames.size();
+        for (auto& entry : aGames) {
+            auto found = aRecovered.find(entry.first);
+            if (found == aRecovered.end())
+                return false;
+            char expected[POSITION_STRING_SIZE];
+            char position[POSITION_STRING_SIZE];
+            formatPosition(entry.second, expected, POSITION_STRING_SIZE);
+            formatPosition(found->second.itsGame, position, POSITION_STRING_SIZE);
+            equal = equal && string(position) == expected && found->second.itsPlies == aPlies[entry.first]
+                    && found->second.itsGame.itsPlayer2.itsName == entry.second.itsPlayer2.itsName;
+        }
+        return equal;
+    };
+    clean();
+
+    // trois parties journalisées, une terminée ; relecture pendant que le journal tourne (panne)
+    Journal journal;
+    bool opened = openJournal(journal, path);
+    map<uint32_t, Game> games;
+    map<uint32_t, int> plies;
+    uint64_t sequence = 0;
+    for (uint32_t id = 1; id <= 3; ++id) {
+        Game& game = games[id];
+        game.itsBoard.itsSize = (id == 2) ? BIG : LITTLE;
+        createBoard(game.itsBoard);
+        initializeBoard(game.itsBoard);
+        game.itsPlayer1.itsName = "a" + to_string(id);
+        game.itsPlayer2.itsName = "d" + to_string(id);
+        logGameStart(journal, id, game);
+    }
+    auto play = [&](int aPlies) {
+        for (int ply = 0; ply < aPlies; ++ply)
+            for (auto& entry : games) {
+                Game& game = entry.second;
+                if (isGameFinished(game))
+                    continue;
+                Move moves[MAX_MOVES];
+                int count = generateMoves(game, moves);
+                Move move = moves[(ply * 11 + entry.first * 3) % count];
+                movePiece(game, move);
+                capturePieces(game, move);
+                switchCurrentPlayer(game);
+                plies[entry.first]++;
+                sequence = logMove(journal, entry.first, move);
+            }
+    };
+    play(30);
+    sequence = logGameEnd(journal, 2);
+    deleteBoard(games[2].itsBoard);
+    games.erase(2);
+    plies.erase(2);
+    bool durable = waitJournal(journal, sequence);
+    map<uint32_t, JournalGame> recovered;
+    bool replayed = recoverJournal(path, recovered) && same(recovered, games, plies);
+    releaseJournalGames(recovered);
+    if (opened && durable && replayed && journal.itsCommits < 30 * 3) {
+        cout << "PASS \t: games recovered from the log, " << journal.itsCommits << " commits for " << 30 * 3 << " moves" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: games recovered from the log" << endl;
+        failed++;
+    }
+
+    // instantané : segment neuf, anciens segments supprimés, mêmes parties
+    uint64_t snapshots = journal.itsSnapshots;
+    snapshotJournal(journal);
+    play(10);
+    waitJournal(journal, sequence);
+    for (int wait = 0; wait < 200 && journal.itsSnapshots == snapshots; ++wait)
+        this_thread::sleep_for(chrono::milliseconds(1));
+    ifstream snapshot(path + ".snap");
+    ifstream oldSegment(path + ".1.log");
+    replayed = recoverJournal(path, recovered) && same(recovered, games, plies);
+    releaseJournalGames(recovered);
+    if (journal.itsSnapshots > snapshots && snapshot && !oldSegment && replayed) {
+        cout << "PASS \t: snapshot taken and old segments removed" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: snapshot taken and old segments removed" << endl;
+        failed++;
+    }
+
+    // enregistrement déchiré en fin de segment : ignoré, puis le journal repart d'un segment neuf
+    closeJournal(journal);
+    {
+        ofstream segment(path + "." + to_string(journal.itsGeneration) + ".log", ios::binary | ios::app);
+        segment.write("M\x01\x00\x00\x00\x00", 6);
+    }
+    replayed = recoverJournal(path, recovered) && same(recovered, games, plies);
+    releaseJournalGames(recovered);
+    opened = openJournal(journal, path);
+    play(5);
+    closeJournal(journal);
+    bool reopened = recoverJournal(path, recovered) && same(recovered, games, plies);
+    releaseJournalGames(recovered);
+    if (replayed && opened && reopened) {
+        cout << "PASS \t: torn record ignored, log reopened" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: torn record ignored, log reopened" << endl;
+        failed++;
+    }
+    for (auto& entry : games)
+        deleteBoard(entry.second.itsBoard);
+
+    // coût d'un coup journalisé, quatre fils à la fois : aller-retour d'une pièce de chaque camp
+    clean();
+    openJournal(journal, path);
+    const int THREADS = 4;
+    const int MOVES = 25000;
+    Move cycle[4] = {{{0, 3}, {1, 3}}, {{3, 5}, {2, 5}}, {{1, 3}, {0, 3}}, {{2, 5}, {3, 5}}};
+    Game start;
+    createBoard(start.itsBoard);
+    initializeBoard(start.itsBoard);
+    for (uint32_t id = 1; id <= THREADS; ++id)
+        logGameStart(journal, id, start);
+    atomic<int64_t> spent{0};
+    vector<thread> threads;
+    for (uint32_t id = 1; id <= THREADS; ++id)
+        threads.emplace_back([&, id]() {
+            auto begin = chrono::steady_clock::now();
+            for (int i = 0; i < MOVES; ++i)
+                logMove(journal, id, cycle[i % 4]);
+            spent += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - begin).count();
+        });
+    for (thread& worker : threads)
+        worker.join();
+    closeJournal(journal);
+    map<uint32_t, Game> cycled;
+    map<uint32_t, int> cycledPlies;
+    for (uint32_t id = 1; id <= THREADS; ++id) {
+        Game& game = cycled[id];
+        createBoard(game.itsBoard);
+        initializeBoard(game.itsBoard);
+        cycledPlies[id] = MOVES;
+    }
+    replayed = recoverJournal(path, recovered) && same(recovered, cycled, cycledPlies);
+    releaseJournalGames(recovered);
+    for (auto& entry : cycled)
+        deleteBoard(entry.second.itsBoard);
+    deleteBoard(start.itsBoard);
+    int64_t perMove = spent / (THREADS * MOVES);
+    if (replayed && perMove < 5000 && journal.itsCommits < uint64_t(THREADS * MOVES / 100)) {
+        cout << "PASS \t: " << THREADS * MOVES << " moves logged, " << perMove << " ns per move, "
+             << journal.itsCommits << " commits" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: " << THREADS * MOVES << " moves logged, " << perMove << " ns per move, "
+             << journal.itsCommits << " commits" << endl;
+        failed++;
+    }
+    clean();
+
+#ifdef __linux__
+    // serveur arrêté puis relancé : la partie reprend où elle en était
+    Server server;
+    ServerConfig config;
+    config.itsPort = 0;
+    config.itsThreads = 2;
+    config.itsJournal = path;
+    bool resumed = false;
+    if (startServer(server, config)) {
+        TestClient alice, bob;
+        connectClient(alice, server.itsPort);
+        connectClient(bob, server.itsPort);
+        sendClient(alice, "create 11 alice");
+        string created = readClient(alice);
+        string id = created.substr(created.find(' ') + 1);
+        sendClient(bob, "join " + id + " bob");
+        readClient(alice);
+        readClient(bob);
+        sendClient(alice, "move a4-b4");
+        readClient(alice);
+        readClient(bob);
+        close(alice.itsFd);
+        close(bob.itsFd);
+        // la fermeture des connexions termine la partie sur le fil de sa boucle
+        for (int wait = 0; wait < 2000 && getServerGames(server) > 0; ++wait)
+            this_thread::sleep_for(chrono::milliseconds(1));
+        stopServer(server);
+    }
+    if (startServer(server, config)) {
+        TestClient alice, bob;
+        connectClient(alice, server.itsPort);
+        connectClient(bob, server.itsPort);
+        bool games = getServerGames(server) == 0;
+        stopServer(server);
+        resumed = games;
+        close(alice.itsFd);
+        close(bob.itsFd);
+    }
+    // les connexions fermées ont terminé la partie : une partie interrompue par l'arrêt reprend
+    if (startServer(server, config)) {
+        TestClient alice, bob;
+        connectClient(alice, server.itsPort);
+        connectClient(bob, server.itsPort);
+        sendClient(alice, "create 11 alice");
+        string created = readClient(alice);
+        string id = created.substr(created.find(' ') + 1);
+        sendClient(bob, "join " + id + " bob");
+        readClient(alice);
+        readClient(bob);
+        sendClient(alice, "move a4-b4");
+        readClient(alice);
+        readClient(bob);
+        stopServer(server);
+        close(alice.itsFd);
+        close(bob.itsFd);
+        if (startServer(server, config)) {
+            connectClient(alice, server.itsPort);
+            connectClient(bob, server.itsPort);
+            alice.itsInput.clear();
+            bob.itsInput.clear();
+            sendClient(bob, "join " + id + " bob");
+            bool waiting = readClient(bob) == "resumed " + id + " defense";
+            sendClient(alice, "join " + id + " alice");
+            bool started = readClient(alice) == "start " + id + " attaque bob" && readClient(bob) == "start " + id + " defense alice";
+            string position = readClient(alice);
+            bool moved = position.compare(0, 21, "position 4XXXX3/3X1X5") == 0 && position.substr(position.size() - 4) == "d 11";
+            sendClient(bob, "resign");
+            bool ended = readClient(alice) == "end attaque alice 1 abandon";
+            resumed = resumed && waiting && started && moved && ended && getServerGames(server) == 0;
+            stopServer(server);
+            close(alice.itsFd);
+            close(bob.itsFd);
+        }
+        else
+            resumed = false;
+    }
+    if (resumed) {
+        cout << "PASS \t: game resumed after a restart of the server" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: game resumed after a restart of the server" << endl;
+        failed++;
+    }
+    clean();
+#endif
+
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of journal *********" << endl << endl;
+}
+
+
+void test_timeline()
+{
+    cout << "********* Start testing of timeline *********" << endl;
+    int pass = 0;
+    int failed = 0;
+
+    // parties au hasard : chaque coup atteint par saut, en avant et en arrière, comme pendant la partie
+    srand(48);
+    const int GAMES = 20;
+    vector<Timeline> timelines(GAMES);
+    vector<vector<string>> positions(GAMES);
+    bool seeks = true;
+    bool steps = true;
+    int captures = 0;
+    for (int g = 0; g < GAMES; ++g) {
+        Game game;
+        game.itsBoard.itsSize = (g % 2) ? BIG : LITTLE;
+        createBoard(game.itsBoard);
+        initializeBoard(game.itsBoard);
+        timelines[g].itsInterval = (g % 3 == 0) ? 7 : TIMELINE_INTERVAL;
+        startTimeline(timelines[g], game);
+        char text[POSITION_STRING_SIZE];
+        formatPosition(game, text, POSITION_STRING_SIZE);
+        positions[g].push_back(text);
+        while (getTimelineLength(timelines[g]) < 300 && !isGameFinished(game)) {
+            Move moves[MAX_MOVES];
+            appendTimeline(timelines[g], game, moves[rand() % generateMoves(game, moves)]);
+            captures += timelines[g].itsDeltas.back().itsCaptures != 0;
+            formatPosition(game, text, POSITION_STRING_SIZE);
+            positions[g].push_back(text);
+        }
+        deleteBoard(game.itsBoard);
+
+        Game viewer;
+        int length = getTimelineLength(timelines[g]);
+        for (int ply = length; ply >= 0; --ply) {
+            seeks = seeks && seekTimeline(timelines[g], viewer, ply);
+            formatPosition(viewer, text, POSITION_STRING_SIZE);
+            seeks = seeks && positions[g][ply] == text;
+        }
+        int ply = 0;
+        while (stepTimelineForward(timelines[g], viewer, ply)) {
+            formatPosition(viewer, text, POSITION_STRING_SIZE);
+            steps = steps && positions[g][ply] == text;
+        }
+        while (stepTimelineBackward(timelines[g], viewer, ply)) {
+            formatPosition(viewer, text, POSITION_STRING_SIZE);
+            steps = steps && positions[g][ply] == text;
+        }
+        steps = steps && ply == 0 && !seekTimeline(timelines[g], viewer, length + 1);
+        deleteBoard(viewer.itsBoard);
+    }
+    if (seeks && steps && captures > 0) {
+        cout << "PASS \t: every ply of " << GAMES << " games reached by seek and by steps (" << captures << " plies with captures)" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: every ply of " << GAMES << " games reached by seek and by steps" << endl;
+        failed++;
+    }
+
+    // saut au hasard comparé au rejeu depuis le départ, et place prise en mémoire
+    Timeline& longest = *max_element(timelines.begin(), timelines.end(), [](const Timeline& a, const Timeline& b) {
+        return (a.itsInterval == TIMELINE_INTERVAL) < (b.itsInterval == TIMELINE_INTERVAL)
+               || (a.itsInterval == b.itsInterval && getTimelineLength(a) < getTimelineLength(b));
+    });
+    int length = getTimelineLength(longest);
+    Game viewer;
+    const int SEEKS = 20000;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < SEEKS; ++i)
+        seekTimeline(longest, viewer, (i * 7919) % (length + 1));
+    double seek = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / SEEKS;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < SEEKS / 10; ++i) {
+        int target = (i * 7919) % (length + 1);
+        seekTimeline(longest, viewer, 0);
+        for (int ply = 0; ply < target; ++ply) {
+            Move move = {{longest.itsDeltas[ply].itsFrom / BIG, longest.itsDeltas[ply].itsFrom % BIG},
+                         {longest.itsDeltas[ply].itsTo / BIG, longest.itsDeltas[ply].itsTo % BIG}};
+            movePiece(viewer, move);
+            capturePieces(viewer, move);
+            switchCurrentPlayer(viewer);
+        }
+    }
+    double replay = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / (SEEKS / 10);
+    deleteBoard(viewer.itsBoard);
+    size_t bytes = sizeof(Timeline) + longest.itsDeltas.size() * sizeof(TimelineDelta) + longest.itsKeyframes.size() * sizeof(PackedBoard);
+    if (sizeof(TimelineDelta) == 3 && seek < replay && bytes < 2048) {
+        cout << "PASS \t: " << length << " plies in " << bytes << " bytes, seek in " << int(seek) << " ns instead of "
+             << int(replay) << " ns by replay" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: " << length << " plies in " << bytes << " bytes, seek in " << int(seek) << " ns instead of "
+             << int(replay) << " ns by replay" << endl;
+        failed++;
+    }
+
+    // partie d'une archive
+    const string path = "test_timeline.hrec";
+    remove(path.c_str());
+    RecordWriter writer;
+    openRecordWriter(writer, path);
+    Game game;
+    createBoard(game.itsBoard);
+    string expected;
+    for (int g = 0; g < 3; ++g) {
+        initializeBoard(game.itsBoard);
+        game.itsCurrentPlayer = &game.itsPlayer1;
+        game.itsPlayer1.itsName = "a" + to_string(g);
+        beginRecord(writer, game);
+        for (int ply = 0; ply < 40 && !isGameFinished(game); ++ply) {
+            Move moves[MAX_MOVES];
+            Move move = moves[rand() % generateMoves(game, moves)];
+            writeRecordMove(writer, game, move);
+            movePiece(game, move);
+            capturePieces(game, move);
+            switchCurrentPlayer(game);
+        }
+        endRecord(writer, game);
+        if (g == 1) {
+            char text[POSITION_STRING_SIZE];
+            formatPosition(game, text, POSITION_STRING_SIZE);
+            expected = text;
+        }
+    }
+    closeRecordWriter(writer);
+    deleteBoard(game.itsBoard);
+    Timeline loaded;
+    Game last;
+    bool read = loadRecordTimeline(path, 1, loaded, last) && last.itsPlayer1.itsName == "a1";
+    char text[POSITION_STRING_SIZE];
+    if (read)
+        formatPosition(last, text, POSITION_STRING_SIZE);
+    Game missing;
+    if (read && expected == text && !loadRecordTimeline(path, 3, loaded, missing)) {
+        cout << "PASS \t: timeline of a recorded game" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: timeline of a recorded game" << endl;
+        failed++;
+    }
+    if (last.itsBoard.itsCells != nullptr)
+        deleteBoard(last.itsBoard);
+    if (missing.itsBoard.itsCells != nullptr)
+        deleteBoard(missing.itsBoard);
+    remove(path.c_str());
+
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of timeline *********" << endl << endl;
+}
+
+
+struct FlowTestContext
+{
+    FlowScheduler* itsScheduler;
+    thread::id itsThread;
+    atomic<bool> itsSameThread{true};
+    atomic<int> itsEnds[4] = {};
+};
+
+void test_gameFlow()
+{
+    cout << "********* Start testing of gameFlow *********" << endl;
+    int pass = 0;
+    int failed = 0;
+
+    // une partie pilotée à la main suit la boucle d'origine coup pour coup
+    srand(49);
+    GameFlow flow;
+    startFlow(flow, LITTLE, TimeControl(), 0);
+    Game mirror;
+    mirror.itsBoard.itsSize = LITTLE;
+    createBoard(mirror.itsBoard);
+    initializeBoard(mirror.itsBoard);
+    Move refused = {{0, 0}, {0, 1}};
+    bool same = playFlowMove(flow, refused, 0) == FLOW_REFUSED && flow.itsPly == 0;
+    while (flow.itsState == FLOW_WAITING && flow.itsPly < 400) {
+        Move moves[MAX_MOVES];
+        Move move = moves[rand() % generateMoves(flow.itsGame, moves)];
+        FlowResult result = playFlowMove(flow, move, 0);
+        movePiece(mirror, move);
+        capturePieces(mirror, move);
+        if (!isGameFinished(mirror))
+            switchCurrentPlayer(mirror);
+        char text[POSITION_STRING_SIZE];
+        char expected[POSITION_STRING_SIZE];
+        formatPosition(flow.itsGame, text, POSITION_STRING_SIZE);
+        formatPosition(mirror, expected, POSITION_STRING_SIZE);
+        same = same && result != FLOW_REFUSED && string(text) == expected;
+    }
+    same = same && (flow.itsState == FLOW_WAITING || getFlowWinner(flow) != nullptr);
+    if (same) {
+        cout << "PASS \t: " << flow.itsPly << " plies played by the flow as by the game loop" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: " << flow.itsPly << " plies played by the flow as by the game loop" << endl;
+        failed++;
+    }
+    deleteBoard(mirror.itsBoard);
+
+    // pendule : un coup joué après le drapeau ne compte pas
+    TimeControl control;
+    control.itsMode = CLOCK_FISCHER;
+    control.itsMainTime = CLOCK_SECOND;
+    startFlow(flow, LITTLE, control, 0);
+    Move moves[MAX_MOVES];
+    generateMoves(flow.itsGame, moves);
+    bool onTime = playFlowMove(flow, moves[0], CLOCK_SECOND / 2) == FLOW_PLAYED;
+    generateMoves(flow.itsGame, moves);
+    bool late = playFlowMove(flow, moves[0], 2 * CLOCK_SECOND) == FLOW_OVER && flow.itsPly == 1;
+    if (onTime && late && flow.itsEnd == FLOW_FLAGGED && getFlowWinner(flow) == &flow.itsGame.itsPlayer1) {
+        cout << "PASS \t: a move after the flag ends the game" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: a move after the flag ends the game" << endl;
+        failed++;
+    }
+    deleteBoard(flow.itsGame.itsBoard);
+
+    // planificateur : des milliers de parties sur un seul fil, les joueurs répondent depuis le crochet
+    FlowScheduler scheduler;
+    FlowTestContext context;
+    context.itsScheduler = &scheduler;
+    FlowHooks hooks;
+    hooks.itsContext = &context;
+    hooks.itsOnRequest = [](void* aContext, const GameFlow& aFlow) {
+        FlowTestContext& test = *static_cast<FlowTestContext*>(aContext);
+        if (this_thread::get_id() != test.itsThread)
+            test.itsSameThread = false;
+        if (aFlow.itsPly >= 200) {
+            abortFlowGame(*test.itsScheduler, aFlow.itsId);
+            return;
+        }
+        Move legal[MAX_MOVES];
+        int count = generateMoves(aFlow.itsGame, legal);
+        postFlowMove(*test.itsScheduler, aFlow.itsId, legal[(aFlow.itsId * 7919u + aFlow.itsPly * 104729u) % count]);
+    };
+    hooks.itsOnEnd = [](void* aContext, const GameFlow& aFlow) {
+        static_cast<FlowTestContext*>(aContext)->itsEnds[aFlow.itsEnd]++;
+    };
+    startScheduler(scheduler);
+    context.itsThread = scheduler.itsThread.get_id();
+    const int GAMES = 2000;
+    TimeControl slow;
+    slow.itsMode = CLOCK_FISCHER;
+    slow.itsMainTime = 600 * CLOCK_SECOND;
+    auto start = chrono::steady_clock::now();
+    for (int g = 0; g < GAMES; ++g) {
+        unique_ptr<GameFlow> game(new GameFlow);
+        game->itsHooks = &hooks;
+        scheduleGame(scheduler, move(game), (g % 2) ? BIG : LITTLE, slow);
+    }
+    while (scheduler.itsLiveGames > 0 && chrono::steady_clock::now() - start < chrono::seconds(60))
+        this_thread::sleep_for(chrono::milliseconds(1));
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    int ended = context.itsEnds[FLOW_WON] + context.itsEnds[FLOW_FLAGGED] + context.itsEnds[FLOW_BLOCKED] + context.itsEnds[FLOW_ABORTED];
+    if (scheduler.itsLiveGames == 0 && ended == GAMES && context.itsEnds[FLOW_FLAGGED] == 0 && context.itsSameThread) {
+        cout << "PASS \t: " << GAMES << " games driven by one thread, " << scheduler.itsMoves << " moves ("
+             << int(scheduler.itsMoves / seconds) << " moves/s, " << context.itsEnds[FLOW_WON] << " won, "
+             << context.itsEnds[FLOW_ABORTED] << " stopped)" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: " << GAMES << " games driven by one thread (" << ended << " ended)" << endl;
+        failed++;
+    }
+
+    // un joueur muet perd au temps sans qu'aucun fil ne l'attende
+    FlowHooks silent;
+    silent.itsContext = &context;
+    silent.itsOnEnd = hooks.itsOnEnd;
+    TimeControl blitz;
+    blitz.itsMode = CLOCK_FISCHER;
+    blitz.itsMainTime = CLOCK_SECOND / 20;
+    unique_ptr<GameFlow> game(new GameFlow);
+    game->itsHooks = &silent;
+    start = chrono::steady_clock::now();
+    scheduleGame(scheduler, move(game), LITTLE, blitz);
+    while (scheduler.itsLiveGames > 0 && chrono::steady_clock::now() - start < chrono::seconds(5))
+        this_thread::sleep_for(chrono::milliseconds(1));
+    double flagged = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    if (context.itsEnds[FLOW_FLAGGED] == 1 && flagged >= 50 && flagged < 500) {
+        cout << "PASS \t: a silent player flagged after " << int(flagged) << " ms" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: a silent player flagged after " << int(flagged) << " ms" << endl;
+        failed++;
+    }
+    stopScheduler(scheduler);
+
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of gameFlow *********" << endl << endl;
+}
+
+
+static void playRandomPlies(Game& aGame, int aPlies)
+{
+    for (int ply = 0; ply < aPlies && !isGameFinished(aGame); ++ply) {
+        Move moves[MAX_MOVES];
+        int count = generateMoves(aGame, moves);
+        if (count == 0)
+            break;
+        Move move = moves[rand() % count];
+        movePiece(aGame, move);
+        capturePieces(aGame, move);
+        switchCurrentPlayer(aGame);
+    }
+}
+
+void test_searchPool()
+{
+    cout << "********* Start testing of searchPool *********" << endl;
+    int pass = 0;
+    int failed = 0;
+
+    srand(50);
+    const int POSITIONS = 16;
+    vector<Game> positions(POSITIONS);
+    for (int i = 0; i < POSITIONS; ++i) {
+        positions[i].itsBoard.itsSize = (i % 2) ? BIG : LITTLE;
+        createBoard(positions[i].itsBoard);
+        initializeBoard(positions[i].itsBoard);
+        playRandomPlies(positions[i], 6 + i);
+    }
+    int threads = int(max(1u, thread::hardware_concurrency()));
+    const int BURSTS = 30;
+    const int BOTS = 4 * threads;
+    const MoveBudget BUDGET = {5000, 60000};
+    AnalysisConfig analysis;
+    analysis.itsLines = 3;
+    analysis.itsMaxDepth = SEARCH_MAX_PLY - 1;
+    analysis.itsMaxSeconds = 1.0;
+    analysis.itsHashBits = 16;
+
+    // chaque joueur garde sa table, et ne cherche son coup suivant qu'une fois le précédent joué
+    vector<TranspositionTable> tables(BOTS);
+    for (TranspositionTable& table : tables)
+        createTranspositionTable(table, 14);
+
+    // machine surchargée : des analyses sur tous les coeurs, et des rafales de coups à trouver
+    SearchPool pool;
+    startSearchPool(pool);
+    vector<shared_ptr<SearchTask>> analyses;
+    for (int i = 0; i < threads; ++i)
+        analyses.push_back(submitAnalysis(pool, positions[i % POSITIONS], analysis));
+    this_thread::sleep_for(chrono::milliseconds(20));
+    vector<shared_ptr<SearchTask>> bots;
+    for (int burst = 0; burst < BURSTS; ++burst) {
+        for (int i = 0; i < BOTS; ++i) {
+            if (burst > 0)
+                waitSearchTask(pool, *bots[bots.size() - BOTS]);
+            bots.push_back(submitMoveSearch(pool, positions[(burst + i) % POSITIONS], BUDGET, &tables[i]));
+        }
+        this_thread::sleep_for(chrono::milliseconds(25));
+    }
+    int late = 0;
+    bool found = true;
+    uint64_t nodes = 0;
+    int64_t worst = 0;
+    for (auto& bot : bots) {
+        waitSearchTask(pool, *bot);
+        int64_t used = bot->itsFinished - bot->itsSubmitted;
+        worst = max(worst, used);
+        late += used > BUDGET.itsHard + 10000;
+        found = found && bot->itsFound;
+        nodes += bot->itsInfo.itsNodes;
+    }
+    bool analysed = true;
+    for (auto& task : analyses) {
+        waitSearchTask(pool, *task);
+        analysed = analysed && task->itsInfo.itsDepth > 0;
+        nodes += task->itsInfo.itsNodes;
+    }
+    double seconds = double(getClockTime() - analyses[0]->itsSubmitted) / CLOCK_SECOND;
+    uint64_t preemptions = pool.itsPreemptions;
+    stopSearchPool(pool);
+
+    // la même charge avec un fil par recherche, pour comparer
+    int naiveLate = 0;
+    {
+        vector<thread> searches;
+        for (int i = 0; i < threads; ++i)
+            searches.emplace_back([&positions, &analysis, i]() { analysePosition(positions[i % POSITIONS], analysis, AnalysisCallback()); });
+        this_thread::sleep_for(chrono::milliseconds(20));
+        mutex lock;
+        vector<thread> previous(BOTS);
+        for (int burst = 0; burst < BURSTS; ++burst) {
+            for (int i = 0; i < BOTS; ++i) {
+                if (previous[i].joinable())
+                    previous[i].join();
+                previous[i] = thread([&, burst, i]() {
+                    int64_t start = getClockTime();
+                    Move move;
+                    searchMove(positions[(burst + i) % POSITIONS], BUDGET, &tables[i], move);
+                    lock_guard<mutex> guard(lock);
+                    naiveLate += getClockTime() - start > BUDGET.itsHard + 10000;
+                });
+            }
+            this_thread::sleep_for(chrono::milliseconds(25));
+        }
+        for (thread& search : previous)
+            search.join();
+        for (thread& search : searches)
+            search.join();
+    }
+    if (late == 0 && found && analysed && preemptions > 0) {
+        cout << "PASS \t: " << bots.size() << " bot moves among " << threads << " analyses on " << threads << " workers, none late (worst "
+             << worst / 1000 << " ms of " << BUDGET.itsHard / 1000 << ", " << preemptions << " preemptions, "
+             << uint64_t(nodes / seconds) << " nodes/s); one thread per search: " << naiveLate << " late" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: " << bots.size() << " bot moves on " << threads << " workers, " << late << " late (worst "
+             << worst / 1000 << " ms), " << preemptions << " preemptions" << endl;
+        failed++;
+    }
+
+    // vieillissement : une analyse qui attend passe devant une partie lente, une partie rapide passe devant tout
+    SearchPool single;
+    single.itsAging = 50000;
+    startSearchPool(single, 1);
+    AnalysisConfig shortAnalysis = analysis;
+    shortAnalysis.itsMaxSeconds = 0.2;
+    shared_ptr<SearchTask> running = submitAnalysis(single, positions[0], shortAnalysis);
+    this_thread::sleep_for(chrono::milliseconds(5));
+    shared_ptr<SearchTask> waiting = submitAnalysis(single, positions[1], shortAnalysis);
+    this_thread::sleep_for(chrono::milliseconds(5));
+    shared_ptr<SearchTask> slow = submitMoveSearch(single, positions[2], {100000, 1000000}, &tables[0]);
+    shared_ptr<SearchTask> fast = submitMoveSearch(single, positions[3], {5000, 20000}, &tables[1]);
+    waitSearchTask(single, *slow);
+    waitSearchTask(single, *waiting);
+    bool fastFirst = fast->itsFinished < running->itsFinished && fast->itsFinished - fast->itsSubmitted <= 30000;
+    bool aged = waiting->itsStarted <= slow->itsStarted && slow->itsFound;
+    // annulation d'une analyse sans limite
+    AnalysisConfig endless = analysis;
+    endless.itsMaxSeconds = 0;
+    shared_ptr<SearchTask> cancelled = submitAnalysis(single, positions[4], endless);
+    this_thread::sleep_for(chrono::milliseconds(20));
+    cancelSearchTask(*cancelled);
+    waitSearchTask(single, *cancelled);
+    stopSearchPool(single);
+    if (fastFirst && aged && cancelled->itsDone) {
+        cout << "PASS \t: fast game ahead of a running analysis (" << (fast->itsFinished - fast->itsSubmitted) / 1000
+             << " ms), aged analysis ahead of a slow game, analysis cancelled" << endl;
+        pass++;
+    } else {
+        cout << "FAIL! \t: priorities of the pool (fast first " << fastFirst << ", aged " << aged << ")" << endl;
+        failed++;
+    }
+
+    for (Game& game : positions)
+        deleteBoard(game.itsBoard);
+    cout << "Totals: " << pass << " passed, " << failed << " failed" << endl;
+    cout << "********* Finished testing of searchPool *********" << endl << endl;
+}
+
+
 
 void resetBoard(Cell**& aBoard, const BoardSize& aBoardSize)
 {
@@ -157,6 +157,191 @@ void test_isKingCaptured();
 void test_isKingCapturedV2();
 
 
+/**
+ * @brief Test function for the compact position and move notation.
+ *
+ * This function tests formatPosition, parsePosition, formatMove and parseMove on both
+ * starting boards, on malformed strings and on a few moves.
+ */
+void test_notation();
+
+
+/**
+ * @brief Test function for the generateMoves function.
+ *
+ * This function compares the generated moves with the moves accepted by isValidMovement
+ * along random games on both board sizes.
+ */
+void test_generateMoves();
+
+/**
+ * @brief Test function for the game records.
+ *
+ * This function writes random games into a record file and checks that they are read back identically.
+ */
+void test_record();
+
+
+/**
+ * @brief Test function for the validateArchive function.
+ *
+ * This function checks that damaged and truncated games of an archive are reported with their first failing ply.
+ */
+void test_validateArchive();
+
+
+/**
+ * @brief Test function for the position index.
+ *
+ * This function builds the index of random games and checks that every position is found with its games.
+ */
+void test_positionIndex();
+
+
+/**
+ * @brief Test function for the board symmetries.
+ *
+ * This function checks the packed symmetries against cell-by-cell transformations and the canonical keys of symmetric positions.
+ */
+void test_symmetry();
+
+
+/**
+ * @brief Tests the tablebases: builds the king against two swords, checks each probed value
+ *        against the values one ply ahead, and checks that a position with too many pieces is refused.
+ */
+void test_tablebase();
+
+
+/**
+ * @brief Tests the opening book: builds it from games whose first move is played under every symmetry,
+ *        checks that symmetric moves share one entry and that moves come back in the frame of each game.
+ */
+void test_openingBook();
+
+
+/**
+ * @brief Tests the evaluation: incremental features must match a full scan during random games
+ *        (with captures and taken back moves), and open lines and threats are checked on set positions.
+ */
+void test_evaluation();
+
+
+/**
+ * @brief Tests the neural network evaluation: the incremental accumulator must match a full
+ *        computation during random games, and the vector code must match the plain loops.
+ */
+void test_nnue();
+
+
+/**
+ * @brief Tests the self-play generator: plays a few games on two threads with small shards,
+ *        then reads the shards back and checks the samples and the deduplication.
+ */
+void test_selfPlay();
+
+
+/**
+ * @brief Tests the weight tuner: loads self-play shards, checks that tuning lowers the loss
+ *        and that weights are saved and loaded.
+ */
+void test_tuner();
+
+
+/**
+ * @brief Tests the analysis: distinct sorted lines with playable variations, a win in one move,
+ *        the worker thread and its stop.
+ */
+void test_search();
+
+
+/**
+ * @brief Tests the clocks: time controls, Fischer and byo-yomi accounting, time allocation.
+ */
+void test_clock();
+
+
+/**
+ * @brief Tests the search counters: consistency after an analysis, per-thread blocks and their merge,
+ *        JSON and summary output.
+ */
+void test_searchStats();
+
+
+/**
+ * @brief Tests pondering: a table filled on the opponent's time shortens the next search,
+ *        the background search stops at once and a bot move keeps to its deadlines.
+ */
+void test_pondering();
+
+
+/**
+ * @brief Tests the terminal renderer: layout of a full frame, ANSI colours and redrawing of the changed cells only.
+ */
+void test_render();
+
+
+/**
+ * @brief Tests the batch mode: result lines of finished, unfinished, illegal and unreadable games, and replay speed.
+ */
+void test_batch();
+
+
+/**
+ * @brief Tests the engine protocol: position and moves, bounded search, commands read while searching,
+ *        `stop` latency and finished games.
+ */
+void test_engine();
+
+
+/**
+ * @brief Tests the game server on localhost: protocol, many games over several loops with their move latency,
+ *        games ended by closed connections.
+ */
+void test_server();
+
+
+/**
+ * @brief Tests the game pool: starting positions, stale handles, reuse of the slots and flat capacity under churn.
+ */
+void test_gamePool();
+
+
+/**
+ * @brief Tests the broadcast of games: late spectators rebuilding the game from the catch-up frames,
+ *        frames shared between spectators and a game watched on the server.
+ */
+void test_broadcast();
+
+
+/**
+ * @brief Tests the journal of games: recovery of the live games, snapshots, torn records,
+ *        cost of a logged move under group commit and games resumed by a restarted server.
+ */
+void test_journal();
+
+
+/**
+ * @brief Tests the game timelines: every ply reached by seek and by steps both ways, cost of a seek
+ *        against a replay, memory of a timeline and timelines of recorded games.
+ */
+void test_timeline();
+
+
+/**
+ * @brief Tests the game flows: the turns of the game loop, the flag of a late move, thousands of games
+ *        driven by one scheduler thread and a silent player flagged by the scheduler.
+ */
+void test_gameFlow();
+
+
+/**
+ * @brief Tests the search pool: bot moves found in time among analyses on an oversubscribed pool (compared
+ *        with one thread per search), fast games preempting analyses, aging of analyses and cancellation.
+ */
+void test_searchPool();
+
+
 
 
 #endif // TESTS_H
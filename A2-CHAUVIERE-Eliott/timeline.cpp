@@ -0,0 +1,124 @@
+using namespace std;
+#include "timeline.h"
+#include "functions.h"
+#include "record.h"
+
+static Move getDeltaMove(const TimelineDelta& aDelta)
+{
+    return {{aDelta.itsFrom / BIG, aDelta.itsFrom % BIG}, {aDelta.itsTo / BIG, aDelta.itsTo % BIG}};
+}
+
+static void applyDelta(Game& aGame, const TimelineDelta& aDelta)
+{
+    Move move = getDeltaMove(aDelta);
+    movePiece(aGame, move);
+    // les cases capturées sont connues : pas besoin de capturePieces
+    for (int d = 0; d < 4; ++d)
+        if (aDelta.itsCaptures & (1 << d)) {
+            Position pos = getNeighbour(move, d);
+            PieceType piece = aGame.itsBoard.itsCells[pos.itsRow][pos.itsCol].itsPieceType;
+            aGame.itsBoard.itsCells[pos.itsRow][pos.itsCol].itsPieceType = NONE;
+            if (aGame.itsHooks != nullptr)
+                aGame.itsHooks->itsOnRemove(aGame.itsHooks->itsContext, piece, pos);
+        }
+    switchCurrentPlayer(aGame);
+}
+
+static void revertDelta(Game& aGame, const TimelineDelta& aDelta)
+{
+    Move move = getDeltaMove(aDelta);
+    // les pièces prises sont celles de l'adversaire de la pièce qui a joué
+    PieceType mover = aGame.itsBoard.itsCells[move.itsEndPosition.itsRow][move.itsEndPosition.itsCol].itsPieceType;
+    MoveUndo undo;
+    undo.itsCaptured = aDelta.itsCaptures & 0xF;
+    for (int d = 0; d < 4; ++d)
+        undo.itsNeighbours[d] = (aDelta.itsCaptures & (0x10 << d)) ? KING : (mover == SWORD) ? SHIELD : SWORD;
+    unmakeMove(aGame, move, undo);
+}
+
+void startTimeline(Timeline& aTimeline, const Game& aGame)
+{
+    aTimeline.itsKeyframes.assign(1, PackedBoard());
+    packPosition(aGame, aTimeline.itsKeyframes[0]);
+    aTimeline.itsDeltas.clear();
+}
+
+void appendTimeline(Timeline& aTimeline, Game& aGame, const Move& aMove)
+{
+    MoveUndo undo;
+    makeMove(aGame, aMove, undo);
+    TimelineDelta delta;
+    delta.itsFrom = uint8_t(aMove.itsStartPosition.itsRow * BIG + aMove.itsStartPosition.itsCol);
+    delta.itsTo = uint8_t(aMove.itsEndPosition.itsRow * BIG + aMove.itsEndPosition.itsCol);
+    delta.itsCaptures = uint8_t(undo.itsCaptured);
+    for (int d = 0; d < 4; ++d)
+        if ((undo.itsCaptured & (1 << d)) && undo.itsNeighbours[d] == KING)
+            delta.itsCaptures |= uint8_t(0x10 << d);
+    aTimeline.itsDeltas.push_back(delta);
+    if (aTimeline.itsDeltas.size() % aTimeline.itsInterval == 0) {
+        aTimeline.itsKeyframes.emplace_back();
+        packPosition(aGame, aTimeline.itsKeyframes.back());
+    }
+}
+
+int getTimelineLength(const Timeline& aTimeline)
+{
+    return int(aTimeline.itsDeltas.size());
+}
+
+bool seekTimeline(const Timeline& aTimeline, Game& aGame, int aPly)
+{
+    if (aPly < 0 || aPly > getTimelineLength(aTimeline) || aTimeline.itsKeyframes.empty())
+        return false;
+    // image clé la plus proche, avant ou après le coup voulu
+    int key = (aPly + aTimeline.itsInterval / 2) / aTimeline.itsInterval;
+    if (key >= int(aTimeline.itsKeyframes.size()))
+        key = int(aTimeline.itsKeyframes.size()) - 1;
+    if (!unpackPosition(aTimeline.itsKeyframes[key], aGame))
+        return false;
+    for (int ply = key * aTimeline.itsInterval; ply < aPly; ++ply)
+        applyDelta(aGame, aTimeline.itsDeltas[ply]);
+    for (int ply = key * aTimeline.itsInterval; ply > aPly; --ply)
+        revertDelta(aGame, aTimeline.itsDeltas[ply - 1]);
+    return true;
+}
+
+bool stepTimelineForward(const Timeline& aTimeline, Game& aGame, int& aPly)
+{
+    if (aPly >= getTimelineLength(aTimeline))
+        return false;
+    applyDelta(aGame, aTimeline.itsDeltas[aPly++]);
+    return true;
+}
+
+bool stepTimelineBackward(const Timeline& aTimeline, Game& aGame, int& aPly)
+{
+    if (aPly <= 0)
+        return false;
+    revertDelta(aGame, aTimeline.itsDeltas[--aPly]);
+    return true;
+}
+
+bool loadRecordTimeline(const string& aPath, long aNumber, Timeline& aTimeline, Game& aGame)
+{
+    RecordReader reader;
+    if (!openRecordReader(reader, aPath))
+        return false;
+    bool found = true;
+    for (long skipped = 0; found && skipped < aNumber; ++skipped)
+        found = skipRecordHeader(reader) && skipRecord(reader);
+    found = found && readRecordHeader(reader, aGame);
+    if (found) {
+        startTimeline(aTimeline, aGame);
+        // le coup est retrouvé par son rang dans generateMoves, comme à l'écriture
+        int index;
+        Move moves[MAX_MOVES];
+        while (readRecordIndex(reader, index) == RECORD_MOVE) {
+            if (index >= generateMoves(aGame, moves))
+                break;
+            appendTimeline(aTimeline, aGame, moves[index]);
+        }
+    }
+    closeRecordReader(reader);
+    return found;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file timeline.h
+ *
+ * @brief Timeline of a game: any ply can be reached without replaying the game from its start.
+ *
+ * A timeline keeps a keyframe (the position as a `PackedBoard`) every `itsInterval` plies, and
+ * for every ply a reversible delta of 3 bytes:
+ * - the start cell and the end cell of the move (`row * 13 + column`, one byte each),
+ * - the captures: bit `d` is set if neighbour `d` of the end cell was captured (same order as
+ *   `MoveUndo`), and bit `4 + d` if that piece was the king.
+ *
+ * The type of a captured piece follows from the piece that moved (found on the end cell), so a
+ * delta can be played forward (`movePiece`, the captured cells emptied, `switchCurrentPlayer`) or
+ * backward (`unmakeMove`), each in constant time. Reaching a ply unpacks the nearest keyframe,
+ * before or after it, and plays at most `itsInterval / 2` deltas.
+ *
+ * A game of 200 plies takes about 1.3 KB with the default interval, so thousands of timelines
+ * can stay in memory.
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <cstdint>
+#include <vector>
+#include "typeDef.h"
+#include "movegen.h"
+#include "symmetry.h"
+
+/**
+ * @brief Default plies between two keyframes.
+ */
+const int TIMELINE_INTERVAL = 32;
+
+/**
+ * @struct TimelineDelta
+ * @brief A ply, stored so that it can be played both ways.
+ */
+struct TimelineDelta
+{
+    uint8_t itsFrom;      /**< Start cell (`row * 13 + column`). */
+    uint8_t itsTo;        /**< End cell. */
+    uint8_t itsCaptures;  /**< Captured neighbours (bits 0-3) and which of them was the king (bits 4-7). */
+};
+
+/**
+ * @struct Timeline
+ * @brief Keyframes and deltas of a game.
+ */
+struct Timeline
+{
+    int itsInterval = TIMELINE_INTERVAL;  /**< Plies between two keyframes. */
+    vector<PackedBoard> itsKeyframes;     /**< Keyframe `k` is the position after ply `k * itsInterval`. */
+    vector<TimelineDelta> itsDeltas;      /**< Delta `i` is ply `i + 1`. */
+};
+
+/**
+ * @brief Starts a timeline from a position (ply 0).
+ *
+ * @param aTimeline The timeline, emptied; `itsInterval` may be set beforehand.
+ * @param aGame The starting position.
+ */
+void startTimeline(Timeline& aTimeline, const Game& aGame);
+
+/**
+ * @brief Plays a move on a game and adds it to its timeline.
+ *
+ * @param aTimeline The timeline of the game.
+ * @param aGame The game, at the last ply of the timeline.
+ * @param aMove The move, assumed legal; it is played with `makeMove`.
+ */
+void appendTimeline(Timeline& aTimeline, Game& aGame, const Move& aMove);
+
+/**
+ * @brief Counts the plies of a timeline.
+ *
+ * @param aTimeline The timeline.
+ * @return The number of plies after the start.
+ */
+int getTimelineLength(const Timeline& aTimeline);
+
+/**
+ * @brief Sets a game on a ply of a timeline.
+ *
+ * @param aTimeline The timeline.
+ * @param aGame The game; its board is created if needed, or must have the size of the timeline.
+ * @param aPly The ply wanted (0 for the start).
+ * @return `false` if the ply is outside the timeline or the board has another size.
+ */
+bool seekTimeline(const Timeline& aTimeline, Game& aGame, int aPly);
+
+/**
+ * @brief Plays the next ply of a timeline.
+ *
+ * @param aTimeline The timeline.
+ * @param aGame The game, on ply `aPly`.
+ * @param aPly The ply of the game, increased.
+ * @return `false` at the end of the timeline.
+ */
+bool stepTimelineForward(const Timeline& aTimeline, Game& aGame, int& aPly);
+
+/**
+ * @brief Takes back the last ply played on a game following a timeline.
+ *
+ * @param aTimeline The timeline.
+ * @param aGame The game, on ply `aPly`.
+ * @param aPly The ply of the game, decreased.
+ * @return `false` at the start of the timeline.
+ */
+bool stepTimelineBackward(const Timeline& aTimeline, Game& aGame, int& aPly);
+
+/**
+ * @brief Builds the timeline of a game of a record file.
+ *
+ * @param aPath The record file.
+ * @param aNumber The number of the game in the file (0 for the first).
+ * @param aTimeline Receives the timeline.
+ * @param aGame Receives the names of the players and the final position.
+ * @return `false` if the file cannot be read or has fewer games.
+ */
+bool loadRecordTimeline(const string& aPath, long aNumber, Timeline& aTimeline, Game& aGame);
+
+#endif // TIMELINE_H
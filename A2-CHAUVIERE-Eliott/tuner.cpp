@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <thread>
+using namespace std;
+#include "tuner.h"
+#include "functions.h"
+#include "selfplay.h"
+
+static int getThreadCount(int aThreads)
+{
+    return (aThreads > 0) ? aThreads : int(max(1u, thread::hardware_concurrency()));
+}
+
+// calcule les caractéristiques d'une partie des échantillons d'un shard
+static void extractFeatures(const SampleShard& aShard, uint64_t aBegin, uint64_t aEnd, TunerData& aData)
+{
+    Game game;
+    int features[EVAL_FEATURE_COUNT];
+    aData.itsOffsets.push_back(0);
+    for (uint64_t i = aBegin; i < aEnd; ++i) {
+        const TrainingSample& sample = aShard.itsSamples[i];
+        if (!unpackPosition(sample.itsPosition, game)) {
+            deleteBoard(game.itsBoard); // autre taille de plateau
+            unpackPosition(sample.itsPosition, game);
+        }
+        Evaluator evaluator;
+        attachEvaluator(evaluator, game);
+        computeFeatures(evaluator, game, features);
+        detachEvaluator(evaluator, game);
+
+        for (int f = 0; f < EVAL_FEATURE_COUNT; ++f) {
+            if (features[f] != 0) {
+                aData.itsFeatures.push_back(uint8_t(f));
+                aData.itsValues.push_back(int16_t(features[f]));
+            }
+        }
+        aData.itsOffsets.push_back(aData.itsFeatures.size());
+        aData.itsTargets.push_back((sample.itsResult + 1) / 2.0f);
+    }
+    deleteBoard(game.itsBoard);
+}
+
+bool loadTunerData(const vector<string>& aPaths, TunerData& aData, int aThreads)
+{
+    int threads = getThreadCount(aThreads);
+    if (aData.itsOffsets.empty())
+        aData.itsOffsets.push_back(0);
+
+    for (const string& path : aPaths) {
+        SampleShard shard;
+        if (!openSampleShard(shard, path))
+            return false;
+        vector<TunerData> parts(threads);
+        vector<thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            uint64_t begin = shard.itsCount * t / threads;
+            uint64_t end = shard.itsCount * (t + 1) / threads;
+            workers.push_back(thread(extractFeatures, cref(shard), begin, end, ref(parts[t])));
+        }
+        for (thread& worker : workers)
+            worker.join();
+        closeSampleShard(shard);
+
+        // concaténation dans l'ordre du shard
+        for (const TunerData& part : parts) {
+            uint64_t base = aData.itsFeatures.size();
+            for (size_t i = 1; i < part.itsOffsets.size(); ++i)
+                aData.itsOffsets.push_back(base + part.itsOffsets[i]);
+            aData.itsFeatures.insert(aData.itsFeatures.end(), part.itsFeatures.begin(), part.itsFeatures.end());
+            aData.itsValues.insert(aData.itsValues.end(), part.itsValues.begin(), part.itsValues.end());
+            aData.itsTargets.insert(aData.itsTargets.end(), part.itsTargets.begin(), part.itsTargets.end());
+        }
+    }
+    return true;
+}
+
+// perte logistique d'une tranche de positions ; ajoute son gradient à aGradient s'il est fourni
+static double accumulateRange(const TunerData& aData, const double* aWeights, double aScale,
+                              uint64_t aBegin, uint64_t aEnd, double* aGradient)
+{
+    double loss = 0;
+    for (uint64_t i = aBegin; i < aEnd; ++i) {
+        double score = 0;
+        for (uint64_t k = aData.itsOffsets[i]; k < aData.itsOffsets[i + 1]; ++k)
+            score += aWeights[aData.itsFeatures[k]] * aData.itsValues[k];
+        double prediction = 1 / (1 + exp(-score / aScale));
+        prediction = min(1 - 1e-9, max(1e-9, prediction));
+        double target = aData.itsTargets[i];
+        loss -= target * log(prediction) + (1 - target) * log(1 - prediction);
+        if (aGradient != nullptr) {
+            double slope = (prediction - target) / aScale;
+            for (uint64_t k = aData.itsOffsets[i]; k < aData.itsOffsets[i + 1]; ++k)
+                aGradient[aData.itsFeatures[k]] += slope * aData.itsValues[k];
+        }
+    }
+    return loss;
+}
+
+// somme des pertes (et des gradients) d'une tranche, partagée entre les threads
+static double accumulate(const TunerData& aData, const double* aWeights, double aScale, int aThreads,
+                         uint64_t aBegin, uint64_t aEnd, double* aGradient)
+{
+    vector<double> losses(aThreads, 0);
+    vector<vector<double>> gradients(aThreads, vector<double>(EVAL_FEATURE_COUNT, 0));
+    vector<thread> workers;
+    for (int t = 0; t < aThreads; ++t) {
+        uint64_t begin = aBegin + (aEnd - aBegin) * t / aThreads;
+        uint64_t end = aBegin + (aEnd - aBegin) * (t + 1) / aThreads;
+        double* gradient = (aGradient != nullptr) ? gradients[t].data() : nullptr;
+        workers.push_back(thread([&aData, aWeights, aScale, begin, end, gradient, &losses, t]() {
+            losses[t] = accumulateRange(aData, aWeights, aScale, begin, end, gradient);
+        }));
+    }
+    double loss = 0;
+    for (int t = 0; t < aThreads; ++t) {
+        workers[t].join();
+        loss += losses[t];
+        if (aGradient != nullptr)
+            for (int f = 0; f < EVAL_FEATURE_COUNT; ++f)
+                aGradient[f] += gradients[t][f];
+    }
+    return loss;
+}
+
+double getTunerLoss(const TunerData& aData, const EvalWeights& aWeights, const TunerConfig& aConfig)
+{
+    uint64_t count = aData.itsTargets.size();
+    if (count == 0)
+        return 0;
+    double weights[EVAL_FEATURE_COUNT];
+    copy(aWeights.itsValues, aWeights.itsValues + EVAL_FEATURE_COUNT, weights);
+    return accumulate(aData, weights, aConfig.itsScale, getThreadCount(aConfig.itsThreads), 0, count, nullptr) / count;
+}
+
+double tuneEvalWeights(const TunerData& aData, const TunerConfig& aConfig, EvalWeights& aWeights)
+{
+    const double BETA1 = 0.9;
+    const double BETA2 = 0.999;
+    const double EPSILON = 1e-8;
+    int threads = getThreadCount(aConfig.itsThreads);
+    uint64_t count = aData.itsTargets.size();
+    if (count == 0)
+        return 0;
+
+    double weights[EVAL_FEATURE_COUNT];
+    double moment1[EVAL_FEATURE_COUNT] = {};
+    double moment2[EVAL_FEATURE_COUNT] = {};
+    copy(aWeights.itsValues, aWeights.itsValues + EVAL_FEATURE_COUNT, weights);
+
+    uint64_t batch = uint64_t(max(1, aConfig.itsBatch));
+    vector<uint64_t> batches((count + batch - 1) / batch);
+    iota(batches.begin(), batches.end(), 0);
+    mt19937_64 randomEngine(36);
+    long step = 0;
+
+    for (int epoch = 0; epoch < aConfig.itsEpochs; ++epoch) {
+        shuffle(batches.begin(), batches.end(), randomEngine); // les positions d'une même partie se suivent
+        double loss = 0;
+        for (uint64_t b : batches) {
+            uint64_t begin = b * batch;
+            uint64_t end = min(count, begin + batch);
+            double gradient[EVAL_FEATURE_COUNT] = {};
+            loss += accumulate(aData, weights, aConfig.itsScale, threads, begin, end, gradient);
+
+            step++;
+            double correction1 = 1 - pow(BETA1, double(step));
+            double correction2 = 1 - pow(BETA2, double(step));
+            for (int f = 0; f < EVAL_FEATURE_COUNT; ++f) {
+                double g = gradient[f] / double(end - begin);
+                moment1[f] = BETA1 * moment1[f] + (1 - BETA1) * g;
+                moment2[f] = BETA2 * moment2[f] + (1 - BETA2) * g * g;
+                weights[f] -= aConfig.itsLearningRate * (moment1[f] / correction1) / (sqrt(moment2[f] / correction2) + EPSILON);
+            }
+        }
+        if (aConfig.itsVerbose)
+            cout<<"Epoque "<<epoch + 1<<" : perte "<<loss / count<<endl;
+    }
+
+    for (int f = 0; f < EVAL_FEATURE_COUNT; ++f)
+        aWeights.itsValues[f] = int(lround(weights[f]));
+    return getTunerLoss(aData, aWeights, aConfig);
+}
@@ -0,0 +1,80 @@
+/**
+ * @file tuner.h
+ *
+ * @brief Tuning of the evaluation weights on labeled positions (Texel's method).
+ *
+ * The evaluation is linear in its weights, so the features of every position are computed once
+ * when the positions are loaded and kept as sparse (feature, value) pairs in flat arrays. The
+ * predicted result of a position is `sigmoid(score / scale)` with the score seen by the attack;
+ * the tuner minimises the logistic loss against the game results with Adam, the gradient of each
+ * mini-batch being summed over all cores.
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef TUNER_H
+#define TUNER_H
+
+#include <cstdint>
+#include <vector>
+#include "typeDef.h"
+#include "evaluation.h"
+
+/**
+ * @struct TunerData
+ * @brief Labeled positions reduced to their features.
+ */
+struct TunerData
+{
+    vector<uint64_t> itsOffsets;  /**< First feature of each position (one more for the end). */
+    vector<uint8_t> itsFeatures;  /**< Feature index (`EvalFeature`) of each non-zero feature. */
+    vector<int16_t> itsValues;    /**< Value of each non-zero feature. */
+    vector<float> itsTargets;     /**< Result of each position for the attack: 1 won, 0 lost, 0.5 stopped. */
+};
+
+/**
+ * @struct TunerConfig
+ * @brief Settings of the tuning.
+ */
+struct TunerConfig
+{
+    int itsEpochs = 50;             /**< Passes over the positions. */
+    int itsBatch = 1 << 16;         /**< Positions per gradient step. */
+    int itsThreads = 0;             /**< Number of threads (0 to use one per core). */
+    double itsLearningRate = 1.0;   /**< Step size of Adam, in weight units. */
+    double itsScale = 200;          /**< Score giving a predicted result of 73 %. */
+    bool itsVerbose = false;        /**< Display the loss after each epoch. */
+};
+
+/**
+ * @brief Loads sample shards (see selfplay.h) and computes the features of their positions in parallel.
+ *
+ * @param aPaths The shard files.
+ * @param aData Receives the positions (appended).
+ * @param aThreads Number of threads (0 to use one per core).
+ * @return `false` if a shard cannot be opened.
+ */
+bool loadTunerData(const vector<string>& aPaths, TunerData& aData, int aThreads = 0);
+
+/**
+ * @brief Computes the mean logistic loss of weights over all positions.
+ *
+ * @param aData The positions.
+ * @param aWeights The weights.
+ * @param aConfig The settings (scale and threads).
+ * @return The loss.
+ */
+double getTunerLoss(const TunerData& aData, const EvalWeights& aWeights, const TunerConfig& aConfig);
+
+/**
+ * @brief Tunes weights with Adam.
+ *
+ * @param aData The positions.
+ * @param aConfig The settings.
+ * @param aWeights The starting weights, replaced by the tuned ones (rounded).
+ * @return The loss of the tuned weights.
+ */
+double tuneEvalWeights(const TunerData& aData, const TunerConfig& aConfig, EvalWeights& aWeights);
+
+#endif // TUNER_H
@@ -126,11 +126,28 @@ struct Move
  * @brief Structure representing a player in the game.
  *
  * Each player has a name (`itsName`) and a role (`itsRole`), which can either be ATTACK or DEFENSE.
+ * A bot player (`itsIsBot`) plays the moves found by the search instead of reading them.
  */
 struct Player
 {
     string itsName;         /**< The name of the player. */
     PlayerRole itsRole;     /**< The role of the player (ATTACK or DEFENSE). */
+    bool itsIsBot = false;  /**< The moves of the player are chosen by the search. */
+};
+
+/**
+ * @struct GameHooks
+ * @brief Callbacks notified of every change of the pieces of a board.
+ *
+ * They let an evaluator keep its terms up to date from the moved and captured cells only,
+ * instead of scanning the whole board. When `itsHooks` of a game is set, all three callbacks must be set.
+ */
+struct GameHooks
+{
+    void (*itsOnMove)(void* aContext, PieceType aPiece, const Position& aFrom, const Position& aTo) = nullptr; /**< A piece moved (`movePiece`). */
+    void (*itsOnRemove)(void* aContext, PieceType aPiece, const Position& aPos) = nullptr; /**< A piece was captured (`capturePieces`). */
+    void (*itsOnPlace)(void* aContext, PieceType aPiece, const Position& aPos) = nullptr;  /**< A captured piece was put back (`unmakeMove`). */
+    void* itsContext = nullptr; /**< First argument of the callbacks. */
 };
 
 /**
@@ -145,6 +162,7 @@ struct Game
     Player itsPlayer1 = {"Player 1", ATTACK}; /**< The first player (attacker). */
     Player itsPlayer2 = {"Player 2", DEFENSE}; /**< The second player (defender). */
     Player* itsCurrentPlayer = &itsPlayer1; /**< A pointer to the current player. */
+    GameHooks* itsHooks = nullptr; /**< Observers of the board changes, if any. */
 };
 
 #endif // TYPEDEF_H
@@ -0,0 +1,192 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+using namespace std;
+#include "validator.h"
+#include "functions.h"
+#include "movegen.h"
+#include "record.h"
+
+/**
+ * File des lots de parties à valider, remplie par le thread principal.
+ */
+struct BatchQueue
+{
+    mutex itsMutex;
+    condition_variable itsReady;
+    deque<vector<pair<streamoff, long>>> itsBatches; // (début de la partie, numéro)
+    bool itsDone = false;
+};
+
+// rejoue une partie placée en début de lecture ; renvoie false et remplit aFailure si elle est invalide
+static bool validateGame(RecordReader& aReader, Game& aGame, long aNumber, long& aPlies, GameFailure& aFailure)
+{
+    aFailure = {aNumber, 0, ""};
+    if (!readRecordHeader(aReader, aGame))
+    {
+        aFailure.itsReason = "en-tete corrompu";
+        return false;
+    }
+
+    int ply = 0;
+    Move moves[MAX_MOVES];
+    while (true)
+    {
+        int index;
+        RecordStatus status = readRecordIndex(aReader, index);
+        if (status == RECORD_ERROR)
+        {
+            aFailure = {aNumber, ply + 1, "coup illisible ou partie tronquee"};
+            return false;
+        }
+        if (status == RECORD_END)
+        {
+            if (aReader.itsResult != getRecordResult(aGame))
+            {
+                aFailure = {aNumber, ply, "resultat enregistre different de whoWon"};
+                return false;
+            }
+            return true;
+        }
+
+        ply++;
+        aPlies++;
+        if (isGameFinished(aGame))
+        {
+            aFailure = {aNumber, ply, "coup joue apres la fin de la partie"};
+            return false;
+        }
+        if (index >= generateMoves(aGame, moves))
+        {
+            aFailure = {aNumber, ply, "indice de coup hors de la liste des coups legaux"};
+            return false;
+        }
+        if (!isValidMovement(aGame, moves[index]))
+        {
+            aFailure = {aNumber, ply, "coup refuse par isValidMovement"};
+            return false;
+        }
+        movePiece(aGame, moves[index]);
+        capturePieces(aGame, moves[index]);
+        switchCurrentPlayer(aGame);
+    }
+}
+
+// thread de validation : prend des lots jusqu'à ce que la file soit vide et fermée
+static void validationWorker(const string& aPath, BatchQueue& aQueue, long& aPlies, vector<GameFailure>& aFailures)
+{
+    // archive impossible à rouvrir : le thread prend quand même ses lots, et chaque partie est
+    // comptée en échec plutôt que laissée sans validation
+    RecordReader reader;
+    bool opened = openRecordReader(reader, aPath);
+    Game game;
+    long plies = 0; // compteur local, recopié à la fin pour ne pas partager de ligne de cache
+    while (true)
+    {
+        vector<pair<streamoff, long>> batch;
+        {
+            unique_lock<mutex> lock(aQueue.itsMutex);
+            aQueue.itsReady.wait(lock, [&aQueue] { return !aQueue.itsBatches.empty() || aQueue.itsDone; });
+            if (aQueue.itsBatches.empty())
+                break;
+            batch = move(aQueue.itsBatches.front());
+            aQueue.itsBatches.pop_front();
+        }
+        for (const pair<streamoff, long>& entry : batch)
+        {
+            if (!opened)
+            {
+                aFailures.push_back({entry.second, 0, "archive impossible a rouvrir"});
+                continue;
+            }
+            reader.itsStream.clear();
+            reader.itsStream.seekg(entry.first);
+            GameFailure failure;
+            if (!validateGame(reader, game, entry.second, plies, failure))
+                aFailures.push_back(failure);
+        }
+    }
+    aPlies = plies;
+    closeRecordReader(reader);
+    deleteBoard(game.itsBoard);
+}
+
+bool validateArchive(const string& aPath, int aThreads, ValidationReport& aReport)
+{
+    RecordReader scanner;
+    if (!openRecordReader(scanner, aPath))
+        return false;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    if (aThreads <= 0)
+        aThreads = max(1u, thread::hardware_concurrency());
+    aReport = ValidationReport();
+    aReport.itsThreads = aThreads;
+
+    BatchQueue queue;
+    vector<long> plies(aThreads, 0);
+    vector<vector<GameFailure>> failures(aThreads);
+    vector<thread> workers;
+    for (int i = 0; i < aThreads; ++i)
+        workers.push_back(thread(validationWorker, cref(aPath), ref(queue), ref(plies[i]), ref(failures[i])));
+
+    // repérage des débuts de parties, sans rejouer les coups
+    vector<pair<streamoff, long>> batch;
+    while (true)
+    {
+        streamoff offset = scanner.itsStream.tellg();
+        if (scanner.itsStream.peek() == EOF)
+            break;
+        aReport.itsGames++;
+        batch.push_back({offset, aReport.itsGames});
+        if (!skipRecordHeader(scanner) || !skipRecord(scanner))
+        {
+            // la fin de cette partie est introuvable : les suivantes ne peuvent pas être localisées
+            aReport.itsTruncated = true;
+            break;
+        }
+        if (batch.size() == VALIDATION_BATCH)
+        {
+            lock_guard<mutex> lock(queue.itsMutex);
+            queue.itsBatches.push_back(move(batch));
+            batch.clear();
+            queue.itsReady.notify_one();
+        }
+    }
+    {
+        lock_guard<mutex> lock(queue.itsMutex);
+        if (!batch.empty())
+            queue.itsBatches.push_back(move(batch));
+        queue.itsDone = true;
+    }
+    queue.itsReady.notify_all();
+    closeRecordReader(scanner);
+
+    for (int i = 0; i < aThreads; ++i)
+    {
+        workers[i].join();
+        aReport.itsPlies += plies[i];
+        aReport.itsFailures.insert(aReport.itsFailures.end(), failures[i].begin(), failures[i].end());
+    }
+    sort(aReport.itsFailures.begin(), aReport.itsFailures.end(),
+         [](const GameFailure& a, const GameFailure& b) { return a.itsGameNumber < b.itsGameNumber; });
+    aReport.itsSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+void displayValidationReport(const ValidationReport& aReport)
+{
+    for (const GameFailure& failure : aReport.itsFailures)
+        cout<<"Partie "<<failure.itsGameNumber<<" : coup "<<failure.itsPly<<" : "<<failure.itsReason<<endl;
+    if (aReport.itsTruncated)
+        cout<<"Archive tronquee : fin de la partie "<<aReport.itsGames<<" introuvable"<<endl;
+
+    double speed = (aReport.itsSeconds > 0) ? aReport.itsGames / aReport.itsSeconds : 0;
+    cout<<aReport.itsGames<<" parties ("<<aReport.itsPlies<<" coups) validees en "<<aReport.itsSeconds<<" s sur "
+        <<aReport.itsThreads<<" threads : "<<long(speed)<<" parties/s, "
+        <<aReport.itsFailures.size()<<" partie(s) invalide(s)"<<endl;
+}
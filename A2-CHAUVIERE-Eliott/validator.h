@@ -0,0 +1,68 @@
+/**
+ * @file validator.h
+ *
+ * @brief Parallel validation of a game record archive.
+ *
+ * Every game of the archive is replayed with the rules of the game (`isValidMovement`,
+ * `movePiece`, `capturePieces`) and its stored result is compared with `whoWon`.
+ * The main thread finds the game boundaries and hands batches of games to one worker
+ * thread per core, so a corrupted game never stops the validation of the others.
+ *
+ * @author E. CHAUVIERE - IUT Informatique La Rochelle
+ * @date 19/10/2026
+ */
+
+#ifndef VALIDATOR_H
+#define VALIDATOR_H
+
+#include <vector>
+#include "typeDef.h"
+
+/**
+ * @brief Number of games handed to a worker thread at once.
+ */
+const int VALIDATION_BATCH = 256;
+
+/**
+ * @struct GameFailure
+ * @brief Describes the first problem found in a game of the archive.
+ */
+struct GameFailure
+{
+    long itsGameNumber;  /**< Number of the game in the archive (from 1). */
+    int itsPly;          /**< First failing ply (from 1), or 0 for a corrupted header or an unreadable archive. */
+    string itsReason;    /**< Short description of the problem. */
+};
+
+/**
+ * @struct ValidationReport
+ * @brief Result of the validation of an archive.
+ */
+struct ValidationReport
+{
+    long itsGames = 0;               /**< Number of games found in the archive. */
+    long itsPlies = 0;               /**< Number of plies replayed. */
+    double itsSeconds = 0;           /**< Wall time of the validation. */
+    int itsThreads = 0;              /**< Number of worker threads used. */
+    bool itsTruncated = false;       /**< `true` if the archive could not be scanned to its end. */
+    vector<GameFailure> itsFailures; /**< The bad games, sorted by game number. */
+};
+
+/**
+ * @brief Replays and checks every game of a record archive.
+ *
+ * @param aPath The path of the record file.
+ * @param aThreads The number of worker threads (0 to use one per core).
+ * @param aReport Receives the statistics and the bad games.
+ * @return `false` if the file cannot be opened, `true` otherwise (even if bad games were found).
+ */
+bool validateArchive(const string& aPath, int aThreads, ValidationReport& aReport);
+
+/**
+ * @brief Displays a validation report: games per second and the first failing ply of each bad game.
+ *
+ * @param aReport The report to display.
+ */
+void displayValidationReport(const ValidationReport& aReport);
+
+#endif // VALIDATOR_H